@@ -0,0 +1,75 @@
+import os
+import re
+import sys
+import tempfile
+
+import benchutil
+from benchutil import test_path
+
+# USAGE
+#   python benchmark.py EXE [ENGINE ...]
+# Runs every PASS_* script and a few scaled-up workloads on each engine
+# and reports the best execution time (as printed by --time) in ms.
+
+# NUMBER OF RUNS PER (SCRIPT, ENGINE), THE BEST ONE IS KEPT
+repeat = 5
+
+# SCALED-UP WORKLOADS: (name, base script, value for the first (SET n ...)),
+# a base script of None stands for loop_program
+scaled = [
+    ('ManyPrimes_n4000', 'PASS_ManyPrimes.txt', 4000),
+    ('Loop_3M', None, None),
+]
+
+loop_program = '''(BLOCK
+  (SET i 0)
+  (SET s 0)
+  (WHILE (LT i 3000000)
+    (BLOCK
+      (SET s (ADD (DIV s 2) i))
+      (SET i (ADD i 1))))
+  (PRINT s))
+'''
+
+
+def run(exe, engine, path, phase='execution'):
+    def once():
+        stderr, _, _ = benchutil.run(exe, ['--engine', engine, '--time'], path)
+        return benchutil.phase_time(stderr, phase)
+    return min(benchutil.repeat(repeat, once), default=None)
+
+
+def workloads(tmp):
+    # THE ORIGINAL PASS_* SCRIPTS
+    for filename in sorted(os.listdir(test_path)):
+        if filename.startswith('PASS_'):
+            yield filename[:-4], os.path.join(test_path, filename)
+    # THE SCALED-UP ONES
+    for name, base, n in scaled:
+        if base is None:
+            text = loop_program
+        else:
+            with open(os.path.join(test_path, base)) as f:
+                text = re.sub(r'\(SET n [0-9]+\)', '(SET n %d)' % n, f.read(), count=1)
+        yield name, benchutil.write_program(tmp, name + '.txt', text)
+
+
+def benchmark():
+    if len(sys.argv) < 2:
+        exit('Usage: python benchmark.py EXE [ENGINE ...]')
+    exe = sys.argv[1]
+    engines = sys.argv[2:] if len(sys.argv) > 2 else ['visitor', 'stack', 'register', 'closure', 'jit', 'stencil']
+
+    with tempfile.TemporaryDirectory() as tmp:
+        print('%-22s' % 'script' + ''.join('%14s' % e for e in engines) + '   speedup')
+        for name, path in workloads(tmp):
+            times = [run(exe, engine, path) for engine in engines]
+            row = '%-22s' % name
+            for t in times:
+                row += '%14s' % ('-' if t is None else '%.3f' % t)
+            if times[0] and all(times):
+                row += '   ' + ' '.join('%.2fx' % (times[0] / t) for t in times[1:])
+            print(row)
+
+
+benchmark()
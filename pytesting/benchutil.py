@@ -0,0 +1,83 @@
+import os
+import re
+import subprocess
+
+# Helpers shared by the *bench.py scripts: running the executable,
+# reading the phase times it prints with --time, keeping the best of
+# several runs and printing the result tables.
+
+# FILE PATHS
+script_dir = os.path.dirname(os.path.abspath(__file__))
+test_path = os.path.join(script_dir, 'scripts')
+
+
+def run(exe, arguments, path, resource_usage=False):
+    # Runs EXE ARGUMENTS PATH with no input and stdout discarded.
+    # Returns stderr, the exit code and, with resource_usage, the
+    # resource usage of that child only (os.wait4, not on Windows).
+    command = [exe] + arguments + [path]
+    if not resource_usage:
+        result = subprocess.run(command, stdin=subprocess.DEVNULL, stdout=subprocess.DEVNULL,
+                                stderr=subprocess.PIPE, text=True)
+        return result.stderr, result.returncode, None
+    process = subprocess.Popen(command, stdin=subprocess.DEVNULL, stdout=subprocess.DEVNULL,
+                               stderr=subprocess.PIPE, text=True)
+    stderr = process.stderr.read()
+    _, status, usage = os.wait4(process.pid, 0)
+    return stderr, os.waitstatus_to_exitcode(status), usage
+
+
+def phase_times(stderr):
+    # {phase: ms} from the "(TIME phase: N ms )" lines of --time
+    return dict((phase, float(t)) for phase, t in
+                re.findall(r'\(TIME ([a-z ]+): ([0-9.e+-]+) ms \)', stderr))
+
+
+def phase_time(stderr, phase):
+    return phase_times(stderr).get(phase)
+
+
+def repeat(count, function, *arguments):
+    # Results of count calls, without the failed ones (None)
+    return [r for r in (function(*arguments) for _ in range(count)) if r is not None]
+
+
+def split_arguments(arguments, valued=('--engine', '--ast', '--scanner')):
+    # Options starting with -- (with a value for the ones in valued)
+    # and executables, in the order they were given
+    options = []
+    executables = []
+    arguments = iter(arguments)
+    for argument in arguments:
+        if argument in valued:
+            options += [argument, next(arguments, '')]
+        elif argument.startswith('--'):
+            options.append(argument)
+        else:
+            executables.append(argument)
+    return options, executables
+
+
+def write_program(directory, name, text):
+    path = os.path.join(directory, name)
+    with open(path, 'w') as f:
+        f.write(text)
+    return path
+
+
+def size_mb(path):
+    return os.path.getsize(path) / (1024 * 1024)
+
+
+def speedup_rows(labels, measure):
+    # (label, best time, speedup over the first label that has a
+    # time) for each label; best time None if measure gave none
+    baseline = None
+    for label in labels:
+        best = measure(label)
+        if best is None:
+            yield label, None, None
+            continue
+        if baseline is None:
+            baseline = best
+        yield label, best, baseline / best
@@ -0,0 +1,51 @@
+import os
+import sys
+import tempfile
+
+import benchutil
+import parsebench
+
+# USAGE
+#   python cachebench.py EXE [SIZE_MB]
+# Generates a program of SIZE_MB megabytes (by default 50) with the
+# generator of parsebench.py and runs the executable with --cache: the
+# first run tokenizes, parses and writes the cache file, the following
+# ones load the program from it. Reports the best time of the front end
+# (tokenizer + parser, or loading the cache), the cache write time and
+# the minor page faults of the whole run.
+
+# NUMBER OF RUNS PER CONFIGURATION, THE BEST ONE IS KEPT
+repeat = 5
+
+
+def run(exe, path, clear):
+    if clear and os.path.exists(path + '.cache'):
+        os.remove(path + '.cache')
+    stderr, _, usage = benchutil.run(exe, ['--time', '--cache'], path, resource_usage=True)
+    times = benchutil.phase_times(stderr)
+    front = sum(times.get(phase, 0) for phase in ('cache miss', 'tokenizer', 'parser', 'cache'))
+    return front, times.get('cache write'), usage.ru_minflt
+
+
+def cachebench():
+    if len(sys.argv) < 2:
+        exit('Usage: python cachebench.py EXE [SIZE_MB]')
+    exe = sys.argv[1]
+    size = int(sys.argv[2]) if len(sys.argv) > 2 else 50
+    parsebench.target_size = size * 1024 * 1024
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'Generated_%dMB.txt' % size)
+        parsebench.generate(path)
+        misses = [run(exe, path, True) for _ in range(repeat)]
+        hits = [run(exe, path, False) for _ in range(repeat)]
+        print('Program size: %.1f MB, cache file: %.1f MB'
+              % (benchutil.size_mb(path), benchutil.size_mb(path + '.cache')))
+        print('%-26s %12.1f ms %10d page faults' % ('tokenizer + parser', min(m[0] for m in misses),
+                                                    min(m[2] for m in misses)))
+        print('%-26s %12.1f ms' % ('cache write', min(m[1] for m in misses)))
+        print('%-26s %12.1f ms %10d page faults' % ('cache load', min(h[0] for h in hits),
+                                                    min(h[2] for h in hits)))
+
+
+if __name__ == '__main__':
+    cachebench()
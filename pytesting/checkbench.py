@@ -0,0 +1,69 @@
+import os
+import sys
+import tempfile
+import time
+
+import benchutil
+from parsebench import generate
+
+# USAGE
+#   python checkbench.py EXE [EXE ...]
+# Runs --check on the ~10 MB program generated by parsebench.py and on
+# three invalid copies of it: a syntax error at the end (the last right
+# parenthesis is missing), a syntax error at the start and a lexical
+# error at the end. Reports, for each executable and front end, the best
+# wall-clock time of the whole run in MB/s of program text, and the exit
+# status. Passing the executables built before and after a change
+# compares them side by side.
+
+# NUMBER OF RUNS PER INPUT, THE BEST ONE IS KEPT
+repeat = 5
+
+front_ends = [('split', []), ('fused', ['--fused'])]
+
+
+def make_inputs(tmp):
+    valid = os.path.join(tmp, 'Generated_10MB.txt')
+    generate(valid)
+    with open(valid) as f:
+        text = f.read()
+    end = text.rstrip().rstrip(')')
+    inputs = [('valid', valid),
+              ('syntax error at end', end + '\n'),
+              ('syntax error at start', text.replace('(SET', '(SET SET', 1)),
+              ('lexical error at end', end + ' @)\n')]
+    paths = []
+    for i, (name, content) in enumerate(inputs):
+        if i == 0:
+            paths.append((name, content))
+            continue
+        path = os.path.join(tmp, 'Invalid_%d.txt' % i)
+        with open(path, 'w') as f:
+            f.write(content)
+        paths.append((name, path))
+    return paths
+
+
+def run(exe, options, path):
+    start = time.perf_counter()
+    _, returncode, _ = benchutil.run(exe, ['--check'] + options, path)
+    return time.perf_counter() - start, returncode
+
+
+def checkbench():
+    if len(sys.argv) < 2:
+        exit('Usage: python checkbench.py EXE [EXE ...]')
+    with tempfile.TemporaryDirectory() as tmp:
+        inputs = make_inputs(tmp)
+        print('%-30s %-6s %-22s %10s %6s' % ('executable', 'front', 'input', 'MB/s', 'exit'))
+        for exe in sys.argv[1:]:
+            for front, options in front_ends:
+                for name, path in inputs:
+                    results = [run(exe, options, path) for _ in range(repeat)]
+                    best = min(r[0] for r in results)
+                    size = benchutil.size_mb(path)
+                    print('%-30s %-6s %-22s %10.1f %6d' % (exe, front, name, size / best, results[0][1]))
+
+
+if __name__ == '__main__':
+    checkbench()
@@ -0,0 +1,62 @@
+import os
+import sys
+import tempfile
+
+import benchutil
+
+# USAGE
+#   python deepbench.py EXE [EXE ...] [-- DEPTH ...]
+# Generates programs made of a single PRINT of an ADD expression
+# nested DEPTH levels deep (by default 1000, 10000, 100000 and 1000000)
+# and reports the parser time of each executable. A missing time means
+# the process died before the parser finished (e.g. stack overflow);
+# the exit status is printed next to the time.
+# Only the parser is measured: the later phases may still be recursive.
+
+# NUMBER OF RUNS PER DEPTH, THE BEST ONE IS KEPT
+repeat = 3
+
+default_depths = ['1000', '10000', '100000', '1000000']
+
+
+def generate(path, depth):
+    with open(path, 'w') as f:
+        f.write('(BLOCK (PRINT ')
+        f.write('(ADD 1 ' * depth)
+        f.write('1')
+        f.write(')' * depth)
+        f.write('))\n')
+
+
+def run(exe, path):
+    stderr, returncode, _ = benchutil.run(exe, ['--time'], path)
+    return benchutil.phase_time(stderr, 'parser'), returncode
+
+
+def deepbench():
+    arguments = sys.argv[1:]
+    if '--' in arguments:
+        split = arguments.index('--')
+        executables, depths = arguments[:split], arguments[split + 1:]
+    else:
+        executables, depths = arguments, []
+    if not executables:
+        exit('Usage: python deepbench.py EXE [EXE ...] [-- DEPTH ...]')
+    depths = depths or default_depths
+    print('%-10s %-30s %12s %8s' % ('depth', 'executable', 'parser (ms)', 'status'))
+    with tempfile.TemporaryDirectory() as tmp:
+        for depth in depths:
+            path = os.path.join(tmp, 'Deep_%s.txt' % depth)
+            generate(path, int(depth))
+            for exe in executables:
+                results = [run(exe, path) for _ in range(repeat)]
+                times = [t for t, _ in results if t is not None]
+                status = results[-1][1]
+                if times:
+                    print('%-10s %-30s %12.1f %8d' % (depth, exe, min(times), status))
+                else:
+                    print('%-10s %-30s %12s %8d' % (depth, exe, '-', status))
+
+
+if __name__ == '__main__':
+    deepbench()
@@ -0,0 +1,42 @@
+import os
+import subprocess
+import sys
+
+from benchutil import test_path
+
+# USAGE
+#   python difftest.py EXE [ENGINE ...]
+# Runs every script in scripts/ with the reference engine (ExecutionVisitor)
+# and with each other engine, and checks that stdout, stderr and the exit
+# code are identical.
+
+reference = 'visitor'
+
+
+def run(exe, engine, path):
+    result = subprocess.run([exe, '--engine', engine, path],
+                            stdin=subprocess.DEVNULL, capture_output=True, text=True)
+    return result.stdout, result.stderr, result.returncode
+
+
+def difftest():
+    if len(sys.argv) < 2:
+        exit('Usage: python difftest.py EXE [ENGINE ...]')
+    exe = sys.argv[1]
+    engines = sys.argv[2:] if len(sys.argv) > 2 else ['stack', 'register', 'closure', 'jit', 'stencil']
+
+    failures = 0
+    test_files = sorted(os.listdir(test_path))
+    for filename in test_files:
+        path = os.path.join(test_path, filename)
+        expected = run(exe, reference, path)
+        for engine in engines:
+            if run(exe, engine, path) != expected:
+                print('MISMATCH', filename, 'on engine', engine)
+                failures += 1
+
+    print('Ran', len(test_files), 'scripts on', len(engines), 'engine(s),', failures, 'mismatch(es)')
+    exit(1 if failures else 0)
+
+
+difftest()
@@ -0,0 +1,52 @@
+import os
+import sys
+import tempfile
+
+import benchutil
+from parsebench import generate
+
+# USAGE
+#   python frontbench.py EXE [EXE ...]
+# Parses the ~10 MB program generated by parsebench.py with each front
+# end of the executables: the Tokenizer followed by the Parser (split),
+# --stream and --fused. Reports the best tokenizer + parser time, which
+# is the end-to-end parse latency (with --stream and --fused there is no
+# separate tokenizer phase), and the speedup over the split front end.
+
+# NUMBER OF RUNS PER FRONT END, THE BEST ONE IS KEPT
+repeat = 5
+
+front_ends = [('split', []), ('stream', ['--stream']), ('fused', ['--fused'])]
+
+
+def run(exe, options, path):
+    stderr, _, _ = benchutil.run(exe, ['--time'] + options, path)
+    times = benchutil.phase_times(stderr)
+    if 'parser' not in times:
+        return None
+    return times['parser'] + times.get('tokenizer', 0)
+
+
+def best(exe, options, path):
+    return min(benchutil.repeat(repeat, run, exe, options, path), default=None)
+
+
+def frontbench():
+    if len(sys.argv) < 2:
+        exit('Usage: python frontbench.py EXE [EXE ...]')
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'Generated_10MB.txt')
+        generate(path)
+        print('Program size: %.1f MB' % benchutil.size_mb(path))
+        print('%-30s %-8s %16s %10s' % ('executable', 'front', 'tok+parse (ms)', 'speedup'))
+        for exe in sys.argv[1:]:
+            options = dict(front_ends)
+            for name, time, speedup in benchutil.speedup_rows(options, lambda n: best(exe, options[n], path)):
+                if time is None:
+                    print('%-30s %-8s %16s' % (exe, name, '-'))
+                else:
+                    print('%-30s %-8s %16.1f %9.2fx' % (exe, name, time, speedup))
+
+
+if __name__ == '__main__':
+    frontbench()
@@ -0,0 +1,62 @@
+import os
+import re
+import sys
+import tempfile
+
+import benchutil
+import parsebench
+
+# USAGE
+#   python incbench.py EXE [EDITS]
+# Generates a ~1 MB program with the generator of parsebench.py and runs
+# the executable with --edits EDITS (by default 1000): after the full
+# parse, one digit at a time is changed and the program is parsed again
+# incrementally. Reports the tokenizer + parser time of a normal run
+# (without --edits), the average time of an incremental reparse and the
+# bytes it parsed again.
+
+# SIZE OF THE GENERATED PROGRAM IN BYTES
+target_size = 1024 * 1024
+
+# NUMBER OF RUNS, THE BEST ONE IS KEPT
+repeat = 5
+
+
+def run_full(exe, path):
+    stderr, _, _ = benchutil.run(exe, ['--time'], path)
+    times = benchutil.phase_times(stderr)
+    if 'parser' not in times:
+        return None
+    return times['parser'] + times.get('tokenizer', 0)
+
+
+def run_edits(exe, edits, path):
+    stderr, _, _ = benchutil.run(exe, ['--edits', edits], path)
+    edit = re.search(r'\(TIME incremental: ([0-9.e+-]+) us per edit, ([0-9]+) bytes', stderr)
+    return (float(edit.group(1)), int(edit.group(2))) if edit else None
+
+
+def incbench():
+    if len(sys.argv) < 2:
+        exit('Usage: python incbench.py EXE [EDITS]')
+    exe = sys.argv[1]
+    edits = sys.argv[2] if len(sys.argv) > 2 else '1000'
+    parsebench.target_size = target_size
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'Generated_1MB.txt')
+        parsebench.generate(path)
+        fulls = benchutil.repeat(repeat, run_full, exe, path)
+        results = benchutil.repeat(repeat, run_edits, exe, edits, path)
+        if not fulls or not results:
+            exit('No timing output from ' + exe)
+        full = min(fulls)
+        edit = min(r[0] for r in results)
+        print('Program size: %.1f MB, %s edits' % (benchutil.size_mb(path), edits))
+        print('%-26s %12.1f ms' % ('full tokenizer + parser', full))
+        print('%-26s %12.1f us' % ('incremental reparse', edit))
+        print('%-26s %12d bytes' % ('reparsed per edit', results[0][1]))
+        print('%-26s %12.0fx' % ('speedup', full * 1000 / edit))
+
+
+if __name__ == '__main__':
+    incbench()
@@ -0,0 +1,84 @@
+import os
+import random
+import re
+import sys
+import tempfile
+
+import benchutil
+from benchutil import test_path
+
+# USAGE
+#   python jitbench.py EXE [ENGINE ...]
+# Compares the native engines (jit, stencil) with ExecutionVisitor:
+# - startup: time to compile a long generated program (the "compiler"
+#   phase printed by --time; 0 for the visitor, which needs no
+#   compilation)
+# - steady state: execution time of long-running loops
+
+# NUMBER OF RUNS PER (PROGRAM, ENGINE), THE BEST ONE IS KEPT
+repeat = 5
+# STATEMENTS OF THE STARTUP PROGRAM
+statements = 100000
+
+loop_program = '''(BLOCK
+  (SET i 0)
+  (SET s 0)
+  (WHILE (LT i 3000000)
+    (BLOCK
+      (SET s (ADD (DIV s 2) i))
+      (SET i (ADD i 1))))
+  (PRINT s))
+'''
+
+
+def startup_program():
+    # straight-line code that runs in no time: the cost is compilation
+    random.seed(1)
+    names = ['a', 'b', 'c', 'd']
+    body = ['(SET %s %d)' % (v, i + 1) for i, v in enumerate(names)]
+    for _ in range(statements):
+        v, w = random.sample(names, 2)
+        r = random.random()
+        if r < 0.5:
+            body.append('(SET %s (ADD (MUL %s 3) (SUB %s 1)))' % (v, w, v))
+        elif r < 0.8:
+            body.append('(IF (AND (GT %s 0) (LT %s 1000)) (SET %s (DIV %s 2)) (SET %s 7))' % (v, w, v, v, v))
+        else:
+            body.append('(SET %s (SUB %s %s))' % (v, w, v))
+    body.append('(PRINT a)')
+    return '(BLOCK\n' + '\n'.join(body) + ')\n'
+
+
+def run(exe, engine, path):
+    # best compile and execution times
+    def once():
+        stderr, _, _ = benchutil.run(exe, ['--engine', engine, '--time'], path)
+        times = benchutil.phase_times(stderr)
+        return times.get('compiler', 0.0), times.get('execution', 0.0)
+    return min(benchutil.repeat(repeat, once), key=sum)
+
+
+def jitbench():
+    if len(sys.argv) < 2:
+        exit('Usage: python jitbench.py EXE [ENGINE ...]')
+    exe = sys.argv[1]
+    engines = sys.argv[2:] if len(sys.argv) > 2 else ['visitor', 'jit', 'stencil']
+
+    with tempfile.TemporaryDirectory() as tmp:
+        workloads = [('startup_100k', startup_program()), ('Loop_3M', loop_program)]
+        with open(os.path.join(test_path, 'PASS_ManyPrimes.txt')) as f:
+            workloads.append(('ManyPrimes_n4000',
+                              re.sub(r'\(SET n [0-9]+\)', '(SET n 4000)', f.read(), count=1)))
+
+        print('%-18s' % 'program' + ''.join('%24s' % e for e in engines))
+        print('%-18s' % '' + ''.join('%24s' % 'compile + execute (ms)' for _ in engines))
+        for name, text in workloads:
+            path = benchutil.write_program(tmp, name + '.txt', text)
+            row = '%-18s' % name
+            for engine in engines:
+                compile_ms, execute_ms = run(exe, engine, path)
+                row += '%24s' % ('%.2f + %.2f' % (compile_ms, execute_ms))
+            print(row)
+
+
+jitbench()
@@ -0,0 +1,80 @@
+import os
+import random
+import sys
+import tempfile
+
+import benchutil
+import parsebench
+
+# USAGE
+#   python lazybench.py EXE [COLD]
+# Generates a ~10 MB program where the statements are grouped in blocks
+# of 20, and a fraction COLD of the blocks (by default 0.9) is the body
+# of an IF whose guard is always false. Runs the executable with and
+# without --lazy and reports the best time of each phase (the startup is
+# tokenizer + parser + resolver) and of --check, which parses everything.
+
+# SIZE OF THE GENERATED PROGRAM IN BYTES
+target_size = 10 * 1024 * 1024
+
+# NUMBER OF RUNS PER CONFIGURATION, THE BEST ONE IS KEPT
+repeat = 5
+
+# STATEMENTS IN EACH BLOCK
+group_size = 20
+
+
+def generate(path, cold):
+    rng = random.Random(42)
+    size = 0
+    with open(path, 'w') as f:
+        f.write('(BLOCK\n')
+        for v in parsebench.variables:
+            f.write('  (SET %s 1)\n' % v)
+        while size < target_size:
+            body = ' '.join(parsebench.statement(rng) for _ in range(group_size))
+            if rng.random() < cold:
+                line = '  (IF (LT 1 0) (BLOCK %s) (SET count (ADD count 1)))\n' % body
+            else:
+                line = '  (IF (LT 0 1) (BLOCK %s) (SET count (ADD count 1)))\n' % body
+            f.write(line)
+            size += len(line)
+        f.write('  (PRINT total))\n')
+
+
+def run(exe, options, path):
+    stderr, _, _ = benchutil.run(exe, ['--time'] + options, path)
+    times = benchutil.phase_times(stderr)
+    # --check reports its parsing as the check phase
+    if 'parser' not in times and 'check' not in times:
+        return None
+    startup = sum(times.get(phase, 0) for phase in ('tokenizer', 'parser', 'check', 'resolver'))
+    return startup, times.get('execution', 0)
+
+
+def best(exe, options, path):
+    results = benchutil.repeat(repeat, run, exe, options, path)
+    if not results:
+        exit('No timing output from ' + exe)
+    return min(r[0] for r in results), min(r[1] for r in results), min(r[0] + r[1] for r in results)
+
+
+def lazybench():
+    if len(sys.argv) < 2:
+        exit('Usage: python lazybench.py EXE [COLD]')
+    exe = sys.argv[1]
+    cold = float(sys.argv[2]) if len(sys.argv) > 2 else 0.9
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'Generated_cold.txt')
+        generate(path, cold)
+        print('Program size: %.1f MB, %.0f%% of the blocks never executed'
+              % (benchutil.size_mb(path), cold * 100))
+        print('%-10s %12s %12s %12s' % ('', 'startup', 'execution', 'total'))
+        for name, options in (('eager', []), ('--lazy', ['--lazy'])):
+            print('%-10s %9.1f ms %9.1f ms %9.1f ms' % ((name,) + best(exe, options, path)))
+        check = best(exe, ['--check'], path)
+        print('%-10s %9.1f ms' % ('--check', check[0]))
+
+
+if __name__ == '__main__':
+    lazybench()
@@ -0,0 +1,91 @@
+import os
+import sys
+import tempfile
+
+import benchutil
+
+# USAGE
+#   python nodebench.py EXE [EXE ...] [--engine ENGINE]
+# Measures the cost of evaluating one expression node. Each workload is a
+# loop whose body evaluates a balanced expression tree of a given depth;
+# the per-node cost is the difference between the deepest and the
+# shallowest tree, divided by the number of extra nodes evaluated.
+# Several executables can be compared (e.g. before and after a change).
+
+# NUMBER OF LOOP ITERATIONS AND OF RUNS PER PROGRAM, THE BEST ONE IS KEPT
+iterations = 200000
+repeat = 5
+depths = (0, 6)
+
+
+def num_tree(depth):
+    # (ADD ... ...) with the loop counter and 1 as leaves: 2^(d+1)-1 nodes
+    if depth == 0:
+        return 'i', 1
+    left, n = num_tree(depth - 1)
+    right, _ = num_tree(depth - 1)
+    return '(ADD %s %s)' % (left, right), 2 * n + 1
+
+
+def bool_tree(depth, op):
+    # AND of true comparisons (or OR of false ones), so that nothing is
+    # short-circuited: every RelOp counts 3 nodes
+    if depth == 0:
+        return ('(EQ i i)' if op == 'AND' else '(LT i 0)'), 3
+    left, n = bool_tree(depth - 1, op)
+    right, _ = bool_tree(depth - 1, op)
+    return '(%s %s %s)' % (op, left, right), 2 * n + 1
+
+
+def program(kind, depth):
+    if kind == 'num':
+        expr, nodes = num_tree(depth)
+        body = '(SET x %s)' % expr
+    else:
+        expr, nodes = bool_tree(depth, 'AND' if kind == 'and' else 'OR')
+        body = '(IF %s (SET x 1) (SET x 0))' % expr
+    text = '''(BLOCK
+  (SET i 0)
+  (WHILE (LT i %d)
+    (BLOCK
+      %s
+      (SET i (ADD i 1))))
+  (PRINT x))
+''' % (iterations, body)
+    return text, nodes
+
+
+def run(exe, args, path):
+    def once():
+        stderr, _, _ = benchutil.run(exe, args + ['--time'], path)
+        return benchutil.phase_time(stderr, 'execution')
+    return min(benchutil.repeat(repeat, once), default=None)
+
+
+def nodebench():
+    args = sys.argv[1:]
+    options = []
+    if '--engine' in args:
+        i = args.index('--engine')
+        options = args[i:i + 2]
+        del args[i:i + 2]
+    if not args:
+        exit('Usage: python nodebench.py EXE [EXE ...] [--engine ENGINE]')
+
+    with tempfile.TemporaryDirectory() as tmp:
+        print('%-10s' % 'workload' + ''.join('%16s' % os.path.basename(e) for e in args) + '   (ns/node)')
+        for kind in ('num', 'and', 'or'):
+            paths = []
+            for depth in depths:
+                text, nodes = program(kind, depth)
+                paths.append((benchutil.write_program(tmp, '%s_%d.txt' % (kind, depth), text), nodes))
+            extra = (paths[-1][1] - paths[0][1]) * iterations
+            row = '%-10s' % kind
+            for exe in args:
+                low = run(exe, options, paths[0][0])
+                high = run(exe, options, paths[-1][0])
+                row += '%16s' % ('-' if low is None or high is None else '%.2f' % ((high - low) * 1e6 / extra))
+            print(row)
+
+
+nodebench()
@@ -0,0 +1,94 @@
+import os
+import random
+import sys
+import tempfile
+
+import benchutil
+
+# USAGE
+#   python parsebench.py EXE [EXE ...]
+# Generates a ~10 MB program and reports, for each executable, the best
+# parser time (as printed by --time) and the peak resident set size of
+# the whole run. Passing the executables built before and after a change
+# compares them side by side.
+# Options starting with -- (e.g. --stream, --ast compact) are passed to
+# every executable; with --stream the parser time includes tokenization.
+
+# SIZE OF THE GENERATED PROGRAM IN BYTES
+target_size = 10 * 1024 * 1024
+
+# NUMBER OF RUNS PER EXECUTABLE, THE BEST TIME AND THE LOWEST RSS ARE KEPT
+repeat = 5
+
+variables = ['a', 'b', 'c', 'x', 'y', 'z', 'total', 'count']
+
+
+def num_expr(rng, depth):
+    if depth == 0 or rng.random() < 0.3:
+        if rng.random() < 0.5:
+            return str(rng.randint(1, 1000))
+        return rng.choice(variables)
+    op = rng.choice(['ADD', 'SUB', 'MUL', 'DIV'])
+    right = str(rng.randint(1, 9)) if op == 'DIV' else num_expr(rng, depth - 1)
+    return '(%s %s %s)' % (op, num_expr(rng, depth - 1), right)
+
+
+def bool_expr(rng, depth):
+    r = rng.random()
+    if depth == 0 or r < 0.5:
+        return '(%s %s %s)' % (rng.choice(['LT', 'GT', 'EQ']), num_expr(rng, 2), num_expr(rng, 2))
+    if r < 0.6:
+        return '(NOT %s)' % bool_expr(rng, depth - 1)
+    return '(%s %s %s)' % (rng.choice(['AND', 'OR']), bool_expr(rng, depth - 1), bool_expr(rng, depth - 1))
+
+
+def statement(rng):
+    r = rng.random()
+    if r < 0.6:
+        return '(SET %s %s)' % (rng.choice(variables), num_expr(rng, 4))
+    if r < 0.8:
+        return '(IF %s (SET %s %s) (SET %s %s))' % (bool_expr(rng, 2), rng.choice(variables), num_expr(rng, 3),
+                                                    rng.choice(variables), num_expr(rng, 3))
+    # the guard is always false, the body is parsed but never executed
+    return '(WHILE (LT 1 0) (BLOCK (SET %s %s) (PRINT %s)))' % (rng.choice(variables), num_expr(rng, 3),
+                                                                  rng.choice(variables))
+
+
+def generate(path):
+    rng = random.Random(42)
+    size = 0
+    with open(path, 'w') as f:
+        f.write('(BLOCK\n')
+        for v in variables:
+            f.write('  (SET %s 1)\n' % v)
+        while size < target_size:
+            line = '  ' + statement(rng) + '\n'
+            f.write(line)
+            size += len(line)
+        f.write('  (PRINT total))\n')
+
+
+def run(exe, options, path):
+    stderr, _, usage = benchutil.run(exe, ['--time'] + options, path, resource_usage=True)
+    # ru_maxrss is in KiB on Linux
+    return benchutil.phase_time(stderr, 'parser'), usage.ru_maxrss / 1024
+
+
+def parsebench():
+    options, executables = benchutil.split_arguments(sys.argv[1:])
+    if not executables:
+        exit('Usage: python parsebench.py [OPTIONS] EXE [EXE ...]')
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'Generated_10MB.txt')
+        generate(path)
+        print('Program size: %.1f MB' % benchutil.size_mb(path))
+        print('%-40s %14s %14s' % ('executable', 'parser (ms)', 'max RSS (MB)'))
+        for exe in executables:
+            results = [run(exe, options, path) for _ in range(repeat)]
+            times = [t for t, _ in results if t is not None]
+            best_time = '%.1f' % min(times) if times else '-'
+            print('%-40s %14s %14.1f' % (exe, best_time, min(rss for _, rss in results)))
+
+
+if __name__ == '__main__':
+    parsebench()
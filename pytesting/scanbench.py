@@ -0,0 +1,50 @@
+import os
+import sys
+import tempfile
+
+import benchutil
+from parsebench import generate
+
+# USAGE
+#   python scanbench.py EXE [SCANNER ...]
+# Tokenizes the ~10 MB program generated by parsebench.py with each
+# --scanner level of the executable (by default none, scalar, sse2 and
+# avx2) and reports the best tokenizer time and the throughput in GB/s.
+# "none" is the byte-at-a-time tokenizer the other levels are compared
+# against. Levels the CPU does not support are skipped.
+
+# NUMBER OF RUNS PER LEVEL, THE BEST ONE IS KEPT
+repeat = 7
+
+default_scanners = ['none', 'scalar', 'sse2', 'avx2']
+
+
+def run(exe, scanner, path):
+    stderr, _, _ = benchutil.run(exe, ['--time', '--scanner', scanner], path)
+    return benchutil.phase_time(stderr, 'tokenizer')
+
+
+def best(exe, scanner, path):
+    return min(benchutil.repeat(repeat, run, exe, scanner, path), default=None)
+
+
+def scanbench():
+    if len(sys.argv) < 2:
+        exit('Usage: python scanbench.py EXE [SCANNER ...]')
+    exe = sys.argv[1]
+    scanners = sys.argv[2:] or default_scanners
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'Generated_10MB.txt')
+        generate(path)
+        size = os.path.getsize(path)
+        print('Program size: %.1f MB' % (size / (1024 * 1024)))
+        print('%-10s %16s %10s %10s' % ('scanner', 'tokenizer (ms)', 'GB/s', 'speedup'))
+        for scanner, time, speedup in benchutil.speedup_rows(scanners, lambda s: best(exe, s, path)):
+            if time is None:
+                print('%-10s %16s' % (scanner, 'unsupported'))
+            else:
+                print('%-10s %16.1f %10.3f %9.2fx' % (scanner, time, size / (time / 1000) / 1e9, speedup))
+
+
+if __name__ == '__main__':
+    scanbench()
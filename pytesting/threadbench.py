@@ -0,0 +1,59 @@
+import os
+import sys
+import tempfile
+
+import benchutil
+from parsebench import generate
+
+# USAGE
+#   python threadbench.py [--parser] EXE [THREADS ...]
+# Tokenizes the ~10 MB program generated by parsebench.py with each
+# --threads value (by default 1, 2, 4 and 8) and reports the best
+# tokenizer time and the speedup over the first value. The Tokenizer
+# never uses more parts than one per MB of source, so larger programs
+# are needed to see the effect of more threads.
+# With --parser the --parse-threads values are compared instead, by
+# parser time: the statements of the top-level BLOCK are parsed in
+# parallel, one part per 64K tokens at most.
+
+# NUMBER OF RUNS PER THREAD COUNT, THE BEST ONE IS KEPT
+repeat = 5
+
+default_threads = ['1', '2', '4', '8']
+
+
+def run(exe, phase, threads, path):
+    option = '--parse-threads' if phase == 'parser' else '--threads'
+    stderr, _, _ = benchutil.run(exe, ['--time', option, threads], path)
+    return benchutil.phase_time(stderr, phase)
+
+
+def best(exe, phase, threads, path):
+    return min(benchutil.repeat(repeat, run, exe, phase, threads, path), default=None)
+
+
+def threadbench():
+    arguments = sys.argv[1:]
+    phase = 'tokenizer'
+    if arguments and arguments[0] == '--parser':
+        phase = 'parser'
+        arguments = arguments[1:]
+    if not arguments:
+        exit('Usage: python threadbench.py [--parser] EXE [THREADS ...]')
+    exe = arguments[0]
+    thread_counts = arguments[1:] or default_threads
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'Generated_10MB.txt')
+        generate(path)
+        print('Program size: %.1f MB, %d cores' % (benchutil.size_mb(path), os.cpu_count()))
+        print('%-10s %16s %10s' % ('threads', phase + ' (ms)', 'speedup'))
+        for threads, time, speedup in benchutil.speedup_rows(thread_counts,
+                                                             lambda t: best(exe, phase, t, path)):
+            if time is None:
+                print('%-10s %16s' % (threads, 'no output'))
+            else:
+                print('%-10s %16.1f %9.2fx' % (threads, time, speedup))
+
+
+if __name__ == '__main__':
+    threadbench()
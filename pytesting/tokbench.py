@@ -0,0 +1,55 @@
+import os
+import re
+import sys
+import tempfile
+
+import benchutil
+from parsebench import generate
+
+# USAGE
+#   python tokbench.py EXE [EXE ...]
+# Tokenizes the ~10 MB program generated by parsebench.py with each
+# executable and reports tokens per second (from --time) and, for
+# executables built with -DCOUNT_ALLOCATIONS, heap allocations per token
+# (from --memory).
+# Options starting with -- (e.g. --scanner none) are passed to every
+# executable.
+
+# NUMBER OF RUNS PER EXECUTABLE, THE BEST ONE IS KEPT
+repeat = 5
+
+
+def run(exe, options, path):
+    stderr, _, _ = benchutil.run(exe, ['--time', '--memory'] + options, path)
+    time = benchutil.phase_time(stderr, 'tokenizer')
+    memory = re.search(r'\(MEMORY tokenizer: ([0-9]+) tokens, [0-9]+ bytes(?:, ([0-9]+) allocations)? \)',
+                       stderr)
+    if time is None or memory is None:
+        return None
+    allocations = int(memory.group(2)) if memory.group(2) else None
+    return time, int(memory.group(1)), allocations
+
+
+def tokbench():
+    options, executables = benchutil.split_arguments(sys.argv[1:])
+    if not executables:
+        exit('Usage: python tokbench.py [OPTIONS] EXE [EXE ...]')
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'Generated_10MB.txt')
+        generate(path)
+        print('Program size: %.1f MB' % benchutil.size_mb(path))
+        print('%-40s %12s %14s %14s' % ('executable', 'tokens', 'Mtokens/s', 'allocs/token'))
+        for exe in executables:
+            results = benchutil.repeat(repeat, run, exe, options, path)
+            if not results:
+                print('%-40s %12s' % (exe, 'no output'))
+                continue
+            best = min(results)
+            tokens = best[1]
+            rate = tokens / best[0] / 1000
+            allocs = '%.3f' % (best[2] / tokens) if best[2] is not None else '-'
+            print('%-40s %12d %14.1f %14s' % (exe, tokens, rate, allocs))
+
+
+if __name__ == '__main__':
+    tokbench()
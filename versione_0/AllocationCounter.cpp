@@ -0,0 +1,43 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "AllocationCounter.h"
+
+#ifdef COUNT_ALLOCATIONS
+
+// atomico perché Tokenizer e ParallelParser allocano da più thread
+static std::atomic<std::size_t> allocations{ 0 };
+
+/*
+ * Le versioni array e nothrow di new e delete usano queste,
+ * quindi basta sostituire le due funzioni di base
+ */
+void* operator new(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	void* memory = std::malloc(size != 0 ? size : 1);
+	if (memory == nullptr)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t size) noexcept
+{
+	std::free(memory);
+}
+
+bool AllocationCounter::enabled() { return true; }
+std::size_t AllocationCounter::count() { return allocations; }
+
+#else
+
+bool AllocationCounter::enabled() { return false; }
+std::size_t AllocationCounter::count() { return 0; }
+
+#endif
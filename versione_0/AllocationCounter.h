@@ -0,0 +1,22 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+/*
+ * Se il programma è compilato con COUNT_ALLOCATIONS definita,
+ * AllocationCounter.cpp sostituisce l'operatore new globale con
+ * una versione che conta le allocazioni, usata per misurare le
+ * allocazioni delle singole fasi (opzione --memory).
+ * Senza COUNT_ALLOCATIONS l'operatore new non viene toccato.
+ */
+struct AllocationCounter
+{
+	// true se le allocazioni vengono contate
+	static bool enabled();
+
+	// Numero di allocazioni dall'avvio del programma
+	static std::size_t count();
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include "Arena.h"
+
+/**
+ * allocateSlow
+ *
+ * Chiamata quando il chunk corrente non ha abbastanza spazio:
+ * alloca un nuovo chunk e ne usa l'inizio. Lo spazio rimasto
+ * libero nel chunk precedente viene abbandonato.
+ */
+void* Arena::allocateSlow(std::size_t size, std::size_t align)
+{
+	// new[] restituisce memoria allineata per qualsiasi tipo
+	// fondamentale, quindi l'inizio del chunk è già allineato
+	// ad align (al massimo alignof(max_align_t), vedi allocate)
+	assert(align <= alignof(std::max_align_t));
+	(void)align;
+	std::size_t newCapacity = size > chunkSize ? size : chunkSize;
+	char* chunk = new char[newCapacity];
+	chunks.push_back(chunk);
+	reserved += newCapacity;
+
+	current = chunk;
+	capacity = newCapacity;
+	used = size;
+	return chunk;
+}
+
+/**
+ * release
+ *
+ * Restituisce al sistema tutti i chunk. Ogni puntatore
+ * ottenuto da allocate diventa invalido.
+ */
+void Arena::release()
+{
+	for (char* chunk : chunks)
+		delete[] chunk;
+	chunks.clear();
+	current = nullptr;
+	used = 0;
+	capacity = 0;
+	reserved = 0;
+}
+
+/**
+ * merge
+ *
+ * I chunk di other passano a questa arena e verranno liberati
+ * insieme ai suoi; le allocazioni continuano nel chunk
+ * corrente. Gli oggetti costruiti in other non vengono
+ * spostati, quindi i puntatori restano validi.
+ */
+void Arena::merge(Arena& other)
+{
+	chunks.insert(chunks.end(), other.chunks.begin(), other.chunks.end());
+	reserved += other.reserved;
+	other.chunks.clear();
+	other.current = nullptr;
+	other.used = 0;
+	other.capacity = 0;
+	other.reserved = 0;
+}
@@ -0,0 +1,62 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Arena è un allocatore a puntatore crescente (bump allocator):
+ * la memoria viene richiesta al sistema in blocchi (chunk) di
+ * grandi dimensioni, e ogni allocazione si limita a far avanzare
+ * un puntatore all'interno del chunk corrente.
+ *
+ * Non è possibile liberare una singola allocazione: tutta la
+ * memoria viene restituita in un colpo solo da release() o dal
+ * distruttore. Gli oggetti costruiti nell'arena non vengono
+ * distrutti, chi li crea deve chiamarne il distruttore se
+ * necessario.
+ */
+class Arena
+{
+public:
+	Arena() = default;
+	Arena(const Arena& other) = delete;
+	~Arena() { release(); }
+
+	// Restituisce size byte allineati ad align (potenza di 2).
+	// Gli allineamenti sono calcolati a partire dall'inizio del
+	// chunk, che new[] allinea solo fino a max_align_t: align
+	// non può essere maggiore
+	void* allocate(std::size_t size, std::size_t align)
+	{
+		assert(align <= alignof(std::max_align_t));
+		std::size_t offset = (used + align - 1) & ~(align - 1);
+		if (offset + size > capacity)
+			return allocateSlow(size, align);
+		used = offset + size;
+		return current + offset;
+	}
+
+	void release();
+
+	// Prende i chunk di other, che resta vuota
+	void merge(Arena& other);
+
+	// Byte riservati al sistema (somma delle dimensioni dei chunk)
+	std::size_t bytesReserved() const { return reserved; }
+private:
+	// Dimensione di un chunk, le allocazioni più grandi ne
+	// ricevono uno dedicato
+	static const std::size_t chunkSize = 64 * 1024;
+
+	void* allocateSlow(std::size_t size, std::size_t align);
+
+	std::vector<char*> chunks;
+	char* current = nullptr;
+	std::size_t used = 0;
+	std::size_t capacity = 0;
+	std::size_t reserved = 0;
+};
+
+#endif
@@ -1,8 +1,22 @@
 #include "Block.h"
 #include "Visitor.h"
-// Dentro il file *.cpp  possibile includere Visitor
+// Dentro il file *.cpp è possibile includere Visitor
 
 void Block::accept(Visitor* v)
 {
 	(*v).visitBlock(this);
+}
+
+/**
+ * load
+ *
+ * Analizza il corpo di un Block pigro. Se il corpo contiene
+ * un errore di sintassi il Block resta pigro e il SyntaxError
+ * arriva a chi ha chiesto gli Statement.
+ */
+void Block::load() const
+{
+	// il BlockLoader completa il Block con finishLoad, che
+	// non è const: il Block pigro è stato creato non const
+	loader->load(const_cast<Block*>(this));
 }
\ No newline at end of file
@@ -9,9 +9,24 @@
 
 #include "Statement.h"
 
-// Visitor include gi Block, quindi Block non pu includere
+// Visitor include già Block, quindi Block non può includere
 // a sua volta Visitor, ma la classe deve comunque essere dichiarata
 class Visitor;
+class Block;
+struct Token;
+
+/**
+ * BlockLoader analizza il corpo di un Block pigro (vedi
+ * LazyLoader) la prima volta che vengono richiesti i suoi
+ * Statement.
+ */
+class BlockLoader
+{
+public:
+	virtual ~BlockLoader() = default;
+	// Analizza i Token del Block e chiama block->finishLoad
+	virtual void load(Block* block) = 0;
+};
 
 
 class Block
@@ -29,14 +44,45 @@ public:
 		statements.push_back(statement);
 		//std::cout << "BLK: Statements are now " << statements.size() << std::endl;
 	}
+	// Sostituisce lo statement in posizione index (usato da
+	// IncrementalParser)
+	void replaceStatement(std::size_t index, Statement* statement)
+	{
+		statements[index] = statement;
+	}
 	const std::vector<Statement*>& getStatements() const
 	{
+		if (loader != nullptr)
+			load();
 		return statements;
 	}
-	
+
+	// Block pigro: gli Statement vengono generati da loader
+	// alla prima chiamata di getStatements, a partire dai Token
+	// da first (incluso) a last (escluso)
+	void defer(BlockLoader* blockLoader, const Token* first, const Token* last)
+	{
+		loader = blockLoader;
+		firstToken = first;
+		lastToken = last;
+	}
+	bool isLoaded() const { return loader == nullptr; }
+	const Token* getFirstToken() const { return firstToken; }
+	const Token* getLastToken() const { return lastToken; }
+	// Chiamato dal BlockLoader con gli Statement analizzati
+	void finishLoad(const std::vector<Statement*>& loaded)
+	{
+		statements = loaded;
+		loader = nullptr;
+	}
 	
 private:
+	void load() const;
+
 	std::vector<Statement*> statements;
+	BlockLoader* loader = nullptr;
+	const Token* firstToken = nullptr;
+	const Token* lastToken = nullptr;
 };
 
 #endif
\ No newline at end of file
@@ -1,13 +1,18 @@
 #include "BoolExpr.h"
 #include "Visitor.h"
+#include "Evaluator.h"
 #include "Token.h"
-// Dentro il file *.cpp  possibile includere Visitor
+// Dentro il file *.cpp è possibile includere Visitor
 
 void RelOp::accept(Visitor* v) { (*v).visitRelOp(this); }
 
 void BoolConst::accept(Visitor* v) { (*v).visitBoolConst(this); }
 void BoolOp::accept(Visitor* v) { (*v).visitBoolOp(this); }
 
+bool RelOp::eval(Evaluator* e) { return e->evalRelOp(this); }
+bool BoolConst::eval(Evaluator* e) { return e->evalBoolConst(this); }
+bool BoolOp::eval(Evaluator* e) { return e->evalBoolOp(this); }
+
 BoolOp::OpCode BoolOp::tokenToOpCode(const Token& t)
 {
 	if (t.tag == Token::AND) return AND;
@@ -4,18 +4,32 @@
 #include "NumExpr.h"
 #include "Token.h"
 
-// Visitor include gi BoolExpr, quindi BoolExpr non pu includere
+// Visitor include già BoolExpr, quindi BoolExpr non può includere
 // a sua volta Visitor, ma la classe deve comunque essere dichiarata
 class Visitor;
+class Evaluator;
 
 /*
- * Espressione booleana (true/false) generica
+ * Espressione booleana (true/false) generica, con il tipo
+ * concreto in kind (vedi Statement)
  */
 class BoolExpr
 {
 public:
+	enum Kind : std::uint8_t { REL_OP, BOOL_OP, BOOL_CONST };
+
 	virtual ~BoolExpr() {};
 	virtual void accept(Visitor* v) = 0;
+	// valuta l'espressione restituendo il risultato
+	virtual bool eval(Evaluator* e) = 0;
+
+	Kind getKind() const { return kind; }
+protected:
+	BoolExpr(Kind k) : kind{ k } {}
+	BoolExpr(const BoolExpr& other) = default;
+	BoolExpr& operator=(const BoolExpr& other) = default;
+private:
+	Kind kind;
 };
 
 /*
@@ -28,12 +42,13 @@ public:
 	enum OpCode { GT, LT, EQ, ERR };
 
 	RelOp(OpCode o, NumExpr* lop, NumExpr* rop) :
-		operation{ o }, left{ lop }, right{ rop } {}
+		BoolExpr{ REL_OP }, operation{ o }, left{ lop }, right{ rop } {}
 	RelOp(const RelOp& other) = default;
 	~RelOp() = default;
 	RelOp& operator=(const RelOp& other) = default;
 
 	void accept(Visitor* v) override;
+	bool eval(Evaluator* e) override;
 
 	OpCode getOp() const { return operation; }
 	NumExpr* getLeft() const { return left; }
@@ -57,12 +72,13 @@ public:
 	enum OpCode { AND, OR, NOT, ERR };
 
 	BoolOp(OpCode o, BoolExpr* lop, BoolExpr* rop) :
-		operation{ o }, left{ lop }, right{ rop } {}
+		BoolExpr{ BOOL_OP }, operation{ o }, left{ lop }, right{ rop } {}
 	BoolOp(const BoolOp& other) = default;
 	~BoolOp() = default;
 	BoolOp& operator=(const BoolOp& other) = default;
 
 	void accept(Visitor* v) override;
+	bool eval(Evaluator* e) override;
 
 	OpCode getOp() const { return operation; }
 	BoolExpr* getLeft() const { return left; }
@@ -87,12 +103,13 @@ private:
 class BoolConst : public BoolExpr
 {
 public:
-	BoolConst(bool v) : value{ v } {}
+	BoolConst(bool v) : BoolExpr{ BOOL_CONST }, value{ v } {}
 	BoolConst(const BoolConst& other) = default;
 	~BoolConst() {}
 	BoolConst& operator=(const BoolConst& other) = default;
 
 	void accept(Visitor* v) override;
+	bool eval(Evaluator* e) override;
 
 	int getValue() const { return value; }
 private:
@@ -0,0 +1,50 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Istruzione della macchina a pila (StackVM).
+ *
+ * Ogni istruzione occupa 8 byte: il codice operativo e un
+ * argomento intero, il cui significato dipende dall'istruzione:
+ * - PUSH:  costante da scrivere sulla pila
+ * - LOAD, STORE, INPUT: indice della variabile
+ * - JUMP, JUMP_IF_...: salto relativo, misurato a partire
+ *   dall'istruzione successiva a quella di salto
+ * Le altre istruzioni non usano l'argomento.
+ *
+ * I valori booleani vengono scritti sulla stessa pila dei
+ * valori interi, come 0 (falso) oppure 1 (vero).
+ */
+struct Instruction
+{
+	// L'ordine deve corrispondere alla tabella di dispatch
+	// di StackVM
+	enum OpCode : unsigned char { PUSH, LOAD, STORE, INPUT, PRINT,
+		ADD, SUB, MUL, DIV, GT, LT, EQ, NOT,
+		JUMP, JUMP_IF_FALSE, JUMP_IF_FALSE_OR_POP,
+		JUMP_IF_TRUE_OR_POP, HALT };
+
+	Instruction(OpCode o, int a) : op{ o }, arg{ a } {}
+
+	OpCode op;
+	int arg;
+};
+
+/**
+ * Programma compilato da BytecodeCompiler, contiene:
+ * - Il flusso di istruzioni, terminato da HALT
+ * - I nomi delle variabili, nell'ordine degli indici usati
+ *   da LOAD, STORE e INPUT (servono per i messaggi di errore)
+ * - La profondità massima raggiunta dalla pila
+ */
+struct BytecodeProgram
+{
+	std::vector<Instruction> code;
+	std::vector<std::string> variableNames;
+	int maxStackDepth = 0;
+};
+
+#endif
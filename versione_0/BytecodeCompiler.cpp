@@ -0,0 +1,284 @@
+#include "BytecodeCompiler.h"
+#include "Block.h"
+#include "Statement.h"
+#include "NumExpr.h"
+#include "BoolExpr.h"
+
+/**
+ * operator()
+ *
+ * Compila l'intero programma e restituisce il flusso di
+ * istruzioni, terminato da HALT.
+ */
+BytecodeProgram BytecodeCompiler::operator()(Block* root)
+{
+	program = BytecodeProgram{};
+	program.variableNames = symbols->getNames();
+	stackDepth = 0;
+
+	root->accept(this);
+	emit(Instruction::HALT, 0, 0);
+
+	return std::move(program);
+}
+
+/**
+ * emit
+ *
+ * Aggiunge un'istruzione in coda al programma, stackEffect è
+ * la variazione della profondità della pila dopo l'esecuzione,
+ * usata per dimensionare la pila di StackVM.
+ */
+void BytecodeCompiler::emit(Instruction::OpCode op, int arg, int stackEffect)
+{
+	program.code.push_back(Instruction{ op, arg });
+	stackDepth += stackEffect;
+	if (stackDepth > program.maxStackDepth)
+		program.maxStackDepth = stackDepth;
+}
+
+/**
+ * emitJump
+ *
+ * Aggiunge un salto in avanti con destinazione ancora da
+ * definire, restituisce la posizione dell'istruzione per
+ * poterla completare con patchJump.
+ */
+int BytecodeCompiler::emitJump(Instruction::OpCode op, int stackEffect)
+{
+	emit(op, 0, stackEffect);
+	return (int)program.code.size() - 1;
+}
+
+/**
+ * patchJump
+ *
+ * Completa un salto in avanti facendolo puntare alla prossima
+ * istruzione che verrà emessa.
+ */
+void BytecodeCompiler::patchJump(int jumpIndex)
+{
+	program.code[jumpIndex].arg = (int)program.code.size() - (jumpIndex + 1);
+}
+
+/**
+ * emitJumpBack
+ *
+ * Aggiunge un salto all'indietro verso un'istruzione già emessa.
+ */
+void BytecodeCompiler::emitJumpBack(int targetIndex)
+{
+	int jumpIndex = (int)program.code.size();
+	emit(Instruction::JUMP, targetIndex - (jumpIndex + 1), 0);
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * BYTECODECOMPILER PER BLOCK E STATEMENTS
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * Un blocco si traduce concatenando i suoi statement
+ */
+void BytecodeCompiler::visitBlock(Block* blockNode)
+{
+	for (Statement* stmt : blockNode->getStatements())
+		stmt->accept(this);
+}
+
+/**
+ * Un IF-Statement si traduce in:
+ *      <condizione>
+ *      JUMP_IF_FALSE else
+ *      <blocco if>
+ *      JUMP end
+ * else:
+ *      <blocco else>
+ * end:
+ */
+void BytecodeCompiler::visitIfStmt(IfStmt* ifStmtNode)
+{
+	ifStmtNode->getCondition()->accept(this);
+	int jumpElse = emitJump(Instruction::JUMP_IF_FALSE, -1);
+
+	ifStmtNode->getBlockIf()->accept(this);
+	int jumpEnd = emitJump(Instruction::JUMP, 0);
+
+	patchJump(jumpElse);
+	ifStmtNode->getBlockElse()->accept(this);
+
+	patchJump(jumpEnd);
+}
+
+/**
+ * Un WHILE-Statement si traduce in:
+ * start:
+ *      <condizione>
+ *      JUMP_IF_FALSE end
+ *      <blocco>
+ *      JUMP start
+ * end:
+ */
+void BytecodeCompiler::visitWhileStmt(WhileStmt* whileStmtNode)
+{
+	int start = (int)program.code.size();
+	whileStmtNode->getCondition()->accept(this);
+	int jumpEnd = emitJump(Instruction::JUMP_IF_FALSE, -1);
+
+	whileStmtNode->getBlock()->accept(this);
+	emitJumpBack(start);
+
+	patchJump(jumpEnd);
+}
+
+/**
+ * Un INPUT-Statement si traduce in INPUT variabile
+ */
+void BytecodeCompiler::visitInputStmt(InputStmt* inputStmtNode)
+{
+	emit(Instruction::INPUT, inputStmtNode->getVarId()->getSlot(), 0);
+}
+
+/**
+ * Un SET-Statement si traduce in:
+ *      <espressione>
+ *      STORE variabile
+ */
+void BytecodeCompiler::visitSetStmt(SetStmt* setStmtNode)
+{
+	setStmtNode->getNewValue()->accept(this);
+	emit(Instruction::STORE, setStmtNode->getVarId()->getSlot(), -1);
+}
+
+/**
+ * Un PRINT-Statement si traduce in:
+ *      <espressione>
+ *      PRINT
+ */
+void BytecodeCompiler::visitPrintStmt(PrintStmt* printStmtNode)
+{
+	printStmtNode->getPrintValue()->accept(this);
+	emit(Instruction::PRINT, 0, -1);
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * BYTECODECOMPILER PER ESPRESSIONI NUMERICHE E BOOLEANE
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * Un Operator si traduce in:
+ *      <primo operando>
+ *      <secondo operando>
+ *      ADD / SUB / MUL / DIV
+ */
+void BytecodeCompiler::visitOperator(Operator* operatorNode)
+{
+	operatorNode->getLeft()->accept(this);
+	operatorNode->getRight()->accept(this);
+
+	switch (operatorNode->getOp())
+	{
+	case Operator::PLUS:
+		emit(Instruction::ADD, 0, -1);
+		return;
+	case Operator::MINUS:
+		emit(Instruction::SUB, 0, -1);
+		return;
+	case Operator::TIMES:
+		emit(Instruction::MUL, 0, -1);
+		return;
+	case Operator::DIV:
+		emit(Instruction::DIV, 0, -1);
+		return;
+	default:
+		return;
+	}
+}
+
+/**
+ * Un Number si traduce in PUSH valore
+ */
+void BytecodeCompiler::visitNumber(Number* numberNode)
+{
+	emit(Instruction::PUSH, numberNode->getValue(), 1);
+}
+
+/**
+ * Una Variable si traduce in LOAD variabile
+ */
+void BytecodeCompiler::visitVariable(Variable* variableNode)
+{
+	emit(Instruction::LOAD, variableNode->getSlot(), 1);
+}
+
+/**
+ * Un RelOp si traduce in:
+ *      <primo operando>
+ *      <secondo operando>
+ *      GT / LT / EQ
+ */
+void BytecodeCompiler::visitRelOp(RelOp* relOpNode)
+{
+	relOpNode->getLeft()->accept(this);
+	relOpNode->getRight()->accept(this);
+
+	switch (relOpNode->getOp())
+	{
+	case RelOp::GT:
+		emit(Instruction::GT, 0, -1);
+		return;
+	case RelOp::LT:
+		emit(Instruction::LT, 0, -1);
+		return;
+	case RelOp::EQ:
+		emit(Instruction::EQ, 0, -1);
+		return;
+	default:
+		return;
+	}
+}
+
+/**
+ * Una BoolConst si traduce in PUSH 0 / PUSH 1
+ */
+void BytecodeCompiler::visitBoolConst(BoolConst* boolConstNode)
+{
+	emit(Instruction::PUSH, boolConstNode->getValue() ? 1 : 0, 1);
+}
+
+/**
+ * Un BoolOp si traduce in:
+ * - NOT:       <operando>
+ *              NOT
+ * - AND / OR:  <primo operando>
+ *              JUMP_IF_FALSE_OR_POP end (AND)
+ *              JUMP_IF_TRUE_OR_POP end  (OR)
+ *              <secondo operando>
+ *         end:
+ *
+ * Se il primo operando determina il risultato, il salto lo
+ * lascia sulla pila e salta il secondo operando
+ * (cortocircuitazione), altrimenti lo rimuove e il risultato
+ * è quello del secondo operando.
+ */
+void BytecodeCompiler::visitBoolOp(BoolOp* boolOpNode)
+{
+	boolOpNode->getLeft()->accept(this);
+
+	if (boolOpNode->getOp() == BoolOp::NOT)
+	{
+		emit(Instruction::NOT, 0, 0);
+		return;
+	}
+
+	Instruction::OpCode jumpOp = (boolOpNode->getOp() == BoolOp::AND) ?
+		Instruction::JUMP_IF_FALSE_OR_POP : Instruction::JUMP_IF_TRUE_OR_POP;
+	int jumpEnd = emitJump(jumpOp, -1);
+
+	boolOpNode->getRight()->accept(this);
+
+	patchJump(jumpEnd);
+}
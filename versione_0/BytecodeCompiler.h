@@ -0,0 +1,52 @@
+#ifndef BYTECODE_COMPILER_H
+#define BYTECODE_COMPILER_H
+
+#include "Visitor.h"
+#include "Bytecode.h"
+#include "SymbolTable.h"
+
+/**
+ * BytecodeCompiler traduce l'albero sintattico del programma
+ * in un flusso contiguo di istruzioni per StackVM.
+ *
+ * Le espressioni vengono tradotte in notazione postfissa, IF e
+ * WHILE in salti relativi. AND e OR mantengono la
+ * cortocircuitazione di ExecutionVisitor: il secondo operando
+ * viene saltato se il primo determina già il risultato.
+ * Le variabili, già risolte da SymbolResolver, sono indicate
+ * dal loro slot.
+ */
+class BytecodeCompiler : public Visitor
+{
+public:
+	BytecodeCompiler(const SymbolTable* st) : symbols{ st } {}
+
+	BytecodeProgram operator()(Block* program);
+
+	void visitBlock(Block* blockNode) override;
+
+	void visitPrintStmt(PrintStmt* printStmtNode) override;
+	void visitSetStmt(SetStmt* setStmtNode) override;
+	void visitInputStmt(InputStmt* inputStmtNode) override;
+	void visitWhileStmt(WhileStmt* whileStmtNode) override;
+	void visitIfStmt(IfStmt* ifStmtBlock) override;
+
+	void visitOperator(Operator* operatorNode) override;
+	void visitNumber(Number* numberNode) override;
+	void visitVariable(Variable* variableNode) override;
+
+	void visitRelOp(RelOp* relOpNode) override;
+	void visitBoolConst(BoolConst* boolConstNode) override;
+	void visitBoolOp(BoolOp* boolOpNode) override;
+private:
+	void emit(Instruction::OpCode op, int arg, int stackEffect);
+	int emitJump(Instruction::OpCode op, int stackEffect);
+	void patchJump(int jumpIndex);
+	void emitJumpBack(int targetIndex);
+
+	const SymbolTable* symbols;
+	BytecodeProgram program;
+	int stackDepth = 0;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef CHAR_CLASS_H
+#define CHAR_CLASS_H
+
+#include <cstdint>
+
+/**
+ * CharClass assegna a ognuno dei 256 byte la sua classe per
+ * l'analisi lessicale. La tabella è calcolata durante la
+ * compilazione e non dipende dal locale: le classi sono quelle
+ * di isspace, isalpha e isdigit nel locale "C".
+ *
+ * È usata dal DFA di Tokenizer::scanToken e dalla versione
+ * scalare di StructuralScanner.
+ */
+namespace CharClass
+{
+	enum Class : std::uint8_t
+	{
+		OTHER, SPACE, NEWLINE, LP, RP, ALPHA, DIGIT, MINUS,
+		CLASSES
+	};
+
+	struct Table
+	{
+		Class classes[256];
+	};
+
+	constexpr Table buildTable()
+	{
+		Table table{};
+		for (int c = 0; c < 256; c++)
+			table.classes[c] = OTHER;
+		table.classes[(unsigned char)' '] = SPACE;
+		for (int c = '\t'; c <= '\r'; c++)
+			table.classes[c] = SPACE;
+		table.classes[(unsigned char)'\n'] = NEWLINE;
+		table.classes[(unsigned char)'('] = LP;
+		table.classes[(unsigned char)')'] = RP;
+		for (int c = 'a'; c <= 'z'; c++)
+			table.classes[c] = ALPHA;
+		for (int c = 'A'; c <= 'Z'; c++)
+			table.classes[c] = ALPHA;
+		for (int c = '0'; c <= '9'; c++)
+			table.classes[c] = DIGIT;
+		table.classes[(unsigned char)'-'] = MINUS;
+		return table;
+	}
+
+	inline constexpr Table table = buildTable();
+
+	inline Class of(char c)
+	{
+		return table.classes[(unsigned char)c];
+	}
+}
+
+#endif
@@ -0,0 +1,431 @@
+#include "ClosureCompiler.h"
+#include "Runtime.h"
+
+/*
+ * FUNZIONI DELLE CLOSURE
+ *
+ * Le varianti di ogni operazione sono generate da template sul
+ * codice operativo, in modo che l'operazione sia nota durante
+ * la compilazione del C++ e la funzione non contenga switch.
+ * I nomi indicano la forma degli operandi: Var (slot), Const
+ * (costante), Expr (closure).
+ */
+namespace
+{
+	inline int readVariable(int slot, ClosureState& state)
+	{
+		if (!state.defined[slot])
+			Runtime::throwUndefinedVariable(state.names[slot]);
+		return state.frame[slot];
+	}
+
+	inline void runBlock(const std::vector<const StmtClosure*>& block, ClosureState& state)
+	{
+		for (const StmtClosure* statement : block)
+			statement->run(statement, state);
+	}
+
+	template <Operator::OpCode op>
+	inline int apply(int left, int right)
+	{
+		if constexpr (op == Operator::PLUS)
+			return left + right;
+		else if constexpr (op == Operator::MINUS)
+			return left - right;
+		else if constexpr (op == Operator::TIMES)
+			return left * right;
+		else
+		{
+			// La divisione per 0 non è ammessa
+			if (right == 0)
+				Runtime::throwDivisionByZero();
+			return left / right;
+		}
+	}
+
+	template <RelOp::OpCode op>
+	inline bool compare(int left, int right)
+	{
+		if constexpr (op == RelOp::GT)
+			return left > right;
+		else if constexpr (op == RelOp::LT)
+			return left < right;
+		else
+			return left == right;
+	}
+
+	/*
+	 * NumExpr
+	 */
+	int evalNumber(const NumClosure* self, ClosureState&)
+	{
+		return self->value;
+	}
+	int evalVariable(const NumClosure* self, ClosureState& state)
+	{
+		return readVariable(self->slot, state);
+	}
+	template <Operator::OpCode op>
+	int evalExprExpr(const NumClosure* self, ClosureState& state)
+	{
+		int left = self->left->eval(self->left, state);
+		return apply<op>(left, self->right->eval(self->right, state));
+	}
+	template <Operator::OpCode op>
+	int evalExprConst(const NumClosure* self, ClosureState& state)
+	{
+		return apply<op>(self->left->eval(self->left, state), self->value);
+	}
+	template <Operator::OpCode op>
+	int evalConstExpr(const NumClosure* self, ClosureState& state)
+	{
+		return apply<op>(self->value, self->right->eval(self->right, state));
+	}
+	template <Operator::OpCode op>
+	int evalVarConst(const NumClosure* self, ClosureState& state)
+	{
+		return apply<op>(readVariable(self->slot, state), self->value);
+	}
+	template <Operator::OpCode op>
+	int evalVarVar(const NumClosure* self, ClosureState& state)
+	{
+		int left = readVariable(self->slot, state);
+		return apply<op>(left, readVariable(self->otherSlot, state));
+	}
+
+	/*
+	 * BoolExpr
+	 */
+	bool evalBoolConst(const BoolClosure* self, ClosureState&)
+	{
+		return self->value != 0;
+	}
+	template <RelOp::OpCode op>
+	bool evalRelExprExpr(const BoolClosure* self, ClosureState& state)
+	{
+		int left = self->numLeft->eval(self->numLeft, state);
+		return compare<op>(left, self->numRight->eval(self->numRight, state));
+	}
+	template <RelOp::OpCode op>
+	bool evalRelExprConst(const BoolClosure* self, ClosureState& state)
+	{
+		return compare<op>(self->numLeft->eval(self->numLeft, state), self->value);
+	}
+	template <RelOp::OpCode op>
+	bool evalRelVarConst(const BoolClosure* self, ClosureState& state)
+	{
+		return compare<op>(readVariable(self->slot, state), self->value);
+	}
+	template <RelOp::OpCode op>
+	bool evalRelVarVar(const BoolClosure* self, ClosureState& state)
+	{
+		int left = readVariable(self->slot, state);
+		return compare<op>(left, readVariable(self->otherSlot, state));
+	}
+	// AND e OR valutano il secondo operando solo se serve
+	bool evalAnd(const BoolClosure* self, ClosureState& state)
+	{
+		return self->left->eval(self->left, state) && self->right->eval(self->right, state);
+	}
+	bool evalOr(const BoolClosure* self, ClosureState& state)
+	{
+		return self->left->eval(self->left, state) || self->right->eval(self->right, state);
+	}
+	bool evalNot(const BoolClosure* self, ClosureState& state)
+	{
+		return !self->left->eval(self->left, state);
+	}
+
+	/*
+	 * Statement
+	 */
+	void runSetConst(const StmtClosure* self, ClosureState& state)
+	{
+		state.frame[self->slot] = self->constant;
+		state.defined[self->slot] = 1;
+	}
+	void runSetExpr(const StmtClosure* self, ClosureState& state)
+	{
+		int value = self->value->eval(self->value, state);
+		state.frame[self->slot] = value;
+		state.defined[self->slot] = 1;
+	}
+	void runInput(const StmtClosure* self, ClosureState& state)
+	{
+		// lancia InputError se il valore non è valido
+		state.frame[self->slot] = Runtime::readInput();
+		state.defined[self->slot] = 1;
+	}
+	void runPrint(const StmtClosure* self, ClosureState& state)
+	{
+		Runtime::print(self->value->eval(self->value, state));
+	}
+	void runIf(const StmtClosure* self, ClosureState& state)
+	{
+		if (self->condition->eval(self->condition, state))
+			runBlock(self->body, state);
+		else
+			runBlock(self->elseBody, state);
+	}
+	void runWhile(const StmtClosure* self, ClosureState& state)
+	{
+		while (self->condition->eval(self->condition, state))
+			runBlock(self->body, state);
+	}
+
+	/*
+	 * Tabelle delle varianti, indicizzate con il codice operativo
+	 */
+	const NumClosure::Function exprExpr[] = {
+		evalExprExpr<Operator::PLUS>, evalExprExpr<Operator::MINUS>,
+		evalExprExpr<Operator::TIMES>, evalExprExpr<Operator::DIV> };
+	const NumClosure::Function exprConst[] = {
+		evalExprConst<Operator::PLUS>, evalExprConst<Operator::MINUS>,
+		evalExprConst<Operator::TIMES>, evalExprConst<Operator::DIV> };
+	const NumClosure::Function constExpr[] = {
+		evalConstExpr<Operator::PLUS>, evalConstExpr<Operator::MINUS>,
+		evalConstExpr<Operator::TIMES>, evalConstExpr<Operator::DIV> };
+	const NumClosure::Function varConst[] = {
+		evalVarConst<Operator::PLUS>, evalVarConst<Operator::MINUS>,
+		evalVarConst<Operator::TIMES>, evalVarConst<Operator::DIV> };
+	const NumClosure::Function varVar[] = {
+		evalVarVar<Operator::PLUS>, evalVarVar<Operator::MINUS>,
+		evalVarVar<Operator::TIMES>, evalVarVar<Operator::DIV> };
+
+	const BoolClosure::Function relExprExpr[] = {
+		evalRelExprExpr<RelOp::GT>, evalRelExprExpr<RelOp::LT>, evalRelExprExpr<RelOp::EQ> };
+	const BoolClosure::Function relExprConst[] = {
+		evalRelExprConst<RelOp::GT>, evalRelExprConst<RelOp::LT>, evalRelExprConst<RelOp::EQ> };
+	const BoolClosure::Function relVarConst[] = {
+		evalRelVarConst<RelOp::GT>, evalRelVarConst<RelOp::LT>, evalRelVarConst<RelOp::EQ> };
+	const BoolClosure::Function relVarVar[] = {
+		evalRelVarVar<RelOp::GT>, evalRelVarVar<RelOp::LT>, evalRelVarVar<RelOp::EQ> };
+
+	bool isConstant(const NumClosure* closure) { return closure->eval == evalNumber; }
+	bool isVariable(const NumClosure* closure) { return closure->eval == evalVariable; }
+}
+
+/**
+ * operator()
+ *
+ * Compila il Block principale nel ClosureProgram ricevuto dal
+ * costruttore.
+ */
+void ClosureCompiler::operator()(Block* program)
+{
+	std::vector<const StmtClosure*> statements = compileBlock(program);
+	closures->setProgram(std::move(statements), symbols->getNames());
+}
+
+const NumClosure* ClosureCompiler::compileNum(NumExpr* expression)
+{
+	expression->accept(this);
+	return numResult;
+}
+
+const BoolClosure* ClosureCompiler::compileBool(BoolExpr* expression)
+{
+	expression->accept(this);
+	return boolResult;
+}
+
+// Gli Statement del Block si accumulano in blockResult, che
+// viene salvato e ripristinato per i Block annidati
+std::vector<const StmtClosure*> ClosureCompiler::compileBlock(Block* block)
+{
+	std::vector<const StmtClosure*> statements;
+	statements.swap(blockResult);
+	block->accept(this);
+	statements.swap(blockResult);
+	return statements;
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * CLOSURECOMPILER PER BLOCK E STATEMENTS
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+void ClosureCompiler::visitBlock(Block* blockNode)
+{
+	for (Statement* stmt : blockNode->getStatements())
+		stmt->accept(this);
+}
+
+void ClosureCompiler::visitIfStmt(IfStmt* ifStmtNode)
+{
+	StmtClosure* closure = closures->makeStmt(runIf);
+	closure->condition = compileBool(ifStmtNode->getCondition());
+	closure->body = compileBlock(ifStmtNode->getBlockIf());
+	closure->elseBody = compileBlock(ifStmtNode->getBlockElse());
+	blockResult.push_back(closure);
+}
+
+void ClosureCompiler::visitWhileStmt(WhileStmt* whileStmtNode)
+{
+	StmtClosure* closure = closures->makeStmt(runWhile);
+	closure->condition = compileBool(whileStmtNode->getCondition());
+	closure->body = compileBlock(whileStmtNode->getBlock());
+	blockResult.push_back(closure);
+}
+
+void ClosureCompiler::visitInputStmt(InputStmt* inputStmtNode)
+{
+	StmtClosure* closure = closures->makeStmt(runInput);
+	closure->slot = inputStmtNode->getVarId()->getSlot();
+	blockResult.push_back(closure);
+}
+
+// Il valore costante viene assegnato senza una closure
+void ClosureCompiler::visitSetStmt(SetStmt* setStmtNode)
+{
+	const NumClosure* value = compileNum(setStmtNode->getNewValue());
+	StmtClosure* closure;
+	if (isConstant(value))
+	{
+		closure = closures->makeStmt(runSetConst);
+		closure->constant = value->value;
+	}
+	else
+	{
+		closure = closures->makeStmt(runSetExpr);
+		closure->value = value;
+	}
+	closure->slot = setStmtNode->getVarId()->getSlot();
+	blockResult.push_back(closure);
+}
+
+void ClosureCompiler::visitPrintStmt(PrintStmt* printStmtNode)
+{
+	StmtClosure* closure = closures->makeStmt(runPrint);
+	closure->value = compileNum(printStmtNode->getPrintValue());
+	blockResult.push_back(closure);
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * CLOSURECOMPILER PER ESPRESSIONI NUMERICHE E BOOLEANE
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * visitOperator
+ *
+ * Sceglie la variante in base alla forma degli operandi: una
+ * variabile o una costante vengono lette dalla closure
+ * dell'Operator, che non chiama quelle dei figli. Le
+ * espressioni con due costanti restano calcolate a runtime,
+ * come negli altri motori, per non anticipare la divisione
+ * per 0.
+ */
+void ClosureCompiler::visitOperator(Operator* operatorNode)
+{
+	const NumClosure* left = compileNum(operatorNode->getLeft());
+	const NumClosure* right = compileNum(operatorNode->getRight());
+	int op = operatorNode->getOp();
+
+	NumClosure* closure;
+	if (isVariable(left) && isConstant(right))
+	{
+		closure = closures->makeNum(varConst[op]);
+		closure->slot = left->slot;
+		closure->value = right->value;
+	}
+	else if (isVariable(left) && isVariable(right))
+	{
+		closure = closures->makeNum(varVar[op]);
+		closure->slot = left->slot;
+		closure->otherSlot = right->slot;
+	}
+	else if (isConstant(right))
+	{
+		closure = closures->makeNum(exprConst[op]);
+		closure->left = left;
+		closure->value = right->value;
+	}
+	else if (isConstant(left))
+	{
+		closure = closures->makeNum(constExpr[op]);
+		closure->value = left->value;
+		closure->right = right;
+	}
+	else
+	{
+		closure = closures->makeNum(exprExpr[op]);
+		closure->left = left;
+		closure->right = right;
+	}
+	numResult = closure;
+}
+
+void ClosureCompiler::visitNumber(Number* numberNode)
+{
+	NumClosure* closure = closures->makeNum(evalNumber);
+	closure->value = numberNode->getValue();
+	numResult = closure;
+}
+
+void ClosureCompiler::visitVariable(Variable* variableNode)
+{
+	NumClosure* closure = closures->makeNum(evalVariable);
+	closure->slot = variableNode->getSlot();
+	numResult = closure;
+}
+
+// Stesse varianti di visitOperator
+void ClosureCompiler::visitRelOp(RelOp* relOpNode)
+{
+	const NumClosure* left = compileNum(relOpNode->getLeft());
+	const NumClosure* right = compileNum(relOpNode->getRight());
+	int op = relOpNode->getOp();
+
+	BoolClosure* closure;
+	if (isVariable(left) && isConstant(right))
+	{
+		closure = closures->makeBool(relVarConst[op]);
+		closure->slot = left->slot;
+		closure->value = right->value;
+	}
+	else if (isVariable(left) && isVariable(right))
+	{
+		closure = closures->makeBool(relVarVar[op]);
+		closure->slot = left->slot;
+		closure->otherSlot = right->slot;
+	}
+	else if (isConstant(right))
+	{
+		closure = closures->makeBool(relExprConst[op]);
+		closure->numLeft = left;
+		closure->value = right->value;
+	}
+	else
+	{
+		closure = closures->makeBool(relExprExpr[op]);
+		closure->numLeft = left;
+		closure->numRight = right;
+	}
+	boolResult = closure;
+}
+
+void ClosureCompiler::visitBoolConst(BoolConst* boolConstNode)
+{
+	BoolClosure* closure = closures->makeBool(evalBoolConst);
+	closure->value = boolConstNode->getValue();
+	boolResult = closure;
+}
+
+void ClosureCompiler::visitBoolOp(BoolOp* boolOpNode)
+{
+	const BoolClosure* left = compileBool(boolOpNode->getLeft());
+	BoolClosure* closure;
+	if (boolOpNode->getOp() == BoolOp::NOT)
+		closure = closures->makeBool(evalNot);
+	else
+	{
+		const BoolClosure* right = compileBool(boolOpNode->getRight());
+		closure = closures->makeBool(boolOpNode->getOp() == BoolOp::AND ? evalAnd : evalOr);
+		closure->right = right;
+	}
+	closure->left = left;
+	boolResult = closure;
+}
@@ -0,0 +1,63 @@
+#ifndef CLOSURE_COMPILER_H
+#define CLOSURE_COMPILER_H
+
+#include <vector>
+
+#include "Visitor.h"
+#include "ClosureProgram.h"
+#include "SymbolTable.h"
+
+/**
+ * ClosureCompiler percorre l'albero sintattico una sola volta
+ * e lo traduce in un albero di closure (ClosureProgram), che
+ * viene poi eseguito senza passare dai visitor.
+ *
+ * Per ogni nodo viene scelta una funzione specializzata sulla
+ * forma dei figli: un Operator, un RelOp o un SetStmt con una
+ * Variable o un Number come operando legge direttamente lo
+ * slot o la costante, senza una closure per il figlio. Gli
+ * altri casi chiamano le closure dei figli, che restituiscono
+ * il valore invece di usare pile come ExecutionVisitor.
+ *
+ * Le variabili devono essere già state risolte da
+ * SymbolResolver; la cortocircuitazione di AND e OR e l'ordine
+ * degli errori sono gli stessi di ExecutionVisitor.
+ */
+class ClosureCompiler : public Visitor
+{
+public:
+	ClosureCompiler(const SymbolTable* st, ClosureProgram* target) :
+		symbols{ st }, closures{ target } {}
+
+	void operator()(Block* program);
+
+	void visitBlock(Block* blockNode) override;
+
+	void visitPrintStmt(PrintStmt* printStmtNode) override;
+	void visitSetStmt(SetStmt* setStmtNode) override;
+	void visitInputStmt(InputStmt* inputStmtNode) override;
+	void visitWhileStmt(WhileStmt* whileStmtNode) override;
+	void visitIfStmt(IfStmt* ifStmtBlock) override;
+
+	void visitOperator(Operator* operatorNode) override;
+	void visitNumber(Number* numberNode) override;
+	void visitVariable(Variable* variableNode) override;
+
+	void visitRelOp(RelOp* relOpNode) override;
+	void visitBoolConst(BoolConst* boolConstNode) override;
+	void visitBoolOp(BoolOp* boolOpNode) override;
+private:
+	const NumClosure* compileNum(NumExpr* expression);
+	const BoolClosure* compileBool(BoolExpr* expression);
+	std::vector<const StmtClosure*> compileBlock(Block* block);
+
+	const SymbolTable* symbols;
+	ClosureProgram* closures;
+
+	// Risultato della visita dell'ultimo nodo
+	const NumClosure* numResult = nullptr;
+	const BoolClosure* boolResult = nullptr;
+	std::vector<const StmtClosure*> blockResult;
+};
+
+#endif
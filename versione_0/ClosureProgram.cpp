@@ -0,0 +1,43 @@
+#include "ClosureProgram.h"
+
+NumClosure* ClosureProgram::makeNum(NumClosure::Function eval)
+{
+	numClosures.emplace_back();
+	numClosures.back().eval = eval;
+	return &numClosures.back();
+}
+
+BoolClosure* ClosureProgram::makeBool(BoolClosure::Function eval)
+{
+	boolClosures.emplace_back();
+	boolClosures.back().eval = eval;
+	return &boolClosures.back();
+}
+
+StmtClosure* ClosureProgram::makeStmt(StmtClosure::Function run)
+{
+	stmtClosures.emplace_back();
+	stmtClosures.back().run = run;
+	return &stmtClosures.back();
+}
+
+void ClosureProgram::setProgram(std::vector<const StmtClosure*> statements, std::vector<std::string> names)
+{
+	program = std::move(statements);
+	variableNames = std::move(names);
+}
+
+/**
+ * run
+ *
+ * Esegue gli Statement del Block principale; tutte le
+ * variabili partono non definite.
+ */
+void ClosureProgram::run() const
+{
+	std::vector<int> frame(variableNames.size(), 0);
+	std::vector<unsigned char> defined(variableNames.size(), 0);
+	ClosureState state{ frame.data(), defined.data(), variableNames.data() };
+	for (const StmtClosure* statement : program)
+		statement->run(statement, state);
+}
@@ -0,0 +1,104 @@
+#ifndef CLOSURE_PROGRAM_H
+#define CLOSURE_PROGRAM_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * Stato dell'esecuzione passato a ogni closure: il frame delle
+ * variabili, la tabella delle variabili definite e i nomi, per
+ * i messaggi di errore.
+ */
+struct ClosureState
+{
+	int* frame;
+	unsigned char* defined;
+	const std::string* names;
+};
+
+/*
+ * Closure generate da ClosureCompiler. Ogni closure è una
+ * funzione scelta durante la compilazione insieme ai dati a
+ * cui è legata: i figli, gli slot delle variabili e le
+ * costanti. Le closure restituiscono direttamente il risultato.
+ *
+ * Per esempio (ADD i 1) diventa una NumClosure la cui funzione
+ * legge lo slot di i e somma la costante, senza chiamare le
+ * closure dei figli.
+ */
+struct NumClosure
+{
+	typedef int (*Function)(const NumClosure* self, ClosureState& state);
+
+	Function eval;
+	const NumClosure* left = nullptr;
+	const NumClosure* right = nullptr;
+	// variabili lette (slot e otherSlot) e costante
+	int slot = 0;
+	int otherSlot = 0;
+	int value = 0;
+};
+
+struct BoolClosure
+{
+	typedef bool (*Function)(const BoolClosure* self, ClosureState& state);
+
+	Function eval;
+	// operandi di BoolOp
+	const BoolClosure* left = nullptr;
+	const BoolClosure* right = nullptr;
+	// operandi di RelOp
+	const NumClosure* numLeft = nullptr;
+	const NumClosure* numRight = nullptr;
+	int slot = 0;
+	int otherSlot = 0;
+	int value = 0;
+};
+
+struct StmtClosure
+{
+	typedef void (*Function)(const StmtClosure* self, ClosureState& state);
+
+	Function run;
+	const BoolClosure* condition = nullptr;
+	const NumClosure* value = nullptr;
+	// Block di IfStmt (body ed elseBody) e di WhileStmt (body)
+	std::vector<const StmtClosure*> body;
+	std::vector<const StmtClosure*> elseBody;
+	int slot = 0;
+	int constant = 0;
+};
+
+/**
+ * Programma compilato da ClosureCompiler: contiene tutte le
+ * closure (in deque, che non spostano gli elementi già
+ * creati), gli Statement del Block principale e i nomi delle
+ * variabili, nell'ordine degli slot.
+ *
+ * run esegue il programma con un frame allocato una sola
+ * volta; gli errori di esecuzione sono gli stessi di
+ * ExecutionVisitor.
+ */
+class ClosureProgram
+{
+public:
+	ClosureProgram() = default;
+	ClosureProgram(const ClosureProgram& other) = delete;
+	ClosureProgram& operator=(const ClosureProgram& other) = delete;
+
+	NumClosure* makeNum(NumClosure::Function eval);
+	BoolClosure* makeBool(BoolClosure::Function eval);
+	StmtClosure* makeStmt(StmtClosure::Function run);
+	void setProgram(std::vector<const StmtClosure*> statements, std::vector<std::string> names);
+
+	void run() const;
+private:
+	std::deque<NumClosure> numClosures;
+	std::deque<BoolClosure> boolClosures;
+	std::deque<StmtClosure> stmtClosures;
+	std::vector<const StmtClosure*> program;
+	std::vector<std::string> variableNames;
+};
+
+#endif
@@ -0,0 +1,301 @@
+#include "CompactAst.h"
+
+#include <cassert>
+
+/**
+ * Svuota tutti i vettori, i NodeRef già restituiti diventano
+ * invalidi.
+ */
+void CompactAst::clearMemory()
+{
+	blockFirst.clear();
+	blockCount.clear();
+	blockItemKind.clear();
+	blockItem.clear();
+	pendingItems.clear();
+
+	ifCondKind.clear();
+	ifCond.clear();
+	ifBlockIf.clear();
+	ifBlockElse.clear();
+	whileCondKind.clear();
+	whileCond.clear();
+	whileBlock.clear();
+	inputVariable.clear();
+	setVariable.clear();
+	setValueKind.clear();
+	setValue.clear();
+	printValueKind.clear();
+	printValue.clear();
+
+	operatorNodes.clear();
+	numberValue.clear();
+	variableName.clear();
+	relOpNodes.clear();
+	boolOpNodes.clear();
+	boolConstValue.clear();
+
+	names.clear();
+	nameIndices.clear();
+}
+
+
+/**
+ * METODI DI COSTRUZIONE
+ *
+ * Per ogni nodo i campi vengono aggiunti in coda ai vettori
+ * del suo tipo, e viene restituito il riferimento al nodo.
+ */
+
+/**
+ * endBlock
+ *
+ * Gli statement di un Block vengono accumulati in pendingItems
+ * mentre il Block è in costruzione, perché nel frattempo il
+ * parsing degli statement può creare altri Block. Alla fine gli
+ * statement vengono copiati in blockItems, uno dopo l'altro.
+ */
+CompactAst::NodeRef CompactAst::endBlock(OpenBlock block)
+{
+	std::uint32_t index = (std::uint32_t)blockFirst.size();
+	blockFirst.push_back((std::uint32_t)blockItem.size());
+	blockCount.push_back((std::uint32_t)(pendingItems.size() - block));
+	for (std::size_t i = block; i < pendingItems.size(); i++)
+	{
+		blockItemKind.push_back(pendingItems[i].kind);
+		blockItem.push_back(pendingItems[i].index);
+	}
+	pendingItems.resize(block);
+	return { BLOCK, index };
+}
+
+CompactAst::NodeRef CompactAst::makeIfStmt(NodeRef c, NodeRef b_if, NodeRef b_else)
+{
+	ifCondKind.push_back(c.kind);
+	ifCond.push_back(c.index);
+	ifBlockIf.push_back(b_if.index);
+	ifBlockElse.push_back(b_else.index);
+	return { IF_STMT, (std::uint32_t)ifCond.size() - 1 };
+}
+CompactAst::NodeRef CompactAst::makeWhileStmt(NodeRef c, NodeRef b)
+{
+	whileCondKind.push_back(c.kind);
+	whileCond.push_back(c.index);
+	whileBlock.push_back(b.index);
+	return { WHILE_STMT, (std::uint32_t)whileCond.size() - 1 };
+}
+CompactAst::NodeRef CompactAst::makeInputStmt(NodeRef var_id)
+{
+	inputVariable.push_back(var_id.index);
+	return { INPUT_STMT, (std::uint32_t)inputVariable.size() - 1 };
+}
+CompactAst::NodeRef CompactAst::makeSetStmt(NodeRef var_id, NodeRef num_expr)
+{
+	setVariable.push_back(var_id.index);
+	setValueKind.push_back(num_expr.kind);
+	setValue.push_back(num_expr.index);
+	return { SET_STMT, (std::uint32_t)setVariable.size() - 1 };
+}
+CompactAst::NodeRef CompactAst::makePrintStmt(NodeRef num_expr)
+{
+	printValueKind.push_back(num_expr.kind);
+	printValue.push_back(num_expr.index);
+	return { PRINT_STMT, (std::uint32_t)printValue.size() - 1 };
+}
+
+CompactAst::NodeRef CompactAst::makeOperator(Operator::OpCode o, NodeRef lop, NodeRef rop)
+{
+	return { OPERATOR, operatorNodes.add(o, lop, rop) };
+}
+CompactAst::NodeRef CompactAst::makeNumber(int v)
+{
+	numberValue.push_back(v);
+	return { NUMBER, (std::uint32_t)numberValue.size() - 1 };
+}
+CompactAst::NodeRef CompactAst::makeVariable(std::string_view var_id)
+{
+	auto found = nameIndices.find(var_id);
+	std::uint32_t name;
+	if (found != nameIndices.end())
+		name = found->second;
+	else
+	{
+		name = (std::uint32_t)names.size();
+		names.emplace_back(var_id);
+		nameIndices.emplace(names.back(), name);
+	}
+	variableName.push_back(name);
+	return { VARIABLE, (std::uint32_t)variableName.size() - 1 };
+}
+
+CompactAst::NodeRef CompactAst::makeRelOp(RelOp::OpCode o, NodeRef lop, NodeRef rop)
+{
+	return { REL_OP, relOpNodes.add(o, lop, rop) };
+}
+CompactAst::NodeRef CompactAst::makeBoolOp(BoolOp::OpCode o, NodeRef lop, NodeRef rop)
+{
+	return { BOOL_OP, boolOpNodes.add(o, lop, rop) };
+}
+CompactAst::NodeRef CompactAst::makeBoolConst(bool v)
+{
+	boolConstValue.push_back(v ? 1 : 0);
+	return { BOOL_CONST, (std::uint32_t)boolConstValue.size() - 1 };
+}
+
+/**
+ * getBlockStatement
+ *
+ * Restituisce l'i-esimo statement del Block.
+ */
+CompactAst::NodeRef CompactAst::getBlockStatement(std::uint32_t block, std::uint32_t i) const
+{
+	std::uint32_t item = blockFirst[block] + i;
+	return { blockItemKind[item], blockItem[item] };
+}
+
+
+/**
+ * METODI DI BinaryNodes
+ */
+std::uint32_t CompactAst::BinaryNodes::add(int o, NodeRef l, NodeRef r)
+{
+	op.push_back((std::uint8_t)o);
+	leftKind.push_back(l.kind);
+	rightKind.push_back(r.kind);
+	left.push_back(l.index);
+	right.push_back(r.index);
+	return (std::uint32_t)op.size() - 1;
+}
+
+std::size_t CompactAst::BinaryNodes::bytesUsed() const
+{
+	return size() * (sizeof(std::uint8_t) + 2 * sizeof(Kind) + 2 * sizeof(std::uint32_t));
+}
+
+void CompactAst::BinaryNodes::clear()
+{
+	op.clear();
+	leftKind.clear();
+	rightKind.clear();
+	left.clear();
+	right.clear();
+}
+
+
+/**
+ * accept
+ *
+ * Il tipo del nodo è un byte del NodeRef: uno switch sceglie
+ * il metodo del visitor, che riceve solo l'indice del nodo.
+ */
+void CompactAst::accept(NodeRef node, CompactVisitor* visitor) const
+{
+	switch (node.kind)
+	{
+	case BLOCK: visitor->visitBlock(node.index); return;
+	case IF_STMT: visitor->visitIfStmt(node.index); return;
+	case WHILE_STMT: visitor->visitWhileStmt(node.index); return;
+	case INPUT_STMT: visitor->visitInputStmt(node.index); return;
+	case SET_STMT: visitor->visitSetStmt(node.index); return;
+	case PRINT_STMT: visitor->visitPrintStmt(node.index); return;
+	case OPERATOR: visitor->visitOperator(node.index); return;
+	case NUMBER: visitor->visitNumber(node.index); return;
+	case VARIABLE: visitor->visitVariable(node.index); return;
+	case REL_OP: visitor->visitRelOp(node.index); return;
+	case BOOL_OP: visitor->visitBoolOp(node.index); return;
+	case BOOL_CONST: visitor->visitBoolConst(node.index); return;
+	default:
+		assert(false && "NodeRef senza tipo");
+		return;
+	}
+}
+
+
+/**
+ * STATISTICHE
+ *
+ * I byte di ogni tipo di nodo sono la somma delle dimensioni
+ * dei suoi campi; gli statement dei Block contano per il
+ * Block, i nomi delle variabili per le Variable.
+ */
+std::size_t CompactAst::countOf(Kind kind) const
+{
+	switch (kind)
+	{
+	case BLOCK: return blockFirst.size();
+	case IF_STMT: return ifCond.size();
+	case WHILE_STMT: return whileCond.size();
+	case INPUT_STMT: return inputVariable.size();
+	case SET_STMT: return setVariable.size();
+	case PRINT_STMT: return printValue.size();
+	case OPERATOR: return operatorNodes.size();
+	case NUMBER: return numberValue.size();
+	case VARIABLE: return variableName.size();
+	case REL_OP: return relOpNodes.size();
+	case BOOL_OP: return boolOpNodes.size();
+	case BOOL_CONST: return boolConstValue.size();
+	default:
+		assert(false && "NodeRef senza tipo");
+		return 0;
+	}
+}
+
+std::size_t CompactAst::bytesOf(Kind kind) const
+{
+	const std::size_t u32 = sizeof(std::uint32_t);
+	switch (kind)
+	{
+	case BLOCK:
+		return countOf(BLOCK) * 2 * u32 + blockItem.size() * (sizeof(Kind) + u32);
+	case IF_STMT: return countOf(IF_STMT) * (sizeof(Kind) + 3 * u32);
+	case WHILE_STMT: return countOf(WHILE_STMT) * (sizeof(Kind) + 2 * u32);
+	case INPUT_STMT: return countOf(INPUT_STMT) * u32;
+	case SET_STMT: return countOf(SET_STMT) * (sizeof(Kind) + 2 * u32);
+	case PRINT_STMT: return countOf(PRINT_STMT) * (sizeof(Kind) + u32);
+	case OPERATOR: return operatorNodes.bytesUsed();
+	case NUMBER: return countOf(NUMBER) * sizeof(std::int32_t);
+	case VARIABLE:
+	{
+		std::size_t bytes = countOf(VARIABLE) * u32;
+		for (const std::string& name : names)
+			bytes += sizeof(std::string) + name.capacity();
+		return bytes;
+	}
+	case REL_OP: return relOpNodes.bytesUsed();
+	case BOOL_OP: return boolOpNodes.bytesUsed();
+	case BOOL_CONST: return countOf(BOOL_CONST) * sizeof(std::uint8_t);
+	default:
+		assert(false && "NodeRef senza tipo");
+		return 0;
+	}
+}
+
+/**
+ * printStatistics
+ *
+ * Stesso formato di NodeManager::printStatistics.
+ */
+void CompactAst::printStatistics(std::ostream& out) const
+{
+	std::size_t totalCount = 0;
+	std::size_t totalBytes = 0;
+	for (int kind = 0; kind < NODE_KINDS; kind++)
+	{
+		std::size_t count = countOf((Kind)kind);
+		std::size_t bytes = bytesOf((Kind)kind);
+		out << "(MEMORY " << kindToStr((Kind)kind) << ": "
+			<< count << " nodes, " << bytes << " bytes )" << std::endl;
+		totalCount += count;
+		totalBytes += bytes;
+	}
+	out << "(MEMORY total: " << totalCount << " nodes, " << totalBytes << " bytes )" << std::endl;
+}
+
+const char* CompactAst::kindToStr(Kind kind)
+{
+	static const char* const kindNames[NODE_KINDS] = {
+		"Block", "IfStmt", "WhileStmt", "InputStmt", "SetStmt", "PrintStmt",
+		"Operator", "Number", "Variable", "RelOp", "BoolOp", "BoolConst"
+	};
+	return kindNames[kind];
+}
@@ -0,0 +1,209 @@
+#ifndef COMPACT_AST_H
+#define COMPACT_AST_H
+
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "NumExpr.h"
+#include "BoolExpr.h"
+#include "CompactVisitor.h"
+
+/**
+ * CompactAst è una rappresentazione compatta dell'albero
+ * sintattico, alternativa ai nodi allocati da NodeManager.
+ *
+ * - Ogni tipo di nodo ha i propri vettori contigui, uno per
+ *   campo (structure of arrays): ad esempio gli IfStmt sono
+ *   i vettori ifCondKind, ifCond, ifBlockIf e ifBlockElse, e
+ *   Operator, RelOp e BoolOp sono BinaryNodes (operatorNodes,
+ *   relOpNodes e boolOpNodes) con i vettori op, leftKind,
+ *   rightKind, left e right.
+ * - Un nodo è identificato da un NodeRef: il tipo del nodo
+ *   (un byte) e l'indice a 32 bit nei vettori del suo tipo.
+ *   Quando il tipo di un figlio è noto (ad esempio i Block di
+ *   IF e WHILE) viene memorizzato solo l'indice.
+ * - Gli statement di un Block sono contigui in blockItemKind e
+ *   blockItem, a partire da blockFirst per blockCount elementi.
+ * - I nomi delle variabili sono memorizzati una sola volta:
+ *   una Variable contiene solo l'indice del suo nome in names.
+ *
+ * CompactAst espone la stessa interfaccia di costruzione di
+ * NodeManager (vedi BasicParser), quindi Parser può generarla
+ * direttamente. I nodi si leggono con i metodi get*, oppure si
+ * visitano con accept e un CompactVisitor; CompactAstAdapter
+ * inoltra le visite ai Visitor dei nodi ordinari.
+ */
+class CompactAst
+{
+public:
+	enum Kind : std::uint8_t
+	{
+		BLOCK, IF_STMT, WHILE_STMT, INPUT_STMT, SET_STMT, PRINT_STMT,
+		OPERATOR, NUMBER, VARIABLE, REL_OP, BOOL_OP, BOOL_CONST,
+		NODE_KINDS, NO_NODE = NODE_KINDS
+	};
+
+	struct NodeRef
+	{
+		Kind kind = NO_NODE;
+		std::uint32_t index = 0;
+
+		bool operator==(const NodeRef& other) const
+		{
+			return kind == other.kind && index == other.index;
+		}
+		bool operator!=(const NodeRef& other) const { return !(*this == other); }
+	};
+
+	// Tipi usati da BasicParser: ogni riferimento è un NodeRef,
+	// un Block in costruzione è la posizione del suo primo
+	// statement nella pila pendingItems
+	typedef NodeRef BlockRef;
+	typedef NodeRef StmtRef;
+	typedef NodeRef NumRef;
+	typedef NodeRef BoolRef;
+	typedef NodeRef VarRef;
+	typedef std::size_t OpenBlock;
+
+	CompactAst() = default;
+	CompactAst(const CompactAst& other) = delete;
+	~CompactAst() = default;
+
+	void clearMemory();
+
+	/*
+	 * COSTRUZIONE
+	 */
+	OpenBlock beginBlock() { return pendingItems.size(); }
+	// gli statement vanno sempre nel Block aperto per ultimo,
+	// quindi non serve sapere quale sia
+	void appendStatement(OpenBlock, NodeRef statement) { pendingItems.push_back(statement); }
+	NodeRef endBlock(OpenBlock block);
+
+	NodeRef makeIfStmt(NodeRef c, NodeRef b_if, NodeRef b_else);
+	NodeRef makeWhileStmt(NodeRef c, NodeRef b);
+	NodeRef makeInputStmt(NodeRef var_id);
+	NodeRef makeSetStmt(NodeRef var_id, NodeRef num_expr);
+	NodeRef makePrintStmt(NodeRef num_expr);
+
+	NodeRef makeOperator(Operator::OpCode o, NodeRef lop, NodeRef rop);
+	NodeRef makeNumber(int v);
+	NodeRef makeVariable(std::string_view var_id);
+
+	NodeRef makeRelOp(RelOp::OpCode o, NodeRef lop, NodeRef rop);
+	NodeRef makeBoolOp(BoolOp::OpCode o, NodeRef lop, NodeRef rop);
+	NodeRef makeBoolConst(bool v);
+
+	/*
+	 * LETTURA
+	 */
+	std::uint32_t getBlockSize(std::uint32_t block) const { return blockCount[block]; }
+	NodeRef getBlockStatement(std::uint32_t block, std::uint32_t i) const;
+
+	NodeRef getIfCondition(std::uint32_t n) const { return { ifCondKind[n], ifCond[n] }; }
+	NodeRef getIfBlockIf(std::uint32_t n) const { return { BLOCK, ifBlockIf[n] }; }
+	NodeRef getIfBlockElse(std::uint32_t n) const { return { BLOCK, ifBlockElse[n] }; }
+	NodeRef getWhileCondition(std::uint32_t n) const { return { whileCondKind[n], whileCond[n] }; }
+	NodeRef getWhileBlock(std::uint32_t n) const { return { BLOCK, whileBlock[n] }; }
+	NodeRef getInputVariable(std::uint32_t n) const { return { VARIABLE, inputVariable[n] }; }
+	NodeRef getSetVariable(std::uint32_t n) const { return { VARIABLE, setVariable[n] }; }
+	NodeRef getSetValue(std::uint32_t n) const { return { setValueKind[n], setValue[n] }; }
+	NodeRef getPrintValue(std::uint32_t n) const { return { printValueKind[n], printValue[n] }; }
+
+	Operator::OpCode getOperatorOp(std::uint32_t n) const { return (Operator::OpCode)operatorNodes.op[n]; }
+	NodeRef getOperatorLeft(std::uint32_t n) const { return operatorNodes.getLeft(n); }
+	NodeRef getOperatorRight(std::uint32_t n) const { return operatorNodes.getRight(n); }
+	int getNumberValue(std::uint32_t n) const { return numberValue[n]; }
+	const std::string& getVariableName(std::uint32_t n) const { return names[variableName[n]]; }
+	// indice del nome di una Variable: variabili con lo stesso
+	// nome hanno lo stesso indice, da 0 a getNameCount() - 1
+	std::uint32_t getVariableIndex(std::uint32_t n) const { return variableName[n]; }
+	const std::string& getName(std::uint32_t name) const { return names[name]; }
+	std::size_t getNameCount() const { return names.size(); }
+
+	RelOp::OpCode getRelOpOp(std::uint32_t n) const { return (RelOp::OpCode)relOpNodes.op[n]; }
+	NodeRef getRelOpLeft(std::uint32_t n) const { return relOpNodes.getLeft(n); }
+	NodeRef getRelOpRight(std::uint32_t n) const { return relOpNodes.getRight(n); }
+	BoolOp::OpCode getBoolOpOp(std::uint32_t n) const { return (BoolOp::OpCode)boolOpNodes.op[n]; }
+	NodeRef getBoolOpLeft(std::uint32_t n) const { return boolOpNodes.getLeft(n); }
+	NodeRef getBoolOpRight(std::uint32_t n) const { return boolOpNodes.getRight(n); }
+	bool getBoolConstValue(std::uint32_t n) const { return boolConstValue[n] != 0; }
+
+	/*
+	 * VISITA
+	 *
+	 * Chiama il metodo di visitor corrispondente al tipo del
+	 * nodo, con l'indice del nodo
+	 */
+	void accept(NodeRef node, CompactVisitor* visitor) const;
+
+	// Stampa numero di nodi e byte occupati per ogni tipo di nodo
+	void printStatistics(std::ostream& out) const;
+
+	static const char* kindToStr(Kind kind);
+private:
+	// Nodi con un codice operativo e due figli di tipo
+	// variabile: Operator, RelOp e BoolOp
+	struct BinaryNodes
+	{
+		std::vector<std::uint8_t> op;
+		std::vector<Kind> leftKind;
+		std::vector<Kind> rightKind;
+		std::vector<std::uint32_t> left;
+		std::vector<std::uint32_t> right;
+
+		std::uint32_t add(int o, NodeRef l, NodeRef r);
+		NodeRef getLeft(std::uint32_t n) const { return { leftKind[n], left[n] }; }
+		NodeRef getRight(std::uint32_t n) const { return { rightKind[n], right[n] }; }
+		std::size_t size() const { return op.size(); }
+		std::size_t bytesUsed() const;
+		void clear();
+	};
+
+	std::size_t countOf(Kind kind) const;
+	std::size_t bytesOf(Kind kind) const;
+
+	// Block: statement contigui in blockItems
+	std::vector<std::uint32_t> blockFirst;
+	std::vector<std::uint32_t> blockCount;
+	std::vector<Kind> blockItemKind;
+	std::vector<std::uint32_t> blockItem;
+	// Statement dei Block non ancora conclusi
+	std::vector<NodeRef> pendingItems;
+
+	// Statement
+	std::vector<Kind> ifCondKind;
+	std::vector<std::uint32_t> ifCond;
+	std::vector<std::uint32_t> ifBlockIf;
+	std::vector<std::uint32_t> ifBlockElse;
+	std::vector<Kind> whileCondKind;
+	std::vector<std::uint32_t> whileCond;
+	std::vector<std::uint32_t> whileBlock;
+	std::vector<std::uint32_t> inputVariable;
+	std::vector<std::uint32_t> setVariable;
+	std::vector<Kind> setValueKind;
+	std::vector<std::uint32_t> setValue;
+	std::vector<Kind> printValueKind;
+	std::vector<std::uint32_t> printValue;
+
+	// Espressioni
+	BinaryNodes operatorNodes;
+	std::vector<std::int32_t> numberValue;
+	std::vector<std::uint32_t> variableName;
+	BinaryNodes relOpNodes;
+	BinaryNodes boolOpNodes;
+	std::vector<std::uint8_t> boolConstValue;
+
+	// Nomi delle variabili, ognuno memorizzato una volta; le
+	// chiavi di nameIndices sono viste sugli elementi di names,
+	// che in una deque non vengono mai spostati
+	std::deque<std::string> names;
+	std::unordered_map<std::string_view, std::uint32_t> nameIndices;
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include "CompactAstAdapter.h"
+
+/**
+ * operator()
+ *
+ * Inserisce i nomi delle variabili nella SymbolTable e
+ * restituisce il programma come Block pigro; root deve essere
+ * un Block.
+ */
+Block* CompactAstAdapter::operator()(CompactAst::NodeRef root)
+{
+	if (root.kind != CompactAst::BLOCK)
+		return nullptr;
+	slots.clear();
+	for (std::uint32_t name = 0; name < ast->getNameCount(); name++)
+		slots.push_back(symbols->intern(ast->getName(name)));
+	return deferBlock(root.index);
+}
+
+/**
+ * load
+ *
+ * Converte gli statement del Block pigro; i Block annidati
+ * restano pigri fino alla loro prima richiesta.
+ */
+void CompactAstAdapter::load(Block* block)
+{
+	auto found = blockIndices.find(block);
+	std::uint32_t index = found->second;
+	blockIndices.erase(found);
+
+	std::vector<Statement*> statements;
+	statements.reserve(ast->getBlockSize(index));
+	for (std::uint32_t i = 0; i < ast->getBlockSize(index); i++)
+		statements.push_back(convertStatement(ast->getBlockStatement(index, i)));
+	block->finishLoad(statements);
+
+	loadedBlocks++;
+}
+
+Block* CompactAstAdapter::deferBlock(std::uint32_t block)
+{
+	Block* result = nm->makeBlock();
+	result->defer(this, nullptr, nullptr);
+	blockIndices.emplace(result, block);
+	return result;
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * COMPACTASTADAPTER COME COMPACTVISITOR
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+ /*
+  * Ogni visita genera i nodi ordinari del nodo visitato (i
+  * Block sono pigri) e li passa al Visitor: visitare di nuovo
+  * lo stesso nodo genera nuovi nodi.
+  */
+void CompactAstAdapter::visitBlock(std::uint32_t block) { deferBlock(block)->accept(visitor); }
+
+void CompactAstAdapter::visitPrintStmt(std::uint32_t printStmt) { convertStatement({ CompactAst::PRINT_STMT, printStmt })->accept(visitor); }
+void CompactAstAdapter::visitSetStmt(std::uint32_t setStmt) { convertStatement({ CompactAst::SET_STMT, setStmt })->accept(visitor); }
+void CompactAstAdapter::visitInputStmt(std::uint32_t inputStmt) { convertStatement({ CompactAst::INPUT_STMT, inputStmt })->accept(visitor); }
+void CompactAstAdapter::visitWhileStmt(std::uint32_t whileStmt) { convertStatement({ CompactAst::WHILE_STMT, whileStmt })->accept(visitor); }
+void CompactAstAdapter::visitIfStmt(std::uint32_t ifStmt) { convertStatement({ CompactAst::IF_STMT, ifStmt })->accept(visitor); }
+
+void CompactAstAdapter::visitOperator(std::uint32_t operatorNode) { convertNumExpr({ CompactAst::OPERATOR, operatorNode })->accept(visitor); }
+void CompactAstAdapter::visitNumber(std::uint32_t number) { convertNumExpr({ CompactAst::NUMBER, number })->accept(visitor); }
+void CompactAstAdapter::visitVariable(std::uint32_t variable) { convertVariable(variable)->accept(visitor); }
+
+void CompactAstAdapter::visitRelOp(std::uint32_t relOp) { convertBoolExpr({ CompactAst::REL_OP, relOp })->accept(visitor); }
+void CompactAstAdapter::visitBoolConst(std::uint32_t boolConst) { convertBoolExpr({ CompactAst::BOOL_CONST, boolConst })->accept(visitor); }
+void CompactAstAdapter::visitBoolOp(std::uint32_t boolOp) { convertBoolExpr({ CompactAst::BOOL_OP, boolOp })->accept(visitor); }
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * CONVERSIONE DEI NODI
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * convertStatement
+ *
+ * Il tipo del nodo stabilisce quali vettori di CompactAst
+ * contengono i suoi campi.
+ */
+Statement* CompactAstAdapter::convertStatement(CompactAst::NodeRef statement)
+{
+	std::uint32_t n = statement.index;
+	switch (statement.kind)
+	{
+	case CompactAst::IF_STMT:
+		return nm->makeIfStmt(convertBoolExpr(ast->getIfCondition(n)),
+			deferBlock(ast->getIfBlockIf(n).index),
+			deferBlock(ast->getIfBlockElse(n).index));
+	case CompactAst::WHILE_STMT:
+		return nm->makeWhileStmt(convertBoolExpr(ast->getWhileCondition(n)),
+			deferBlock(ast->getWhileBlock(n).index));
+	case CompactAst::INPUT_STMT:
+		return nm->makeInputStmt(convertVariable(ast->getInputVariable(n).index));
+	case CompactAst::SET_STMT:
+		return nm->makeSetStmt(convertVariable(ast->getSetVariable(n).index),
+			convertNumExpr(ast->getSetValue(n)));
+	case CompactAst::PRINT_STMT:
+		return nm->makePrintStmt(convertNumExpr(ast->getPrintValue(n)));
+	default:
+		return nullptr;
+	}
+}
+
+NumExpr* CompactAstAdapter::convertNumExpr(CompactAst::NodeRef expression)
+{
+	std::uint32_t n = expression.index;
+	switch (expression.kind)
+	{
+	case CompactAst::OPERATOR:
+		return nm->makeOperator(ast->getOperatorOp(n),
+			convertNumExpr(ast->getOperatorLeft(n)),
+			convertNumExpr(ast->getOperatorRight(n)));
+	case CompactAst::NUMBER:
+		return nm->makeNumber(ast->getNumberValue(n));
+	case CompactAst::VARIABLE:
+		return convertVariable(n);
+	default:
+		return nullptr;
+	}
+}
+
+/**
+ * convertBoolExpr
+ *
+ * Il secondo operando di NOT non esiste (NO_NODE), e diventa
+ * nullptr come nei nodi creati da Parser.
+ */
+BoolExpr* CompactAstAdapter::convertBoolExpr(CompactAst::NodeRef expression)
+{
+	std::uint32_t n = expression.index;
+	switch (expression.kind)
+	{
+	case CompactAst::REL_OP:
+		return nm->makeRelOp(ast->getRelOpOp(n),
+			convertNumExpr(ast->getRelOpLeft(n)),
+			convertNumExpr(ast->getRelOpRight(n)));
+	case CompactAst::BOOL_OP:
+		return nm->makeBoolOp(ast->getBoolOpOp(n),
+			convertBoolExpr(ast->getBoolOpLeft(n)),
+			convertBoolExpr(ast->getBoolOpRight(n)));
+	case CompactAst::BOOL_CONST:
+		return nm->makeBoolConst(ast->getBoolConstValue(n));
+	default:
+		return nullptr;
+	}
+}
+
+/**
+ * convertVariable
+ *
+ * La Variable riceve subito il suo slot, senza SymbolResolver.
+ */
+Variable* CompactAstAdapter::convertVariable(std::uint32_t variable)
+{
+	Variable* result = nm->makeVariable(ast->getVariableName(variable));
+	result->setSlot(slots[ast->getVariableIndex(variable)]);
+	return result;
+}
@@ -0,0 +1,84 @@
+#ifndef COMPACT_AST_ADAPTER_H
+#define COMPACT_AST_ADAPTER_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "Block.h"
+#include "CompactAst.h"
+#include "NodeManager.h"
+#include "SymbolTable.h"
+#include "Visitor.h"
+
+/**
+ * CompactAstAdapter permette di usare i visitor esistenti
+ * (PrintVisitor, ExecutionVisitor, i compilatori, ...) su un
+ * programma memorizzato in un CompactAst.
+ *
+ * I nodi ordinari vengono generati con un NodeManager solo
+ * quando servono, un Block alla volta: operator() restituisce
+ * il Block radice pigro (vedi BlockLoader), e la prima
+ * richiesta dei suoi Statement chiama load, che converte gli
+ * statement del Block e le loro espressioni lasciando pigri i
+ * Block di IF e WHILE. I Block mai eseguiti restano quindi
+ * solo nel CompactAst.
+ *
+ * Come CompactVisitor, l'adattatore inoltra CompactAst::accept
+ * al Visitor impostato con setVisitor: ogni metodo converte il
+ * nodo visitato e chiama il suo accept.
+ *
+ * Le variabili non passano da SymbolResolver: i nomi di
+ * CompactAst vengono inseriti nella SymbolTable nel loro
+ * ordine, quindi lo slot di una Variable è l'indice del suo
+ * nome.
+ */
+class CompactAstAdapter : public CompactVisitor, public BlockLoader
+{
+public:
+	CompactAstAdapter(const CompactAst* compact, NodeManager* manager, SymbolTable* st) :
+		ast{ compact }, nm{ manager }, symbols{ st } {}
+
+	Block* operator()(CompactAst::NodeRef root);
+
+	void load(Block* block) override;
+
+	void setVisitor(Visitor* v) { visitor = v; }
+
+	void visitBlock(std::uint32_t block) override;
+
+	void visitPrintStmt(std::uint32_t printStmt) override;
+	void visitSetStmt(std::uint32_t setStmt) override;
+	void visitInputStmt(std::uint32_t inputStmt) override;
+	void visitWhileStmt(std::uint32_t whileStmt) override;
+	void visitIfStmt(std::uint32_t ifStmt) override;
+
+	void visitOperator(std::uint32_t operatorNode) override;
+	void visitNumber(std::uint32_t number) override;
+	void visitVariable(std::uint32_t variable) override;
+
+	void visitRelOp(std::uint32_t relOp) override;
+	void visitBoolConst(std::uint32_t boolConst) override;
+	void visitBoolOp(std::uint32_t boolOp) override;
+
+	// Numero di Block convertiti da load
+	std::size_t getLoadedBlocks() const { return loadedBlocks; }
+private:
+	Block* deferBlock(std::uint32_t block);
+	Statement* convertStatement(CompactAst::NodeRef statement);
+	NumExpr* convertNumExpr(CompactAst::NodeRef expression);
+	BoolExpr* convertBoolExpr(CompactAst::NodeRef expression);
+	Variable* convertVariable(std::uint32_t variable);
+
+	const CompactAst* ast;
+	NodeManager* nm;
+	SymbolTable* symbols;
+	Visitor* visitor = nullptr;
+	// indice in CompactAst di ogni Block pigro
+	std::unordered_map<const Block*, std::uint32_t> blockIndices;
+	// slot nella SymbolTable di ogni nome di CompactAst
+	std::vector<int> slots;
+	std::size_t loadedBlocks = 0;
+};
+
+#endif
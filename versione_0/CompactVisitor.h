@@ -0,0 +1,33 @@
+#ifndef COMPACT_VISITOR_H
+#define COMPACT_VISITOR_H
+
+#include <cstdint>
+
+/**
+ * CompactVisitor è l'analogo di Visitor per CompactAst: ogni
+ * metodo riceve l'indice del nodo nei vettori del suo tipo,
+ * da leggere con i metodi get* di CompactAst, invece di un
+ * puntatore a un nodo. CompactAst::accept sceglie il metodo
+ * in base al tipo del NodeRef.
+ */
+class CompactVisitor
+{
+public:
+	virtual void visitBlock(std::uint32_t block) = 0;
+
+	virtual void visitPrintStmt(std::uint32_t printStmt) = 0;
+	virtual void visitSetStmt(std::uint32_t setStmt) = 0;
+	virtual void visitInputStmt(std::uint32_t inputStmt) = 0;
+	virtual void visitWhileStmt(std::uint32_t whileStmt) = 0;
+	virtual void visitIfStmt(std::uint32_t ifStmt) = 0;
+
+	virtual void visitOperator(std::uint32_t operatorNode) = 0;
+	virtual void visitNumber(std::uint32_t number) = 0;
+	virtual void visitVariable(std::uint32_t variable) = 0;
+
+	virtual void visitRelOp(std::uint32_t relOp) = 0;
+	virtual void visitBoolConst(std::uint32_t boolConst) = 0;
+	virtual void visitBoolOp(std::uint32_t boolOp) = 0;
+};
+
+#endif
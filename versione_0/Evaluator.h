@@ -0,0 +1,26 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "NumExpr.h"
+#include "BoolExpr.h"
+
+/**
+ * Evaluator è l'analogo di Visitor per le espressioni, ma
+ * ogni metodo restituisce il valore del nodo: il risultato
+ * passa per il valore di ritorno (in un registro) invece che
+ * per una pila. I nodi chiamano il metodo giusto con
+ * NumExpr::eval e BoolExpr::eval.
+ */
+class Evaluator
+{
+public:
+	virtual int evalOperator(Operator* operatorNode) = 0;
+	virtual int evalNumber(Number* numberNode) = 0;
+	virtual int evalVariable(Variable* variableNode) = 0;
+
+	virtual bool evalRelOp(RelOp* relOpNode) = 0;
+	virtual bool evalBoolConst(BoolConst* boolConstNode) = 0;
+	virtual bool evalBoolOp(BoolOp* boolOpNode) = 0;
+};
+
+#endif
@@ -1,5 +1,5 @@
 #ifndef EXCEPTIONS_H
-#define EXEPTIONS_H
+#define EXCEPTIONS_H
 
 #include <stdexcept>
 #include <string>
@@ -13,12 +13,12 @@
  * 
  * ES: (WHILE (LT i 10), (ADD i 1))
  *                     ^!!
- *  un errore perch la virgola non fa parte dei simboli terminali
+ * è un errore perché la virgola non fa parte dei simboli terminali
  * della grammatica
  * 
  * ES: (WHILE (LT i 10) (AD i))
  *                       ^!!
- *  un errore perch AD non  uno statement definito dal
+ * è un errore perché AD non è uno statement definito dal
  * linguaggio
  */
 struct LexicalError : std::runtime_error
@@ -35,17 +35,17 @@ struct LexicalError : std::runtime_error
  * 
  * ES: (WHILE (LT i 10) (SUM a 1) (SUB b 1))
  *                                ^!!
- *  un errore di sintassi perch WHILE ha ricevuto un blocco
+ * è un errore di sintassi perché WHILE ha ricevuto un blocco
  * che non si aspettava
  * 
  * ES: (WHILE (LT INPUT 10))
  *                ^!!
- *  un errore di sintassi perch input  una parola chiave, mentre
+ * è un errore di sintassi perché input è una parola chiave, mentre
  * WHILE si aspettava un'espressione booleana
  * 
  * ES: (WHILE (ADD a 1) (SUB a 1))
  *             ^!!
- *  un errore di sintassi perch WHILE si aspettava un'espressione
+ * è un errore di sintassi perché WHILE si aspettava un'espressione
  * booleana e non una numerica
  */
 struct SyntaxError : std::runtime_error
@@ -61,7 +61,7 @@ struct SyntaxError : std::runtime_error
  *
  * ES: (PRINT a)
  *            ^!!
- *  un errore di sintassi perch a non  stata definita da SET o INPUT
+ * è un errore di sintassi perché a non è stata definita da SET o INPUT
  */
 struct UndefinedReferenceError : std::runtime_error
 {
@@ -76,7 +76,7 @@ struct UndefinedReferenceError : std::runtime_error
  *
  * ES: (PRINT (DIV 10 0))
  *                    ^!!
- *  un errore matematico perch la divisione per 0 non  un'operazione
+ * è un errore matematico perché la divisione per 0 non è un'operazione
  * lecita
  */
 struct MathError : std::runtime_error
@@ -93,8 +93,8 @@ struct MathError : std::runtime_error
  * ES: (INPUT a)
  * > 17a
  *     ^!!
- *  un errore di input perch il carattere 'a' fornito in input non 
- * una cifra e non pu essere convertito in un intero
+ * è un errore di input perché il carattere 'a' fornito in input non è
+ * una cifra e non può essere convertito in un intero
  */
 struct InputError : std::runtime_error
 {
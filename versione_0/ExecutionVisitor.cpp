@@ -4,6 +4,7 @@
 #include "NumExpr.h"
 #include "BoolExpr.h"
 #include "Exceptions.h"
+#include "Runtime.h"
 
 #include <iostream>
 #include <string>
@@ -24,10 +25,17 @@
 void ExecutionVisitor::visitBlock(Block* blockNode)
 {
 	//std::cout << "EXE: Executing Block " << blockNode << " that contains " << blockNode->getStatements().size() << " Statements:" << std::endl;
-	for (Statement* stmt : blockNode->getStatements())
+	const std::vector<Statement*>& statements = blockNode->getStatements();
+	// un Block pigro appena analizzato può avere nuove variabili
+	if (frame.size() < symbols->size())
+	{
+		frame.resize(symbols->size(), 0);
+		defined.resize(symbols->size(), 0);
+	}
+	for (Statement* stmt : statements)
 	{
 		//std::cout << "EXE: Executing Statement from Block..." << std::endl;
-		stmt->accept(this);
+		execute(stmt);
 	}
 }
 
@@ -43,17 +51,13 @@ void ExecutionVisitor::visitIfStmt(IfStmt* ifStmtNode)
 {
 	////std::cout << "EXE: Begin IF-Statement" << std::endl;
 	// valutazione della condizione
-	ifStmtNode->getCondition()->accept(this);
-
-	// il risultato dovrebbe essere in cima alla pila
-	bool condition = boolStack.back();
-	boolStack.pop_back();
+	bool condition = evalBool(ifStmtNode->getCondition());
 
 	// eseguo il blocco corrispondente
 	if (condition)
-		ifStmtNode->getBlockIf()->accept(this);
+		visitBlock(ifStmtNode->getBlockIf());
 	else
-		ifStmtNode->getBlockElse()->accept(this);
+		visitBlock(ifStmtNode->getBlockElse());
 }
 
 /**
@@ -61,9 +65,9 @@ void ExecutionVisitor::visitIfStmt(IfStmt* ifStmtNode)
  *
  * Per eseguire un while-statement bisogna:
  * - eseguire il confronto specificato
- * - se la condizione  vera eseguire il blocco e ripetere
+ * - se la condizione è vera eseguire il blocco e ripetere
  *   al termine dell'esecuzione
- * - se la condizione  falsa non fare niente
+ * - se la condizione è falsa non fare niente
  */
 void ExecutionVisitor::visitWhileStmt(WhileStmt* whileStmtNode)
 {
@@ -73,15 +77,11 @@ void ExecutionVisitor::visitWhileStmt(WhileStmt* whileStmtNode)
 		//std::cout << "EXE: New WHILE cycle..." << std::endl;
 		//std::cout << "EXE: Checking WHILE condition" << std::endl;
 		// valutazione della condizione
-		whileStmtNode->getCondition()->accept(this);
-
-		// il risultato dovrebbe essere in cima alla pila
-		bool condition = boolStack.back();
-		boolStack.pop_back();
+		bool condition = evalBool(whileStmtNode->getCondition());
 
-		// se la condizione  vera eseguo il blocco, altrimenti esco
+		// se la condizione è vera eseguo il blocco, altrimenti esco
 		if (condition)
-			whileStmtNode->getBlock()->accept(this);
+			visitBlock(whileStmtNode->getBlock());
 		else
 			return;
 	}
@@ -99,30 +99,15 @@ void ExecutionVisitor::visitWhileStmt(WhileStmt* whileStmtNode)
 void ExecutionVisitor::visitInputStmt(InputStmt* inputStmtNode)
 {
 	//std::cout << "EXE: Begin INPUT-Statement on Variable " << inputStmtNode->getVarId()->getName() << std::endl;
-	// input da tastiera
-	std::string inputString;
-	std::cin >> inputString;
-	int inputValue;
-	try
-	{
-		inputValue = std::stoi(inputString);
-	}
-	catch (std::exception e)
-	{
-		std::stringstream errorMessage;
-		errorMessage << inputString;
-		errorMessage << " is not a valid variable value, must be an integer number";
-		throw InputError(errorMessage.str());
-	}
-
-
+	// input da tastiera, lancia InputError se il valore non è valido
+	int inputValue = Runtime::readInput();
 
-	// usando una std::map non serve controllare se la variabile
-	// esiste, l'operatore [] fa gi quello che mi serve
-	std::string variableName = inputStmtNode->getVarId()->getName();
-	variables[variableName] = inputValue;
+	// lo slot della variabile esiste già nel frame, basta
+	// segnarla come definita
+	int slot = inputStmtNode->getVarId()->getSlot();
+	frame[slot] = inputValue;
+	defined[slot] = 1;
 
-	//std::cout << "EXE: Variable " << variableName << " has been set to " << variables[variableName] << std::endl;
 }
 
 /**
@@ -138,18 +123,14 @@ void ExecutionVisitor::visitSetStmt(SetStmt* setStmtNode)
 {
 	//std::cout << "EXE: Begin SET-Statement on Variable " << setStmtNode->getVarId()->getName() << std::endl;
 	// calcolo del nuovo valore
-	setStmtNode->getNewValue()->accept(this);
+	int newValue = evalNum(setStmtNode->getNewValue());
 
-	// il risultato dovrebbe essere in cima alla pila
-	int newValue = intStack.back();
-	intStack.pop_back();
+	// lo slot della variabile esiste già nel frame, basta
+	// segnarla come definita
+	int slot = setStmtNode->getVarId()->getSlot();
+	frame[slot] = newValue;
+	defined[slot] = 1;
 
-	// usando una std::map non serve controllare se la variabile
-	// esiste, l'operatore [] fa gi quello che mi serve
-	std::string variableName = setStmtNode->getVarId()->getName();
-	variables[variableName] = newValue;
-
-	//std::cout << "EXE: Variable " << variableName << " has been set to " << variables[variableName] << std::endl;
 }
 
 /**
@@ -164,13 +145,10 @@ void ExecutionVisitor::visitPrintStmt(PrintStmt* printStmtNode)
 {
 	//std::cout << "EXE: Begin PRINT-Statement" << std::endl;
 	// calcolo del valore da stampare
-	printStmtNode->getPrintValue()->accept(this);
-	// il risultato dovrebbe essere in cima alla pila
-	int printValue = intStack.back();
-	intStack.pop_back();
+	int printValue = evalNum(printStmtNode->getPrintValue());
 
 	// stampa del valore
-	std::cout << printValue << std::endl;
+	Runtime::print(printValue);
 }
 
 
@@ -179,311 +157,144 @@ void ExecutionVisitor::visitPrintStmt(PrintStmt* printStmtNode)
  * EXECUTIONVISITOR PER ESPRESSIONI NUMERICHE E BOOLEANE
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+ /*
+  * Le visite delle espressioni servono solo a chi usa
+  * ExecutionVisitor come Visitor generico: valutano il nodo
+  * e ne conservano il risultato, letto con getNumResult e
+  * getBoolResult. L'esecuzione usa direttamente evalNum e
+  * evalBool.
+  */
+void ExecutionVisitor::visitOperator(Operator* operatorNode) { numResult = evalOperator(operatorNode); }
+void ExecutionVisitor::visitNumber(Number* numberNode) { numResult = evalNumber(numberNode); }
+void ExecutionVisitor::visitVariable(Variable* variableNode) { numResult = evalVariable(variableNode); }
+void ExecutionVisitor::visitRelOp(RelOp* relOpNode) { boolResult = evalRelOp(relOpNode); }
+void ExecutionVisitor::visitBoolConst(BoolConst* boolConstNode) { boolResult = evalBoolConst(boolConstNode); }
+void ExecutionVisitor::visitBoolOp(BoolOp* boolOpNode) { boolResult = evalBoolOp(boolOpNode); }
+
  /**
   * ExecutionVisitor PER OPERATORI NUMERICI
   *
-  * Per eseguire (valutare) un'operazione aritmetica tra due espressioni
+  * Per valutare un'operazione aritmetica tra due espressioni
   * numeriche bisogna:
-  * - eseguire (valutare) la prima espressione e scriverla sulla pila
-  * - eseguire (valutare) la seconda espressione e scriverla sulla pila
-  * - leggere gli operatori dalla pila e eseguire l'operazione specificata
-	  sugli operatori
-  * - scrivere il risultato sulla pila perch sia accessibile
-  *   agli altri visitor
+  * - valutare la prima espressione
+  * - valutare la seconda espressione
+  * - eseguire l'operazione specificata sugli operandi e
+  *   restituire il risultato
   *
-  * Se l'operazione  matematicamente illegale, lancia un MathError
+  * Il primo operando viene valutato prima del secondo, per
+  * segnalare gli errori sempre nello stesso ordine.
+  * Se l'operazione è matematicamente illegale, lancia un MathError
   */
-void ExecutionVisitor::visitOperator(Operator* operatorNode)
+int ExecutionVisitor::evalOperator(Operator* operatorNode)
 {
-	//std::cout << "EXE: Begin Operation between NumExpr operands" << std::endl;
-	// calcolo degli operatori
-	operatorNode->getLeft()->accept(this);
-	operatorNode->getRight()->accept(this);
+	int operandLeft = evalNum(operatorNode->getLeft());
+	int operandRight = evalNum(operatorNode->getRight());
 
-	// lettura degli operatori dalla pila
-	int operandRight = intStack.back();
-	intStack.pop_back();
-	int operandLeft = intStack.back();
-	intStack.pop_back();
-
-	//std::cout << "EXE: Operands of " << Operator::opCodeToStr(operatorNode->getOp()) << " are " << operandLeft << " and " << operandRight << std::endl;
-	//std::cout << "EXE: Numbers stack after popping operands of " << Operator::opCodeToStr(operatorNode->getOp()) << " has " << boolStack.size() << " elements:";
-	//for (int x : boolStack)
-	//	std::cout << x << " ";
-	//std::cout << std::endl;
-
-	// calcolo dell'operazione e scrittura sulla pila
 	switch (operatorNode->getOp())
 	{
 	case Operator::PLUS:
-		intStack.push_back(operandLeft + operandRight);
-		return;
+		return operandLeft + operandRight;
 	case Operator::MINUS:
-		intStack.push_back(operandLeft - operandRight);
-		return;
+		return operandLeft - operandRight;
 	case Operator::TIMES:
-		intStack.push_back(operandLeft * operandRight);
-		return;
-	case Operator::DIV:
-		// La divisione per 0 non  ammessa
+		return operandLeft * operandRight;
+	default:
+		// La divisione per 0 non è ammessa
 		if (operandRight == 0)
-		{
-			throw MathError("Division by 0.");
-		}
-		intStack.push_back(operandLeft / operandRight);
-		return;
+			Runtime::throwDivisionByZero();
+		return operandLeft / operandRight;
 	}
 }
 
 /**
  * ExecutionVisitor PER COSTANTI NUMERICHE
  *
- * Per eseguire (valutare) costanti numeriche basta scrivere sulla
- * pila il valore numerico della costante.
+ * Il valore di una costante numerica è il suo valore.
  */
-void ExecutionVisitor::visitNumber(Number* numberNode)
+int ExecutionVisitor::evalNumber(Number* numberNode)
 {
-	//std::cout << "EXE: Number eval started" << std::endl;
-	intStack.push_back(numberNode->getValue());
-	//std::cout << "EXE: Numbers stack after Number insertion has " << intStack.size() << " elements:";
-	//for (int x : intStack)
-	//	std::cout << x << "; ";
-	//std::cout << std::endl;
+	return numberNode->getValue();
 }
 
 /**
  * ExecutionVisitor PER VARIABILI
  *
- * Per eseguire (valutare) variabili basta scrivere sulla
- * pila il valore della variabile.
+ * Il valore di una variabile è quello del suo slot nel frame.
  *
- * Se la variabile non  mai stata inizializzata e non  presente
- * nella std::map variables, lancia un UndefinedReferenceError.
+ * Se la variabile non è mai stata inizializzata (il suo slot
+ * non è segnato in defined), lancia un UndefinedReferenceError.
  */
-void ExecutionVisitor::visitVariable(Variable* variableNode)
+int ExecutionVisitor::evalVariable(Variable* variableNode)
 {
-	//std::cout << "EXE: Variable eval started (" << variableNode->getName() << ")" << std::endl;
-
-	if (variables.find(variableNode->getName()) == variables.end())
-	{
-		std::stringstream errorMessage{};
-		errorMessage << "Undefined variable ";
-		errorMessage << variableNode->getName();
-		throw UndefinedReferenceError(errorMessage.str());
-	}
-	//std::cout << "EXE: variables.end() OK" << std::endl;
-
-	intStack.push_back(variables[variableNode->getName()]);
-
-	//std::cout << "EXE: Numbers stack after Variable insertion has " << intStack.size() << " elements:";
-	//for (int x : intStack)
-	//	std::cout << x << "; ";
-	//std::cout << std::endl;
+	int slot = variableNode->getSlot();
+	if (!defined[slot])
+		Runtime::throwUndefinedVariable(variableNode->getName());
+	return frame[slot];
 }
 
 /**
  * ExecutionVisitor PER OPERATORI RELAZIONALI
  *
- * Per eseguire (valutare) un'operazione relazionale tra due espressioni
- * numeriche bisogna:
- * - eseguire (valutare) la prima espressione e scriverla sulla pila
- * - eseguire (valutare) la seconda espressione e scriverla sulla pila
- * - leggere gli operatori dalla pila e eseguire l'operazione specificata
-	 sugli operatori
- * - scrivere il risultato sulla pila perch sia accessibile
- *   agli altri visitor
+ * Per valutare un'operazione relazionale tra due espressioni
+ * numeriche bisogna valutare le due espressioni, in ordine, e
+ * restituire il risultato del confronto.
  */
-void ExecutionVisitor::visitRelOp(RelOp* relOpNode)
+bool ExecutionVisitor::evalRelOp(RelOp* relOpNode)
 {
-	//std::cout << "EXE: Begin RelOp between NumExpr operands" << std::endl;
-	// calcolo degli operatori
-
-	//std::cout << "EXE: Numbers stack before operand eval has " << intStack.size() << " elements:";
-	//for (int x : intStack)
-	//	std::cout << x << "; ";
-	//std::cout << std::endl;
-
-	relOpNode->getLeft()->accept(this);
-	relOpNode->getRight()->accept(this);
-
-	//std::cout << "EXE: Numbers stack after operands eval has " << intStack.size() << " elements:";
-	//for (int x : intStack)
-	//	std::cout << x << "; ";
-	//std::cout << std::endl;
-
-	// lettura degli operatori dalla pila
-	int operandRight = intStack.back();
-	intStack.pop_back();
-	int operandLeft = intStack.back();
-	intStack.pop_back();
-
-	//std::cout << "!!!EXE: Operands of " << RelOp::opCodeToStr(relOpNode->getOp()) << " are " << operandLeft << " and " << operandRight << std::endl;
-	//std::cout << "EXE: Numbers stack after popping operands of " << RelOp::opCodeToStr(relOpNode->getOp()) << " has " << intStack.size() << " elements: ";
-	//for (int x : intStack)
-	//	std::cout << x << "; ";
-	//std::cout << std::endl;
-	//std::cout << "EXE: Bool stack before insertion has " << boolStack.size() << " elements: ";
-	//for (int x : boolStack)
-	//	std::cout << x << " ";
-	//std::cout << std::endl;
+	int operandLeft = evalNum(relOpNode->getLeft());
+	int operandRight = evalNum(relOpNode->getRight());
 
-	// calcolo dell'operazione e scrittura sulla pila
 	switch (relOpNode->getOp())
 	{
 	case RelOp::EQ:
-		boolStack.push_back(operandLeft == operandRight);
-		//std::cout << "EXE: Bool stack after insertion has " << boolStack.size() << " elements: ";
-		//for (int x : boolStack)
-		//	std::cout << x << " ";
-		//std::cout << std::endl;
-		return;
+		return operandLeft == operandRight;
 	case RelOp::GT:
-		boolStack.push_back(operandLeft > operandRight);
-		//std::cout << "EXE: Bool stack after insertion has " << boolStack.size() << " elements: ";
-		//for (int x : boolStack)
-		//	std::cout << x << " ";
-		//std::cout << std::endl;
-		return;
-	case RelOp::LT:
-		boolStack.push_back(operandLeft < operandRight);
-		//std::cout << "EXE: Bool stack after insertion has " << boolStack.size() << " elements: ";
-		//for (int x : boolStack)
-		//	std::cout << x << " ";
-		//std::cout << std::endl;
-		return;
+		return operandLeft > operandRight;
+	default:
+		return operandLeft < operandRight;
 	}
 }
 
 /**
  * ExecutionVisitor PER COSTANTI BOOLEANE
  *
- * Per eseguire (valutare) costanti numeriche basta scrivere sulla
- * pila il valore numerico della costante
-  */
-void ExecutionVisitor::visitBoolConst(BoolConst* boolConstNode)
+ * Il valore di una costante booleana è il suo valore.
+ */
+bool ExecutionVisitor::evalBoolConst(BoolConst* boolConstNode)
 {
-	boolStack.push_back(boolConstNode->getValue());
+	return boolConstNode->getValue();
 }
 
 /**
  * ExecutionVisitor PER OPERATORI BOOLEANI
  *
- * Per eseguire (valutare) un'operazione booleana tra due espressioni
- * booleane bisogna:
- * - eseguire (valutare) la prima espressione e scriverla sulla pila
- * - se l'operazione  un NOT, scrivere il risultato sulla pila e uscire
- * - se l'operatore  un AND, se la prima espressione  falsa, esci
- *   senza modificare la pila (cortocircuitazione)
- * - se l'operatore  un OR, se la prima espressione  vera, uscire
- *   senza modificare la pila (cortocircuitazione)
- * - eseguire (valutare) la seconda espressione e scriverla sulla pila
- * 
- * CORTOCIRCUITAZIONE
- * 
- * Gli operatori AND e NOT sono cortocircuitati, quindi:
- * Per l'operazione (AND a b)
- *   - se a  falsa, l'intera operazione  falsa, ovvero il risultato
- *     dell'operazione  il risultato di a, non serve rimuovere o aggiungere
- *     nulla alla pila.
- *   - se a  vera, allora il risultato dell'operazione  il risultato di b,
- *     una volta calcolato b non serve rimuovere o aggiungere nulla alla pila.
- * Un ragionamento analogo si pu fare per OR.
+ * Per valutare un'operazione booleana bisogna valutare il
+ * primo operando e:
+ * - se l'operazione è un NOT, restituirne la negazione
+ * - se l'operatore è un AND e il primo operando è falso,
+ *   restituire false senza valutare il secondo
+ *   (cortocircuitazione)
+ * - se l'operatore è un OR e il primo operando è vero,
+ *   restituire true senza valutare il secondo
+ *   (cortocircuitazione)
+ * - altrimenti il risultato è quello del secondo operando
  */
-
-void ExecutionVisitor::visitBoolOp(BoolOp* boolOpNode)
-{
-	// Per ogni operatore si valuta il primo operando
-	boolOpNode->getLeft()->accept(this);
-	bool opLeft = boolStack.back();
-
-	// Se l'operazione  un NOT basta il primo operatore
-	if (boolOpNode->getOp() == BoolOp::NOT)
-	{
-		boolStack.pop_back();
-		boolStack.push_back(!opLeft);
-		return;
-	}
-	// Se l'operatore  un AND si valuta il primo operando
-	// per la cortocircuitazione
-	if (boolOpNode->getOp() == BoolOp::AND)
-	{
-		//std::cout << "EXE: AND Detected!" << std::endl;
-		if (!opLeft)
-		{
-			//std::cout << "EXE: SC AND!! First operand was " << opLeft << std::endl;
-			return;
-		}
-		boolStack.pop_back();
-		//std::cout << "EXE: First operand was " << opLeft << ", need to check second operand" << std::endl;
-	}
-	// Se l'operatore  un OR si valuta il primo operando
-	// per la cortocircuitazione
-	if (boolOpNode->getOp() == BoolOp::OR)
-	{
-		//std::cout << "EXE: OR Detected!" << std::endl;
-		if (opLeft)
-		{
-			//std::cout << "EXE: SC OR!! First operand was " << opLeft << std::endl;
-			return;
-		}
-		boolStack.pop_back();
-	}
-
-	// Il risultato  determinato dal secondo operatore,
-	// si valuta e basta, cos rimane nella pila
-	boolOpNode->getRight()->accept(this);
-	//std::cout << "EXE: Second operand was " << boolStack.back() << std::endl;
-	return;
-}
-/*
-void ExecutionVisitor::visitBoolOp(BoolOp* boolOpNode)
+bool ExecutionVisitor::evalBoolOp(BoolOp* boolOpNode)
 {
-	//std::cout << "EXE: Begin BoolOp between BoolExpr operands" << std::endl;
-
-	// se l'operazione  un not si usa solo un operatore
-	if (boolOpNode->getOp() == BoolOp::NOT)
-	{
-		//std::cout << "EXE: NOT detected" << std::endl;
-		//std::cout << "EXE: Bool stack before calculating NOT argument is " << boolStack.size() << " elements:";
-		//for (int x : boolStack)
-		//	std::cout << x << " ";
-		//std::cout << std::endl;
-		// calcolo dell'operatore
-		boolOpNode->getLeft()->accept(this);
-		bool op = boolStack.back();
-		//std::cout << "EXE: Bool stack after calculating NOT argument is " << boolStack.size() << " elements:";
-		//for (int x : boolStack)
-		//	std::cout << x << " ";
-		//std::cout << std::endl;
-		boolStack.pop_back();
-		boolStack.push_back(!op);
-		//std::cout << "EXE: Bool stack after calculating NOT result is " << boolStack.size() << " elements:";
-		//for (int x : boolStack)
-		//	std::cout << x << " ";
-		//std::cout << std::endl;
-		return;
-	}
-
-	// per le operazioni di and e or
-	// calcolo degli operatori
-	boolOpNode->getLeft()->accept(this);
-	boolOpNode->getRight()->accept(this);
+	bool opLeft = evalBool(boolOpNode->getLeft());
 
-	// lettura degli operatori dalla pila
-	bool operatorRight = boolStack.back();
-	boolStack.pop_back();
-	bool operatorLeft = boolStack.back();
-	boolStack.pop_back();
-
-	// calcolo dell'operazione e scrittura sulla pila
 	switch (boolOpNode->getOp())
 	{
+	case BoolOp::NOT:
+		return !opLeft;
 	case BoolOp::AND:
-		boolStack.push_back(operatorLeft && operatorRight);
-		return;
-	case BoolOp::OR:
-		boolStack.push_back(operatorLeft || operatorRight);
-		return;
+		if (!opLeft)
+			return false;
+		break;
+	default:
+		if (opLeft)
+			return true;
+		break;
 	}
+	return evalBool(boolOpNode->getRight());
 }
-*/
\ No newline at end of file
@@ -1,21 +1,39 @@
 #ifndef EXECUTION_VISITOR_H
 #define EXECUTION_VISITOR_H
 
+#include <vector>
+
 #include "Visitor.h"
+#include "Evaluator.h"
+#include "SymbolTable.h"
 
 /**
  * ExecutionVisitor si occupa di eseguire gli statement e
  * valutare le espressioni numeriche e booleane.
- * La classe possiede come attributi:
- * - Tre buffer per memorizzare i risutlati delle operazioni
- *   numeriche e booleane e i nomi di variabili
- * - Una mappa che contiene le variabili definite e il loro
- *   valore
+ * Gli statement sono eseguiti come Visitor, mentre le
+ * espressioni sono valutate come Evaluator: evalNum e evalBool
+ * restituiscono il valore invece di scriverlo su una pila.
+ * La classe possiede come attributo il frame delle variabili:
+ * un intero per ogni slot della SymbolTable, più una tabella
+ * che indica quali variabili sono state definite.
+ *
+ * evalNum, evalBool ed execute scelgono il metodo con uno
+ * switch sul kind del nodo e uno static_cast, invece di
+ * passare da accept ed eval: la classe è final, quindi i
+ * metodi chiamati non sono virtuali e quelli più piccoli
+ * (evalNumber, evalBoolConst, ...) vengono espansi inline.
+ *
+ * Le variabili devono essere già state risolte da
+ * SymbolResolver. I Block pigri (vedi LazyLoader) possono
+ * aggiungere variabili alla SymbolTable durante l'esecuzione:
+ * il frame cresce quando inizia l'esecuzione di un Block.
  */
-class ExecutionVisitor : public Visitor
+class ExecutionVisitor final : public Visitor, public Evaluator
 {
 public:
-	// uso costruttori e distruttore di default
+	ExecutionVisitor(const SymbolTable* st) :
+		symbols{ st }, frame(st->size(), 0), defined(st->size(), 0) {}
+
 	void visitBlock(Block* blockNode) override;
 
 	void visitPrintStmt(PrintStmt* printStmtNode) override;
@@ -31,11 +49,70 @@ public:
 	void visitRelOp(RelOp* relOpNode) override;
 	void visitBoolConst(BoolConst* boolConstNode) override;
 	void visitBoolOp(BoolOp* boolOpNode) override;
+
+	int evalNum(NumExpr* expression)
+	{
+		switch (expression->getKind())
+		{
+		case NumExpr::OPERATOR:
+			return evalOperator(static_cast<Operator*>(expression));
+		case NumExpr::NUMBER:
+			return evalNumber(static_cast<Number*>(expression));
+		default:
+			return evalVariable(static_cast<Variable*>(expression));
+		}
+	}
+	bool evalBool(BoolExpr* expression)
+	{
+		switch (expression->getKind())
+		{
+		case BoolExpr::REL_OP:
+			return evalRelOp(static_cast<RelOp*>(expression));
+		case BoolExpr::BOOL_OP:
+			return evalBoolOp(static_cast<BoolOp*>(expression));
+		default:
+			return evalBoolConst(static_cast<BoolConst*>(expression));
+		}
+	}
+	void execute(Statement* statement)
+	{
+		switch (statement->getKind())
+		{
+		case Statement::IF:
+			visitIfStmt(static_cast<IfStmt*>(statement));
+			return;
+		case Statement::WHILE:
+			visitWhileStmt(static_cast<WhileStmt*>(statement));
+			return;
+		case Statement::INPUT:
+			visitInputStmt(static_cast<InputStmt*>(statement));
+			return;
+		case Statement::SET:
+			visitSetStmt(static_cast<SetStmt*>(statement));
+			return;
+		default:
+			visitPrintStmt(static_cast<PrintStmt*>(statement));
+			return;
+		}
+	}
+
+	int evalOperator(Operator* operatorNode) override;
+	int evalNumber(Number* numberNode) override;
+	int evalVariable(Variable* variableNode) override;
+
+	bool evalRelOp(RelOp* relOpNode) override;
+	bool evalBoolConst(BoolConst* boolConstNode) override;
+	bool evalBoolOp(BoolOp* boolOpNode) override;
+
+	// risultato dell'ultima espressione visitata con accept
+	int getNumResult() const { return numResult; }
+	bool getBoolResult() const { return boolResult; }
 private:
-	std::vector<int> intStack;
-	std::vector<bool> boolStack;
-	std::vector<std::string> varStack;
-	std::map<std::string, int> variables;
+	int numResult = 0;
+	bool boolResult = false;
+	const SymbolTable* symbols;
+	std::vector<int> frame;
+	std::vector<unsigned char> defined;
 };
 
 #endif
\ No newline at end of file
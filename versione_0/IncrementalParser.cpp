@@ -0,0 +1,375 @@
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
+#include "IncrementalParser.h"
+#include "Tokenizer.h"
+#include "Exceptions.h"
+
+/**
+ * Cursor
+ *
+ * Tokenizza il testo da begin a end con Tokenizer::scanToken,
+ * che restituisce la posizione successiva a ogni Token: la
+ * posizione del Token è quella meno la lunghezza della sua
+ * parola (anche LP e RP hanno parola di un carattere).
+ */
+IncrementalParser::Cursor::Cursor(std::string_view text, std::size_t begin, std::size_t end)
+{
+	std::string_view part = text.substr(0, end);
+	Tokenizer::ScanPosition position{};
+	position.index = begin;
+	Token token{ Token::ERR, "" };
+	while (Tokenizer::scanToken(part, true, position, token) == Tokenizer::TOKEN)
+	{
+		tokens.push_back(token);
+		offsets.push_back(position.index - token.word.size());
+	}
+}
+
+void IncrementalParser::Cursor::operator++(int)
+{
+	if (index == tokens.size())
+		return;
+	if (tokens[index].tag == Token::LP)
+		open.push_back(offsets[index]);
+	else if (tokens[index].tag == Token::RP && !open.empty())
+	{
+		closedBegin = open.back();
+		closedEnd = offsets[index] + 1;
+		open.pop_back();
+	}
+	index++;
+}
+
+/**
+ * close
+ *
+ * Aggiunge la forma chiusa dall'ultima RP: le forme complete al
+ * suo interno diventano i suoi figli, con la posizione relativa
+ * all'inizio della forma.
+ */
+IncrementalParser::Form& IncrementalParser::Builder::close(Symbol symbol, NodeManager::NodeKind kind)
+{
+	std::size_t begin = itr->getClosedBegin();
+	Form form{ symbol, kind, 0, begin, itr->getClosedEnd() - begin,
+		nullptr, nullptr, nullptr, nullptr, {} };
+
+	std::size_t first = forms.size();
+	while (first > 0 && forms[first - 1].offset >= begin)
+		first--;
+	form.children.assign(std::make_move_iterator(forms.begin() + first),
+		std::make_move_iterator(forms.end()));
+	forms.erase(forms.begin() + first, forms.end());
+	for (Form& child : form.children)
+		child.offset -= begin;
+
+	forms.push_back(std::move(form));
+	return forms.back();
+}
+
+/**
+ * endBlock
+ *
+ * Se l'ultima forma chiusa è quella dell'ultimo Statement, il
+ * Block racchiude un solo Statement senza BLOCK: la forma dello
+ * Statement diventa uno StmtBlock. Altrimenti è una forma
+ * (BLOCK ...), i cui figli sono gli Statement in ordine.
+ */
+Block* IncrementalParser::Builder::endBlock(Block* block)
+{
+	block = nm->endBlock(block);
+	if (!forms.empty() && forms.back().offset == itr->getClosedBegin() &&
+		forms.back().offset + forms.back().length == itr->getClosedEnd())
+	{
+		forms.back().symbol = STMT_BLOCK;
+		forms.back().block = block;
+		return block;
+	}
+
+	Form& form = close(STMT_BLOCK, NodeManager::BLOCK);
+	form.block = block;
+	for (std::size_t i = 0; i < form.children.size(); i++)
+		form.children[i].slot = (unsigned)i;
+	return block;
+}
+
+IfStmt* IncrementalParser::Builder::makeIfStmt(BoolExpr* c, Block* b_if, Block* b_else)
+{
+	IfStmt* statement = nm->makeIfStmt(c, b_if, b_else);
+	Form& form = close(STATEMENT, NodeManager::IF_STMT);
+	form.statement = statement;
+	for (Form& child : form.children)
+		child.slot = child.boolExpr == c ? 0 : child.block == b_if ? 1 : 2;
+	return statement;
+}
+
+WhileStmt* IncrementalParser::Builder::makeWhileStmt(BoolExpr* c, Block* b)
+{
+	WhileStmt* statement = nm->makeWhileStmt(c, b);
+	Form& form = close(STATEMENT, NodeManager::WHILE_STMT);
+	form.statement = statement;
+	for (Form& child : form.children)
+		child.slot = child.boolExpr == c ? 0 : 1;
+	return statement;
+}
+
+InputStmt* IncrementalParser::Builder::makeInputStmt(Variable* var_id)
+{
+	InputStmt* statement = nm->makeInputStmt(var_id);
+	close(STATEMENT, NodeManager::INPUT_STMT).statement = statement;
+	return statement;
+}
+
+SetStmt* IncrementalParser::Builder::makeSetStmt(Variable* var_id, NumExpr* num_expr)
+{
+	SetStmt* statement = nm->makeSetStmt(var_id, num_expr);
+	close(STATEMENT, NodeManager::SET_STMT).statement = statement;
+	return statement;
+}
+
+PrintStmt* IncrementalParser::Builder::makePrintStmt(NumExpr* num_expr)
+{
+	PrintStmt* statement = nm->makePrintStmt(num_expr);
+	close(STATEMENT, NodeManager::PRINT_STMT).statement = statement;
+	return statement;
+}
+
+Operator* IncrementalParser::Builder::makeOperator(Operator::OpCode o, NumExpr* lop, NumExpr* rop)
+{
+	Operator* expression = nm->makeOperator(o, lop, rop);
+	Form& form = close(NUM_EXPR, NodeManager::OPERATOR);
+	form.numExpr = expression;
+	for (Form& child : form.children)
+		child.slot = child.numExpr == lop ? 0 : 1;
+	return expression;
+}
+
+RelOp* IncrementalParser::Builder::makeRelOp(RelOp::OpCode o, NumExpr* lop, NumExpr* rop)
+{
+	RelOp* expression = nm->makeRelOp(o, lop, rop);
+	Form& form = close(BOOL_EXPR, NodeManager::REL_OP);
+	form.boolExpr = expression;
+	for (Form& child : form.children)
+		child.slot = child.numExpr == lop ? 0 : 1;
+	return expression;
+}
+
+BoolOp* IncrementalParser::Builder::makeBoolOp(BoolOp::OpCode o, BoolExpr* lop, BoolExpr* rop)
+{
+	BoolOp* expression = nm->makeBoolOp(o, lop, rop);
+	Form& form = close(BOOL_EXPR, NodeManager::BOOL_OP);
+	form.boolExpr = expression;
+	for (Form& child : form.children)
+		child.slot = child.boolExpr == lop ? 0 : 1;
+	return expression;
+}
+
+/**
+ * parse
+ *
+ * Analizza tutto il testo e costruisce l'albero delle forme.
+ * Gli errori sono quelli del Tokenizer e di Parser: il testo
+ * viene tokenizzato tutto prima del parsing.
+ */
+Block* IncrementalParser::parse(std::string_view text)
+{
+	root.clear();
+	reparsedBytes = text.size();
+
+	Cursor cursor{ text, 0, text.size() };
+	Builder builder{ nm, &cursor };
+	BasicParser<Builder, Cursor> parser{ &builder };
+	Block* program = parser(cursor);
+	if (program != nullptr)
+		root.push_back(std::move(builder.getForms().back()));
+	return program;
+}
+
+/**
+ * update
+ *
+ * Trova la forma più piccola che contiene l'intervallo
+ * modificato senza la sua LP e la sua RP (solo allora la
+ * modifica non cambia i confini della forma) e la analizza di
+ * nuovo; se non esiste, o se l'analisi fallisce, analizza
+ * tutto il testo.
+ */
+Block* IncrementalParser::update(std::string_view text, std::size_t begin, std::size_t oldEnd, std::size_t newEnd)
+{
+	if (root.empty())
+		return parse(text);
+
+	std::vector<Form*> path{ &root[0] };
+	std::size_t formBegin = root[0].offset;
+	if (begin <= formBegin || oldEnd >= formBegin + root[0].length)
+		return parse(text);
+
+	while (true)
+	{
+		std::vector<Form>& children = path.back()->children;
+		// ultimo figlio che inizia prima della modifica
+		auto child = std::partition_point(children.begin(), children.end(),
+			[&](const Form& form) { return formBegin + form.offset < begin; });
+		if (child == children.begin())
+			break;
+		--child;
+		if (oldEnd > formBegin + child->offset + child->length - 1)
+			break;
+		formBegin += child->offset;
+		path.push_back(&*child);
+	}
+
+	std::size_t length = path.back()->length + newEnd - oldEnd;
+	if (!reparse(text, path, formBegin, length))
+		return parse(text);
+	reparsedBytes = length;
+	return root[0].block;
+}
+
+/**
+ * reparse
+ *
+ * Analizza di nuovo la forma in fondo a path, che ora occupa
+ * length byte da begin, come lo stesso simbolo. Restituisce
+ * false se la nuova forma non è corretta.
+ *
+ * Aggiorna poi le lunghezze delle forme che la contengono e le
+ * posizioni delle forme che la seguono, e ricostruisce i nodi
+ * che la contengono fino al primo Block.
+ */
+bool IncrementalParser::reparse(std::string_view text, std::vector<Form*>& path,
+	std::size_t begin, std::size_t length)
+{
+	Form& old = *path.back();
+	std::vector<Form> forms;
+	try
+	{
+		Cursor cursor{ text, begin, begin + length };
+		Builder builder{ nm, &cursor };
+		BasicParser<Builder, Cursor> parser{ &builder };
+		switch (old.symbol)
+		{
+		case STMT_BLOCK:
+			parser(cursor);
+			break;
+		case STATEMENT:
+			parser.parseSingleStatement(cursor);
+			break;
+		case NUM_EXPR:
+			parser.parseSingleNumExpr(cursor);
+			break;
+		case BOOL_EXPR:
+			parser.parseSingleBoolExpr(cursor);
+			break;
+		}
+		if (!cursor.atEnd())
+			return false;
+		forms = std::move(builder.getForms());
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+	if (forms.size() != 1 || forms[0].offset != begin || forms[0].length != length ||
+		forms[0].symbol != old.symbol)
+		return false;
+
+	// posizioni e lunghezze delle forme che contengono la
+	// modifica e di quelle che la seguono
+	std::size_t oldLength = old.length;
+	for (std::size_t i = 0; i + 1 < path.size(); i++)
+	{
+		path[i]->length = path[i]->length + length - oldLength;
+		std::vector<Form>& children = path[i]->children;
+		for (std::size_t j = (std::size_t)(path[i + 1] - children.data()) + 1; j < children.size(); j++)
+			children[j].offset = children[j].offset + length - oldLength;
+	}
+	forms[0].offset = old.offset;
+	forms[0].slot = old.slot;
+	old = std::move(forms[0]);
+
+	// nodi che contengono la forma
+	for (std::size_t i = path.size() - 1; i > 0; i--)
+	{
+		Form& child = *path[i];
+		Form& parent = *path[i - 1];
+		// Statement ricostruito racchiuso in un Block
+		if (i != path.size() - 1 && child.symbol == STMT_BLOCK && child.kind != NodeManager::BLOCK)
+		{
+			child.block->replaceStatement(0, child.statement);
+			return true;
+		}
+		if (parent.kind == NodeManager::BLOCK)
+		{
+			parent.block->replaceStatement(child.slot, child.statement);
+			return true;
+		}
+		replaceInParent(parent, child);
+	}
+	if (path.size() > 1 && root[0].kind != NodeManager::BLOCK)
+		root[0].block->replaceStatement(0, root[0].statement);
+	return true;
+}
+
+/**
+ * replaceInParent
+ *
+ * Costruisce un nuovo nodo per la forma parent, uguale al
+ * precedente ma con il nodo di child nella sua posizione.
+ */
+void IncrementalParser::replaceInParent(Form& parent, Form& child)
+{
+	switch (parent.kind)
+	{
+	case NodeManager::IF_STMT:
+	{
+		IfStmt* statement = static_cast<IfStmt*>(parent.statement);
+		parent.statement = nm->makeIfStmt(
+			child.slot == 0 ? child.boolExpr : statement->getCondition(),
+			child.slot == 1 ? child.block : statement->getBlockIf(),
+			child.slot == 2 ? child.block : statement->getBlockElse());
+		break;
+	}
+	case NodeManager::WHILE_STMT:
+	{
+		WhileStmt* statement = static_cast<WhileStmt*>(parent.statement);
+		parent.statement = nm->makeWhileStmt(
+			child.slot == 0 ? child.boolExpr : statement->getCondition(),
+			child.slot == 1 ? child.block : statement->getBlock());
+		break;
+	}
+	case NodeManager::SET_STMT:
+		parent.statement = nm->makeSetStmt(static_cast<SetStmt*>(parent.statement)->getVarId(), child.numExpr);
+		break;
+	case NodeManager::PRINT_STMT:
+		parent.statement = nm->makePrintStmt(child.numExpr);
+		break;
+	case NodeManager::OPERATOR:
+	{
+		Operator* expression = static_cast<Operator*>(parent.numExpr);
+		parent.numExpr = nm->makeOperator(expression->getOp(),
+			child.slot == 0 ? child.numExpr : expression->getLeft(),
+			child.slot == 1 ? child.numExpr : expression->getRight());
+		break;
+	}
+	case NodeManager::REL_OP:
+	{
+		RelOp* expression = static_cast<RelOp*>(parent.boolExpr);
+		parent.boolExpr = nm->makeRelOp(expression->getOp(),
+			child.slot == 0 ? child.numExpr : expression->getLeft(),
+			child.slot == 1 ? child.numExpr : expression->getRight());
+		break;
+	}
+	case NodeManager::BOOL_OP:
+	{
+		BoolOp* expression = static_cast<BoolOp*>(parent.boolExpr);
+		parent.boolExpr = nm->makeBoolOp(expression->getOp(),
+			child.slot == 0 ? child.boolExpr : expression->getLeft(),
+			child.slot == 1 ? child.boolExpr : expression->getRight());
+		break;
+	}
+	default:
+		break;
+	}
+}
@@ -0,0 +1,192 @@
+#ifndef INCREMENTAL_PARSER_H
+#define INCREMENTAL_PARSER_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "Token.h"
+#include "Block.h"
+#include "Statement.h"
+#include "NumExpr.h"
+#include "BoolExpr.h"
+#include "NodeManager.h"
+#include "Parser.h"
+#include "Exceptions.h"
+
+/**
+ * IncrementalParser effettua il parsing di un programma e, dopo
+ * una modifica del testo, analizza di nuovo solo la più piccola
+ * forma tra parentesi che contiene la modifica, riutilizzando
+ * tutti gli altri nodi dell'albero sintattico.
+ *
+ * Oltre all'albero viene conservato l'albero delle forme: per
+ * ogni forma tra parentesi (Block, Statement, Operator, RelOp,
+ * BoolOp) la posizione nel testo, relativa alla forma che la
+ * contiene, la lunghezza e il nodo generato. Il testo invece
+ * non viene conservato: a ogni modifica IncrementalParser
+ * riceve il nuovo testo e l'intervallo modificato.
+ *
+ * Dopo una modifica:
+ * - la forma viene trovata scendendo nell'albero delle forme
+ * - il suo nuovo testo viene tokenizzato e analizzato come lo
+ *   stesso simbolo della grammatica (StmtBlock, Statement,
+ *   NumExpr o BoolExpr)
+ * - i nodi che la contengono vengono ricostruiti fino al primo
+ *   Block, in cui viene sostituito lo Statement
+ *   (Block::replaceStatement); gli altri nodi non cambiano
+ * Se la modifica non è interna a una forma, oppure la nuova
+ * forma non è corretta, l'intero programma viene analizzato di
+ * nuovo: gli errori sono quindi gli stessi del Tokenizer e di
+ * Parser sul nuovo testo.
+ *
+ * I nodi sostituiti restano nel NodeManager fino alla sua
+ * pulizia. Le Variable dei nodi riutilizzati sono le stesse,
+ * quindi dopo ogni modifica il SymbolResolver va eseguito di
+ * nuovo sull'albero.
+ */
+class IncrementalParser
+{
+public:
+	// Simbolo della grammatica con cui analizzare una forma
+	enum Symbol : unsigned char { STMT_BLOCK, STATEMENT, NUM_EXPR, BOOL_EXPR };
+
+	/**
+	 * Forma tra parentesi. Durante la costruzione offset è la
+	 * posizione nel testo, poi diventa relativa alla forma che
+	 * la contiene (tranne per la radice).
+	 *
+	 * block è il Block della forma se il simbolo è STMT_BLOCK:
+	 * una forma (BLOCK ...) oppure un solo Statement, che viene
+	 * racchiuso in un Block dal parser. slot indica la posizione
+	 * del nodo nel nodo della forma che la contiene (l'indice
+	 * dello Statement in un Block, oppure l'operando).
+	 */
+	struct Form
+	{
+		Symbol symbol;
+		NodeManager::NodeKind kind;
+		unsigned slot;
+		std::size_t offset;
+		std::size_t length;
+		Block* block;
+		Statement* statement;
+		NumExpr* numExpr;
+		BoolExpr* boolExpr;
+		std::vector<Form> children;
+	};
+
+	/**
+	 * Cursore sui Token di una parte del testo, con la posizione
+	 * di ogni Token: tiene traccia dell'ultima forma chiusa da
+	 * una RP, usata da Builder.
+	 */
+	class Cursor
+	{
+	public:
+		// Tokenizza il testo da begin a end
+		Cursor(std::string_view text, std::size_t begin, std::size_t end);
+
+		bool atEnd() const { return index == tokens.size(); }
+
+		const Token* operator->() const
+		{
+			if (index == tokens.size())
+				throw SyntaxError("Overflow in token stream.");
+			return &tokens[index];
+		}
+		const Token& operator*() const { return *operator->(); }
+
+		void operator++(int);
+
+		const Token* peekNext() const
+		{
+			return index + 1 < tokens.size() ? &tokens[index + 1] : nullptr;
+		}
+
+		// Inizio e fine dell'ultima forma chiusa
+		std::size_t getClosedBegin() const { return closedBegin; }
+		std::size_t getClosedEnd() const { return closedEnd; }
+	private:
+		std::vector<Token> tokens;
+		std::vector<std::size_t> offsets;
+		std::size_t index = 0;
+
+		// posizioni delle LP delle forme aperte
+		std::vector<std::size_t> open;
+		std::size_t closedBegin = 0;
+		std::size_t closedEnd = 0;
+	};
+
+	/**
+	 * Builder per BasicParser: costruisce i nodi con il
+	 * NodeManager e intanto l'albero delle forme. Quando viene
+	 * costruito il nodo di una forma, l'ultima forma chiusa dal
+	 * cursore è proprio la sua, e le forme già costruite al suo
+	 * interno sono i suoi figli.
+	 */
+	class Builder
+	{
+	public:
+		typedef Block* BlockRef;
+		typedef Statement* StmtRef;
+		typedef NumExpr* NumRef;
+		typedef BoolExpr* BoolRef;
+		typedef Variable* VarRef;
+		typedef Block* OpenBlock;
+
+		Builder(NodeManager* manager, Cursor* cursor) : nm{ manager }, itr{ cursor } {}
+
+		// Forme complete non ancora contenute in un'altra forma
+		std::vector<Form>& getForms() { return forms; }
+
+		Block* beginBlock() { return nm->beginBlock(); }
+		void appendStatement(Block* block, Statement* statement) { nm->appendStatement(block, statement); }
+		Block* endBlock(Block* block);
+
+		IfStmt* makeIfStmt(BoolExpr* c, Block* b_if, Block* b_else);
+		WhileStmt* makeWhileStmt(BoolExpr* c, Block* b);
+		InputStmt* makeInputStmt(Variable* var_id);
+		SetStmt* makeSetStmt(Variable* var_id, NumExpr* num_expr);
+		PrintStmt* makePrintStmt(NumExpr* num_expr);
+
+		Operator* makeOperator(Operator::OpCode o, NumExpr* lop, NumExpr* rop);
+		Number* makeNumber(int v) { return nm->makeNumber(v); }
+		Variable* makeVariable(std::string_view var_id) { return nm->makeVariable(var_id); }
+
+		RelOp* makeRelOp(RelOp::OpCode o, NumExpr* lop, NumExpr* rop);
+		BoolOp* makeBoolOp(BoolOp::OpCode o, BoolExpr* lop, BoolExpr* rop);
+		BoolConst* makeBoolConst(bool v) { return nm->makeBoolConst(v); }
+	private:
+		Form& close(Symbol symbol, NodeManager::NodeKind kind);
+
+		NodeManager* nm;
+		Cursor* itr;
+		std::vector<Form> forms;
+	};
+
+	IncrementalParser(NodeManager* manager) : nm{ manager } {}
+
+	// Parsing completo del testo
+	Block* parse(std::string_view text);
+
+	// Il testo precedente è stato modificato sostituendo i byte
+	// da begin a oldEnd con quelli di text da begin a newEnd;
+	// restituisce il nuovo programma
+	Block* update(std::string_view text, std::size_t begin, std::size_t oldEnd, std::size_t newEnd);
+
+	// Byte analizzati di nuovo dall'ultima modifica
+	std::size_t getReparsedBytes() const { return reparsedBytes; }
+private:
+	bool reparse(std::string_view text, std::vector<Form*>& path, std::size_t begin, std::size_t length);
+	void replaceInParent(Form& parent, Form& child);
+
+	NodeManager* nm;
+	// Albero delle forme, vuoto se non c'è un programma valido
+	std::vector<Form> root;
+	std::size_t reparsedBytes = 0;
+};
+
+extern template class BasicParser<IncrementalParser::Builder, IncrementalParser::Cursor>;
+
+#endif
@@ -0,0 +1,396 @@
+#include "JitCompiler.h"
+
+#include <cstddef>
+
+/*
+ * CODIFICHE DELLE ISTRUZIONI x86-64
+ *
+ * Registri usati dal codice generato:
+ * - eax: risultato delle NumExpr (e valore restituito)
+ * - ecx: operando destro delle operazioni
+ * - rbx: JitContext::frame, r12: JitContext::defined,
+ *   r13: JitContext (salvati dal prologo)
+ *
+ * Il prologo allinea rsp a 16 byte e riserva i 32 byte di
+ * "shadow space" della convenzione Microsoft, quindi le
+ * chiamate alle funzioni di supporto si fanno con rsp = rbp-64.
+ */
+namespace
+{
+#ifdef _WIN32
+	// Microsoft x64: argomenti in rcx, rdx
+	const unsigned char MOV_R13_ARG0[] = { 0x49, 0x89, 0xCD };	// mov r13, rcx
+	const unsigned char MOV_ARG0_R13[] = { 0x4C, 0x89, 0xE9 };	// mov rcx, r13
+	const unsigned char MOV_ARG1_EAX[] = { 0x89, 0xC2 };		// mov edx, eax
+	const unsigned char MOV_ARG1_IMM = 0xBA;					// mov edx, imm32
+#else
+	// System V: argomenti in rdi, rsi
+	const unsigned char MOV_R13_ARG0[] = { 0x49, 0x89, 0xFD };	// mov r13, rdi
+	const unsigned char MOV_ARG0_R13[] = { 0x4C, 0x89, 0xEF };	// mov rdi, r13
+	const unsigned char MOV_ARG1_EAX[] = { 0x89, 0xC6 };		// mov esi, eax
+	const unsigned char MOV_ARG1_IMM = 0xBE;					// mov esi, imm32
+#endif
+
+	// Condizioni dei salti (secondo byte di 0F 8x)
+	const unsigned char JMP = 0;
+	const unsigned char JE = 0x84, JNE = 0x85;
+	const unsigned char JL = 0x8C, JGE = 0x8D, JLE = 0x8E, JG = 0x8F;
+
+	// Salto che si verifica quando il confronto è vero o falso
+	unsigned char relOpJump(RelOp::OpCode op, bool jumpWhen)
+	{
+		switch (op)
+		{
+		case RelOp::GT:
+			return jumpWhen ? JG : JLE;
+		case RelOp::LT:
+			return jumpWhen ? JL : JGE;
+		default:
+			return jumpWhen ? JE : JNE;
+		}
+	}
+
+	// il prologo legge frame e defined con uno spiazzamento
+	// disp8, che il processore estende con segno
+	static_assert(offsetof(JitContext, frame) <= 127 && offsetof(JitContext, defined) <= 127,
+		"JitContext: spiazzamenti disp8 con segno nel prologo");
+}
+
+/**
+ * operator()
+ *
+ * Genera una funzione int(JitContext*): prologo, Statement
+ * del Block principale, uscita normale (0) ed epilogo, poi le
+ * segnalazioni degli errori, che chiamano la funzione di
+ * supporto e saltano all'epilogo con il suo risultato (1).
+ */
+bool JitCompiler::operator()(Block* program)
+{
+	if (!JitProgram::isSupported())
+		return false;
+	code.clear();
+	exitJumps.clear();
+	undefinedJumps.clear();
+	divisionJumps.clear();
+
+	// prologo
+	emit({ 0x55 });						// push rbp
+	emit({ 0x48, 0x89, 0xE5 });			// mov rbp, rsp
+	emit({ 0x53 });						// push rbx
+	emit({ 0x41, 0x54 });				// push r12
+	emit({ 0x41, 0x55 });				// push r13
+	emit({ 0x48, 0x83, 0xEC, 0x28 });	// sub rsp, 40
+	code.insert(code.end(), std::begin(MOV_R13_ARG0), std::end(MOV_R13_ARG0));
+	// mov rbx, [r13 + frame]; mov r12, [r13 + defined]
+	emit({ 0x49, 0x8B, 0x5D, (unsigned char)offsetof(JitContext, frame) });
+	emit({ 0x4D, 0x8B, 0x65, (unsigned char)offsetof(JitContext, defined) });
+
+	compileBlock(program);
+
+	emit({ 0x31, 0xC0 });				// xor eax, eax
+	int epilogue = position();
+	emit({ 0x48, 0x8D, 0x65, 0xE8 });	// lea rsp, [rbp-24]
+	emit({ 0x41, 0x5D });				// pop r13
+	emit({ 0x41, 0x5C });				// pop r12
+	emit({ 0x5B });						// pop rbx
+	emit({ 0x5D });						// pop rbp
+	emit({ 0xC3 });						// ret
+	patchJumps(exitJumps, epilogue);
+
+	// segnalazione degli errori: rsp torna al livello del
+	// prologo, perché l'errore può avvenire con valori
+	// intermedi sulla pila
+	for (const auto& [slot, jumps] : undefinedJumps)
+	{
+		patchJumps(jumps, position());
+		emit({ 0x48, 0x8D, 0x65, 0xC0 });	// lea rsp, [rbp-64]
+		emit({ MOV_ARG1_IMM });
+		emit32(slot);
+		callHelper((const void*)&JitProgram::undefinedVariable);
+		patchJumps({ emitJump(JMP) }, epilogue);
+	}
+	if (!divisionJumps.empty())
+	{
+		patchJumps(divisionJumps, position());
+		emit({ 0x48, 0x8D, 0x65, 0xC0 });	// lea rsp, [rbp-64]
+		callHelper((const void*)&JitProgram::divisionByZero);
+		patchJumps({ emitJump(JMP) }, epilogue);
+	}
+
+	return jit->load(code, symbols->getNames());
+}
+
+void JitCompiler::compileBlock(Block* block)
+{
+	for (Statement* statement : block->getStatements())
+		compileStatement(statement);
+}
+
+/**
+ * compileStatement
+ *
+ * IF diventa un salto condizionato al ramo else; WHILE salta
+ * alla condizione in fondo al ciclo, che torna all'inizio del
+ * corpo finché è vera (un solo salto per iterazione).
+ */
+void JitCompiler::compileStatement(Statement* statement)
+{
+	switch (statement->getKind())
+	{
+	case Statement::IF:
+	{
+		IfStmt* ifStmt = static_cast<IfStmt*>(statement);
+		std::vector<int> elseJumps;
+		compileBranch(ifStmt->getCondition(), false, elseJumps);
+		compileBlock(ifStmt->getBlockIf());
+		int endJump = emitJump(JMP);
+		patchJumps(elseJumps, position());
+		compileBlock(ifStmt->getBlockElse());
+		patchJumps({ endJump }, position());
+		return;
+	}
+	case Statement::WHILE:
+	{
+		WhileStmt* whileStmt = static_cast<WhileStmt*>(statement);
+		int conditionJump = emitJump(JMP);
+		int body = position();
+		compileBlock(whileStmt->getBlock());
+		patchJumps({ conditionJump }, position());
+		std::vector<int> loopJumps;
+		compileBranch(whileStmt->getCondition(), true, loopJumps);
+		patchJumps(loopJumps, body);
+		return;
+	}
+	case Statement::INPUT:
+	{
+		int slot = static_cast<InputStmt*>(statement)->getVarId()->getSlot();
+		emit({ MOV_ARG1_IMM });
+		emit32(slot);
+		callHelper((const void*)&JitProgram::input);
+		emit({ 0x85, 0xC0 });				// test eax, eax
+		exitJumps.push_back(emitJump(JNE));
+		return;
+	}
+	case Statement::SET:
+	{
+		SetStmt* setStmt = static_cast<SetStmt*>(statement);
+		int slot = setStmt->getVarId()->getSlot();
+		compileNumExpr(setStmt->getNewValue());
+		emit({ 0x89, 0x83 });				// mov [rbx + 4*slot], eax
+		emit32(slot * 4);
+		emit({ 0x41, 0xC6, 0x84, 0x24 });	// mov byte [r12 + slot], 1
+		emit32(slot);
+		emit({ 0x01 });
+		return;
+	}
+	default:
+	{
+		compileNumExpr(static_cast<PrintStmt*>(statement)->getPrintValue());
+		code.insert(code.end(), std::begin(MOV_ARG1_EAX), std::end(MOV_ARG1_EAX));
+		callHelper((const void*)&JitProgram::print);
+		emit({ 0x85, 0xC0 });				// test eax, eax
+		exitJumps.push_back(emitJump(JNE));
+		return;
+	}
+	}
+}
+
+/**
+ * compileNumExpr
+ *
+ * Calcola l'espressione in eax. L'operando sinistro viene
+ * sempre calcolato prima del destro, quindi gli errori sono
+ * segnalati nello stesso ordine di ExecutionVisitor.
+ */
+void JitCompiler::compileNumExpr(NumExpr* expression)
+{
+	switch (expression->getKind())
+	{
+	case NumExpr::NUMBER:
+		emit({ 0xB8 });						// mov eax, imm32
+		emit32(static_cast<Number*>(expression)->getValue());
+		return;
+	case NumExpr::VARIABLE:
+	{
+		int slot = static_cast<Variable*>(expression)->getSlot();
+		checkVariable(slot);
+		emit({ 0x8B, 0x83 });				// mov eax, [rbx + 4*slot]
+		emit32(slot * 4);
+		return;
+	}
+	default:
+		break;
+	}
+
+	Operator* operatorNode = static_cast<Operator*>(expression);
+	NumExpr* right = operatorNode->getRight();
+	compileNumExpr(operatorNode->getLeft());
+	if (right->getKind() == NumExpr::OPERATOR)
+	{
+		emit({ 0x50 });						// push rax
+		compileNumExpr(right);
+		emit({ 0x89, 0xC1 });				// mov ecx, eax
+		emit({ 0x58 });						// pop rax
+	}
+	else
+		loadOperand(right);
+
+	switch (operatorNode->getOp())
+	{
+	case Operator::PLUS:
+		emit({ 0x01, 0xC8 });				// add eax, ecx
+		return;
+	case Operator::MINUS:
+		emit({ 0x29, 0xC8 });				// sub eax, ecx
+		return;
+	case Operator::TIMES:
+		emit({ 0x0F, 0xAF, 0xC1 });			// imul eax, ecx
+		return;
+	default:
+		// La divisione per 0 non è ammessa: il controllo serve
+		// solo se il divisore non è una costante diversa da 0
+		if (right->getKind() != NumExpr::NUMBER || static_cast<Number*>(right)->getValue() == 0)
+		{
+			emit({ 0x85, 0xC9 });			// test ecx, ecx
+			divisionJumps.push_back(emitJump(JE));
+		}
+		emit({ 0x99 });						// cdq
+		emit({ 0xF7, 0xF9 });				// idiv ecx
+		return;
+	}
+}
+
+// Carica in ecx un operando che è un Number o una Variable
+void JitCompiler::loadOperand(NumExpr* expression)
+{
+	if (expression->getKind() == NumExpr::NUMBER)
+	{
+		emit({ 0xB9 });						// mov ecx, imm32
+		emit32(static_cast<Number*>(expression)->getValue());
+		return;
+	}
+	int slot = static_cast<Variable*>(expression)->getSlot();
+	checkVariable(slot);
+	emit({ 0x8B, 0x8B });					// mov ecx, [rbx + 4*slot]
+	emit32(slot * 4);
+}
+
+/**
+ * compileBranch
+ *
+ * Genera i salti che si verificano quando la condizione vale
+ * jumpWhen e ne aggiunge le posizioni a jumps; se la
+ * condizione non vale jumpWhen l'esecuzione prosegue. Il
+ * secondo operando di AND e OR non viene valutato se il primo
+ * determina già il risultato.
+ */
+void JitCompiler::compileBranch(BoolExpr* condition, bool jumpWhen, std::vector<int>& jumps)
+{
+	switch (condition->getKind())
+	{
+	case BoolExpr::REL_OP:
+	{
+		RelOp* relOp = static_cast<RelOp*>(condition);
+		NumExpr* right = relOp->getRight();
+		compileNumExpr(relOp->getLeft());
+		if (right->getKind() == NumExpr::OPERATOR)
+		{
+			emit({ 0x50 });					// push rax
+			compileNumExpr(right);
+			emit({ 0x89, 0xC1 });			// mov ecx, eax
+			emit({ 0x58 });					// pop rax
+		}
+		else
+			loadOperand(right);
+		emit({ 0x39, 0xC8 });				// cmp eax, ecx
+		jumps.push_back(emitJump(relOpJump(relOp->getOp(), jumpWhen)));
+		return;
+	}
+	case BoolExpr::BOOL_CONST:
+		if ((static_cast<BoolConst*>(condition)->getValue() != 0) == jumpWhen)
+			jumps.push_back(emitJump(JMP));
+		return;
+	default:
+		break;
+	}
+
+	BoolOp* boolOp = static_cast<BoolOp*>(condition);
+	if (boolOp->getOp() == BoolOp::NOT)
+	{
+		compileBranch(boolOp->getLeft(), !jumpWhen, jumps);
+		return;
+	}
+	// AND salta se entrambi sono veri o se uno è falso, OR se
+	// uno è vero o se entrambi sono falsi
+	bool isAnd = boolOp->getOp() == BoolOp::AND;
+	if (jumpWhen != isAnd)
+	{
+		compileBranch(boolOp->getLeft(), jumpWhen, jumps);
+		compileBranch(boolOp->getRight(), jumpWhen, jumps);
+	}
+	else
+	{
+		std::vector<int> skipJumps;
+		compileBranch(boolOp->getLeft(), !jumpWhen, skipJumps);
+		compileBranch(boolOp->getRight(), jumpWhen, jumps);
+		patchJumps(skipJumps, position());
+	}
+}
+
+void JitCompiler::patchJumps(const std::vector<int>& jumps, int target)
+{
+	for (int jump : jumps)
+	{
+		int offset = target - (jump + 4);
+		for (int i = 0; i < 4; i++)
+			code[jump + i] = (unsigned char)(offset >> (8 * i));
+	}
+}
+
+// cmp byte [r12 + slot], 0; je alla segnalazione dell'errore
+void JitCompiler::checkVariable(int slot)
+{
+	emit({ 0x41, 0x80, 0xBC, 0x24 });
+	emit32(slot);
+	emit({ 0x00 });
+	undefinedJumps[slot].push_back(emitJump(JE));
+}
+
+// Il primo argomento è sempre il JitContext, il secondo deve
+// essere già stato caricato
+void JitCompiler::callHelper(const void* helper)
+{
+	code.insert(code.end(), std::begin(MOV_ARG0_R13), std::end(MOV_ARG0_R13));
+	emit({ 0x48, 0xB8 });					// mov rax, imm64
+	emit64((unsigned long long)helper);
+	emit({ 0xFF, 0xD0 });					// call rax
+}
+
+void JitCompiler::emit(std::initializer_list<unsigned char> bytes)
+{
+	code.insert(code.end(), bytes);
+}
+
+void JitCompiler::emit32(int value)
+{
+	for (int i = 0; i < 4; i++)
+		code.push_back((unsigned char)((unsigned)value >> (8 * i)));
+}
+
+void JitCompiler::emit64(unsigned long long value)
+{
+	for (int i = 0; i < 8; i++)
+		code.push_back((unsigned char)(value >> (8 * i)));
+}
+
+// Salto con spiazzamento a 32 bit da completare con
+// patchJumps, restituisce la posizione dello spiazzamento
+int JitCompiler::emitJump(unsigned char condition)
+{
+	if (condition == JMP)
+		emit({ 0xE9 });
+	else
+		emit({ 0x0F, condition });
+	emit32(0);
+	return position() - 4;
+}
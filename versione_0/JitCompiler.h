@@ -0,0 +1,77 @@
+#ifndef JIT_COMPILER_H
+#define JIT_COMPILER_H
+
+#include <initializer_list>
+#include <map>
+#include <vector>
+
+#include "Block.h"
+#include "Statement.h"
+#include "NumExpr.h"
+#include "BoolExpr.h"
+#include "JitProgram.h"
+#include "SymbolTable.h"
+
+/**
+ * JitCompiler traduce l'albero sintattico in codice macchina
+ * x86-64, caricato in un JitProgram ed eseguito direttamente
+ * dal processore.
+ *
+ * - Le variabili stanno nel frame di JitContext (rbx punta ai
+ *   valori, r12 alla tabella delle variabili definite); ogni
+ *   lettura controlla che la variabile sia definita.
+ * - Le NumExpr lasciano il risultato in eax; l'operando
+ *   sinistro viene salvato sulla pila mentre si calcola il
+ *   destro, a meno che il destro sia un Number o una Variable,
+ *   caricati direttamente in ecx.
+ * - Le BoolExpr non producono valori ma salti condizionati
+ *   (con la cortocircuitazione di AND e OR), come in
+ *   RegisterCompiler.
+ * - PRINT, INPUT e gli errori chiamano le funzioni di supporto
+ *   di JitProgram; in caso di errore il codice esce subito.
+ *
+ * I nodi sono scelti con uno switch sul kind, come in
+ * ExecutionVisitor. Le convenzioni di chiamata supportate sono
+ * System V (Linux, macOS) e Microsoft x64 (Windows).
+ */
+class JitCompiler
+{
+public:
+	JitCompiler(const SymbolTable* st, JitProgram* target) :
+		symbols{ st }, jit{ target } {}
+
+	// false se il processore non è supportato o se il sistema
+	// non concede memoria eseguibile: il programma va eseguito
+	// con un altro motore
+	bool operator()(Block* program);
+private:
+	void compileBlock(Block* block);
+	void compileStatement(Statement* statement);
+	void compileNumExpr(NumExpr* expression);
+	void loadOperand(NumExpr* expression);
+	void compileBranch(BoolExpr* condition, bool jumpWhen, std::vector<int>& jumps);
+	void patchJumps(const std::vector<int>& jumps, int target);
+
+	void checkVariable(int slot);
+	void callHelper(const void* helper);
+
+	// Scrittura del codice
+	void emit(std::initializer_list<unsigned char> bytes);
+	void emit32(int value);
+	void emit64(unsigned long long value);
+	int emitJump(unsigned char condition);
+	int position() const { return (int)code.size(); }
+
+	const SymbolTable* symbols;
+	JitProgram* jit;
+
+	std::vector<unsigned char> code;
+	// Salti verso l'uscita dopo un errore in una funzione di
+	// supporto, verso la segnalazione di una variabile non
+	// definita (per slot) e di una divisione per 0
+	std::vector<int> exitJumps;
+	std::map<int, std::vector<int>> undefinedJumps;
+	std::vector<int> divisionJumps;
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "JitProgram.h"
+#include "Runtime.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include <cstring>
+
+bool JitProgram::isSupported()
+{
+#ifdef JIT_X64
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * load
+ *
+ * La memoria viene allocata scrivibile e resa eseguibile
+ * (e non più scrivibile) dopo la copia del codice.
+ */
+bool JitProgram::load(const std::vector<unsigned char>& code, std::vector<std::string> names)
+{
+	release();
+	if (!isSupported() || code.empty())
+		return false;
+
+#ifdef _WIN32
+	void* block = VirtualAlloc(nullptr, code.size(), MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+	if (block == nullptr)
+		return false;
+	std::memcpy(block, code.data(), code.size());
+	DWORD oldProtection;
+	if (!VirtualProtect(block, code.size(), PAGE_EXECUTE_READ, &oldProtection))
+	{
+		VirtualFree(block, 0, MEM_RELEASE);
+		return false;
+	}
+	FlushInstructionCache(GetCurrentProcess(), block, code.size());
+#else
+	void* block = mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (block == MAP_FAILED)
+		return false;
+	std::memcpy(block, code.data(), code.size());
+	if (mprotect(block, code.size(), PROT_READ | PROT_EXEC) != 0)
+	{
+		munmap(block, code.size());
+		return false;
+	}
+#endif
+
+	memory = block;
+	memorySize = code.size();
+	entry = (Entry)memory;
+	variableNames = std::move(names);
+	return true;
+}
+
+void JitProgram::release()
+{
+	if (memory == nullptr)
+		return;
+#ifdef _WIN32
+	VirtualFree(memory, 0, MEM_RELEASE);
+#else
+	munmap(memory, memorySize);
+#endif
+	memory = nullptr;
+	memorySize = 0;
+	entry = nullptr;
+}
+
+/**
+ * run
+ *
+ * Esegue il codice con tutte le variabili non definite e
+ * rilancia l'eventuale errore di esecuzione.
+ */
+void JitProgram::run() const
+{
+	std::vector<int> frame(variableNames.size() + 1, 0);
+	std::vector<unsigned char> defined(variableNames.size() + 1, 0);
+	JitContext context{ frame.data(), defined.data(), variableNames.data(), nullptr };
+	if (entry(&context) != 0)
+		std::rethrow_exception(context.error);
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * FUNZIONI DI SUPPORTO PER IL CODICE GENERATO
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+int JitProgram::print(JitContext* context, int value)
+{
+	try
+	{
+		Runtime::print(value);
+		return 0;
+	}
+	catch (...)
+	{
+		context->error = std::current_exception();
+		return 1;
+	}
+}
+
+int JitProgram::input(JitContext* context, int slot)
+{
+	try
+	{
+		// lancia InputError se il valore non è valido
+		context->frame[slot] = Runtime::readInput();
+		context->defined[slot] = 1;
+		return 0;
+	}
+	catch (...)
+	{
+		context->error = std::current_exception();
+		return 1;
+	}
+}
+
+int JitProgram::undefinedVariable(JitContext* context, int slot)
+{
+	try
+	{
+		Runtime::throwUndefinedVariable(context->names[slot]);
+	}
+	catch (...)
+	{
+		context->error = std::current_exception();
+	}
+	return 1;
+}
+
+int JitProgram::divisionByZero(JitContext* context)
+{
+	try
+	{
+		Runtime::throwDivisionByZero();
+	}
+	catch (...)
+	{
+		context->error = std::current_exception();
+	}
+	return 1;
+}
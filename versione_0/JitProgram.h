@@ -0,0 +1,80 @@
+#ifndef JIT_PROGRAM_H
+#define JIT_PROGRAM_H
+
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define JIT_X64
+#endif
+
+/**
+ * Stato dell'esecuzione passato al codice generato da
+ * JitCompiler: il frame delle variabili, la tabella delle
+ * variabili definite, i nomi (per i messaggi di errore) e
+ * l'eventuale errore di esecuzione.
+ *
+ * Il codice generato legge frame e defined con spiazzamenti
+ * fissi, quindi l'ordine dei campi non va cambiato.
+ */
+struct JitContext
+{
+	int* frame;
+	unsigned char* defined;
+	const std::string* names;
+	std::exception_ptr error;
+};
+
+/**
+ * Programma compilato da JitCompiler: codice macchina x86-64
+ * in memoria eseguibile e nomi delle variabili, nell'ordine
+ * degli slot.
+ *
+ * Il codice è una funzione int(JitContext*) che restituisce 0
+ * se l'esecuzione termina, 1 in caso di errore. Le eccezioni
+ * non possono attraversare il codice generato (non ha le
+ * informazioni per lo unwinding), quindi le funzioni di
+ * supporto chiamate dal codice (PRINT, INPUT, errori) catturano
+ * l'eccezione in JitContext::error e restituiscono 1; run la
+ * rilancia dopo l'uscita dal codice generato, con gli stessi
+ * messaggi di ExecutionVisitor.
+ */
+class JitProgram
+{
+public:
+	typedef int (*Entry)(JitContext* context);
+
+	JitProgram() = default;
+	JitProgram(const JitProgram& other) = delete;
+	JitProgram& operator=(const JitProgram& other) = delete;
+	~JitProgram() { release(); }
+
+	// true se il processore è x86-64
+	static bool isSupported();
+
+	// Copia il codice in memoria eseguibile; false se il
+	// sistema non concede memoria eseguibile
+	bool load(const std::vector<unsigned char>& code, std::vector<std::string> names);
+
+	void run() const;
+
+	std::size_t getCodeSize() const { return memorySize; }
+
+	// Funzioni di supporto chiamate dal codice generato,
+	// restituiscono 0 o 1 (errore in context->error)
+	static int print(JitContext* context, int value);
+	static int input(JitContext* context, int slot);
+	static int undefinedVariable(JitContext* context, int slot);
+	static int divisionByZero(JitContext* context);
+private:
+	void release();
+
+	void* memory = nullptr;
+	std::size_t memorySize = 0;
+	Entry entry = nullptr;
+	std::vector<std::string> variableNames;
+};
+
+#endif
@@ -0,0 +1,26 @@
+#include "LazyLoader.h"
+#include "Parser.h"
+#include "SymbolResolver.h"
+#include "TokenCursor.h"
+
+/**
+ * load
+ *
+ * Analizza i Token del Block pigro come uno statement block,
+ * sposta gli Statement generati nel Block (l'IfStmt o il
+ * WhileStmt punta già a quel Block) e ne risolve le variabili.
+ */
+void LazyLoader::load(Block* block)
+{
+	VectorCursor cursor{ block->getFirstToken(), block->getLastToken() };
+	Parser parse{ nm };
+	parse.setLazyBodies(this);
+	Block* body = parse(cursor);
+
+	block->finishLoad(body->getStatements());
+	SymbolResolver resolve{ symbols };
+	resolve(block);
+
+	loadedBlocks++;
+	loadedTokens += block->getLastToken() - block->getFirstToken();
+}
@@ -0,0 +1,44 @@
+#ifndef LAZY_LOADER_H
+#define LAZY_LOADER_H
+
+#include <cstddef>
+
+#include "Block.h"
+#include "NodeManager.h"
+#include "SymbolTable.h"
+
+/**
+ * LazyLoader genera i nodi dei corpi di IfStmt e WhileStmt
+ * solo quando vengono eseguiti per la prima volta.
+ *
+ * Con il parsing pigro (Parser::setLazyBodies) il parser salta
+ * i corpi controllando solo le parentesi, e per ognuno genera
+ * un Block pigro con i suoi Token. Alla prima richiesta degli
+ * Statement il Block chiama load, che analizza i Token con un
+ * Parser, anche questo pigro (i corpi annidati restano pigri),
+ * e risolve le nuove variabili con SymbolResolver.
+ *
+ * Gli errori di sintassi di un corpo vengono quindi lanciati
+ * durante l'esecuzione, e solo se il corpo viene eseguito: per
+ * controllare tutto il programma si usa --check.
+ *
+ * I Token devono restare in memoria finché ci sono Block pigri.
+ */
+class LazyLoader : public BlockLoader
+{
+public:
+	LazyLoader(NodeManager* manager, SymbolTable* st) : nm{ manager }, symbols{ st } {}
+
+	void load(Block* block) override;
+
+	// Numero di Block analizzati e dei loro Token
+	std::size_t getLoadedBlocks() const { return loadedBlocks; }
+	std::size_t getLoadedTokens() const { return loadedTokens; }
+private:
+	NodeManager* nm;
+	SymbolTable* symbols;
+	std::size_t loadedBlocks = 0;
+	std::size_t loadedTokens = 0;
+};
+
+#endif
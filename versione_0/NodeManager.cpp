@@ -7,34 +7,65 @@
 #include "BoolExpr.h"
 
 /**
- * Dealloca tutti i nodi da tutte le liste e ripulisce la
- * memoria.
+ * Distrugge i nodi che possiedono memoria propria e
+ * restituisce l'arena al sistema in un colpo solo.
  */
 void NodeManager::clearMemory()
 {
 	//std::cout << "MAN: Clearing memory..." << std::endl;
 	for (Block* block : blockNodes)
-		delete(block);
-	for (Statement* statement : statementNodes)
-		delete(statement);
-	for (NumExpr* numExpr : numExprNodes)
-		delete(numExpr);
-	for (BoolExpr* boolExpr : boolExprNodes)
-		delete(boolExpr);
+		block->~Block();
+	for (Variable* variable : variableNodes)
+		variable->~Variable();
+	blockNodes.clear();
+	variableNodes.clear();
+	arena.release();
+
+	for (int kind = 0; kind < NODE_KINDS; kind++)
+	{
+		nodeCount[kind] = 0;
+		nodeBytes[kind] = 0;
+	}
 }
 
+/**
+ * merge
+ *
+ * I nodi di other, con la sua arena e le sue statistiche,
+ * passano a questo NodeManager e verranno liberati insieme ai
+ * suoi. I nodi non vengono spostati: i puntatori restano
+ * validi, quindi un albero può contenere nodi costruiti da
+ * NodeManager diversi, uniti poi con merge.
+ */
+void NodeManager::merge(NodeManager& other)
+{
+	blockNodes.insert(blockNodes.end(), other.blockNodes.begin(), other.blockNodes.end());
+	variableNodes.insert(variableNodes.end(), other.variableNodes.begin(), other.variableNodes.end());
+	other.blockNodes.clear();
+	other.variableNodes.clear();
+	arena.merge(other.arena);
+
+	for (int kind = 0; kind < NODE_KINDS; kind++)
+	{
+		nodeCount[kind] += other.nodeCount[kind];
+		nodeBytes[kind] += other.nodeBytes[kind];
+		other.nodeCount[kind] = 0;
+		other.nodeBytes[kind] = 0;
+	}
+}
 
 /**
  * FACTORY METHOD PER TUTTI GLI OGGETTI DA GESTIRE
  * 
  * Per ogni oggetto:
- * - l'oggetto viene creato chiamando il suo costruttore
- * - l'oggetto viene aggiunto alla lista corrispondente
+ * - l'oggetto viene costruito nell'arena
+ * - se possiede memoria propria, l'oggetto viene aggiunto alla
+ *   lista corrispondente per essere distrutto da clearMemory
  * - viene restituito il puntatore all'oggetto
  */
 Block* NodeManager::makeBlock()
 {
-	Block* x = new Block();
+	Block* x = make<Block>(BLOCK);
 	blockNodes.push_back(x);
 	//std::cout << "MAN: New Block created at " << x << std::endl;
 	return x;
@@ -42,80 +73,81 @@ Block* NodeManager::makeBlock()
 
 IfStmt* NodeManager::makeIfStmt(BoolExpr* c, Block* b_if, Block* b_else)
 {
-	IfStmt* x = new IfStmt(c, b_if, b_else);
-	statementNodes.push_back(x);
-	//std::cout << "MAN: New IfStmt created at " << x << std::endl;
-	return x;
+	return make<IfStmt>(IF_STMT, c, b_if, b_else);
 }
 WhileStmt* NodeManager::makeWhileStmt(BoolExpr* c, Block* b)
 {
-	WhileStmt* x = new WhileStmt(c, b);
-	statementNodes.push_back(x);
-	//std::cout << "MAN: New WhileStmt created at " << x << std::endl;
-	return x;
+	return make<WhileStmt>(WHILE_STMT, c, b);
 }
 InputStmt* NodeManager::makeInputStmt(Variable* var_id)
 {
-	InputStmt* x = new InputStmt(var_id);
-	statementNodes.push_back(x);
-	//std::cout << "MAN: New InputStmt created at " << x << std::endl;
-	return x;
+	return make<InputStmt>(INPUT_STMT, var_id);
 }
 SetStmt* NodeManager::makeSetStmt(Variable* var_id, NumExpr* num_expr)
 {
-	SetStmt* x = new SetStmt(var_id, num_expr);
-	statementNodes.push_back(x);
-	//std::cout << "MAN: New SetStmt created at " << x << std::endl;
-	return x;
+	return make<SetStmt>(SET_STMT, var_id, num_expr);
 }
 PrintStmt* NodeManager::makePrintStmt(NumExpr* num_expr)
 {
-	PrintStmt* x = new PrintStmt(num_expr);
-	statementNodes.push_back(x);
-	//std::cout << "MAN: New PrintStmt created at " << x << std::endl;
-	return x;
+	return make<PrintStmt>(PRINT_STMT, num_expr);
 }
 
 Operator* NodeManager::makeOperator(Operator::OpCode o, NumExpr* lop, NumExpr* rop)
 {
-	Operator* x = new Operator(o, lop, rop);
-	numExprNodes.push_back(x);
-	return x;
+	return make<Operator>(OPERATOR, o, lop, rop);
 }
 Number* NodeManager::makeNumber(int v)
 {
-	Number* x = new Number(v);
-	numExprNodes.push_back(x);
-	return x;
+	return make<Number>(NUMBER, v);
 }
-Variable* NodeManager::makeVariable(const std::string& var_id)
+Variable* NodeManager::makeVariable(std::string_view var_id)
 {
-	Variable* x = new Variable(var_id);
-	numExprNodes.push_back(x);
+	Variable* x = make<Variable>(VARIABLE, var_id);
+	variableNodes.push_back(x);
 	return x;
 }
 
 RelOp* NodeManager::makeRelOp(RelOp::OpCode o, NumExpr* lop, NumExpr* rop)
 {
-	RelOp* x = new RelOp(o, lop, rop);
-	boolExprNodes.push_back(x);
-	return x;
+	return make<RelOp>(REL_OP, o, lop, rop);
 }
 BoolOp* NodeManager::makeBoolOp(BoolOp::OpCode o, BoolExpr* lop, BoolExpr* rop)
 {
-	BoolOp* x = new BoolOp(o, lop, rop);
-	boolExprNodes.push_back(x);
-	return x;
+	return make<BoolOp>(BOOL_OP, o, lop, rop);
 }
 BoolConst* NodeManager::makeBoolConst(bool v)
 {
-	BoolConst* x = new BoolConst(v);
-	boolExprNodes.push_back(x);
-	return x;
+	return make<BoolConst>(BOOL_CONST, v);
 }
 
 
+/**
+ * printStatistics
+ *
+ * Per ogni tipo di nodo stampa quanti nodi sono stati creati e
+ * quanti byte occupano nell'arena, seguiti dal totale e dalla
+ * memoria effettivamente riservata dall'arena.
+ */
+void NodeManager::printStatistics(std::ostream& out) const
+{
+	std::size_t totalCount = 0;
+	std::size_t totalBytes = 0;
+	for (int kind = 0; kind < NODE_KINDS; kind++)
+	{
+		out << "(MEMORY " << kindToStr((NodeKind)kind) << ": "
+			<< nodeCount[kind] << " nodes, " << nodeBytes[kind] << " bytes )" << std::endl;
+		totalCount += nodeCount[kind];
+		totalBytes += nodeBytes[kind];
+	}
+	out << "(MEMORY total: " << totalCount << " nodes, " << totalBytes << " bytes, "
+		<< arena.bytesReserved() << " bytes reserved )" << std::endl;
+}
 
-
-
-
+const char* NodeManager::kindToStr(NodeKind kind)
+{
+	static const char* const names[NODE_KINDS] = {
+		"Block", "IfStmt", "WhileStmt", "InputStmt", "SetStmt", "PrintStmt",
+		"Operator", "Number", "Variable", "RelOp", "BoolOp", "BoolConst"
+	};
+	return names[kind];
+}
@@ -3,7 +3,10 @@
 
 #include <vector>
 #include <iostream>
+#include <new>
+#include <utility>
 
+#include "Arena.h"
 #include "Block.h"
 #include "Statement.h"
 #include "NumExpr.h"
@@ -13,18 +16,49 @@
 /**
  * Manager si occupa di allocare, memorizzare e deallocare
  * gli oggetti che compongono l'albero sintattico del programma.
+ *
+ * I nodi sono costruiti uno dopo l'altro in un'Arena e
+ * vengono liberati tutti insieme. Solo Block e Variable
+ * possiedono memoria propria (la lista di statement e il
+ * nome), quindi sono gli unici nodi di cui viene chiamato il
+ * distruttore; gli altri contengono solo puntatori e valori e
+ * vengono semplicemente abbandonati quando l'arena è liberata.
  */
 class NodeManager
 {
 public:
-	NodeManager() : blockNodes{}, statementNodes{},
-		numExprNodes{}, boolExprNodes{} {}
+	// Tipi di nodo, per le statistiche di memoria
+	enum NodeKind
+	{
+		BLOCK, IF_STMT, WHILE_STMT, INPUT_STMT, SET_STMT, PRINT_STMT,
+		OPERATOR, NUMBER, VARIABLE, REL_OP, BOOL_OP, BOOL_CONST,
+		NODE_KINDS
+	};
+
+	// Tipi usati da BasicParser per i riferimenti ai nodi
+	typedef Block* BlockRef;
+	typedef Statement* StmtRef;
+	typedef NumExpr* NumRef;
+	typedef BoolExpr* BoolRef;
+	typedef Variable* VarRef;
+	typedef Block* OpenBlock;
+
+	NodeManager() : blockNodes{}, variableNodes{},
+		nodeCount{}, nodeBytes{} {}
 	NodeManager(const NodeManager& other) = delete;
 	~NodeManager() { clearMemory(); }
 
 	void clearMemory();
 
+	// Prende i nodi di other, che resta vuoto (vedi ParallelParser)
+	void merge(NodeManager& other);
+
 	Block* makeBlock();
+	// Costruzione di un Block statement per statement, stessa
+	// interfaccia di CompactAst
+	Block* beginBlock() { return makeBlock(); }
+	void appendStatement(Block* block, Statement* statement) { block->appendStatement(statement); }
+	Block* endBlock(Block* block) { return block; }
 
 	IfStmt* makeIfStmt(BoolExpr* c, Block* b_if, Block* b_else);
 	WhileStmt* makeWhileStmt(BoolExpr* c, Block* b);
@@ -34,16 +68,34 @@ public:
 
 	Operator* makeOperator(Operator::OpCode o, NumExpr* lop, NumExpr* rop);
 	Number* makeNumber(int v);
-	Variable* makeVariable(const std::string& var_id);
+	Variable* makeVariable(std::string_view var_id);
 
 	RelOp* makeRelOp(RelOp::OpCode o, NumExpr* lop, NumExpr* rop);
 	BoolOp* makeBoolOp(BoolOp::OpCode o, BoolExpr* lop, BoolExpr* rop);
 	BoolConst* makeBoolConst(bool v);
+
+	// Stampa numero di nodi e byte occupati per ogni tipo di nodo
+	void printStatistics(std::ostream& out) const;
+
+	static const char* kindToStr(NodeKind kind);
 private:
+	// Costruisce un nodo nell'arena e aggiorna le statistiche
+	template <class T, class... Args>
+	T* make(NodeKind kind, Args&&... args)
+	{
+		void* memory = arena.allocate(sizeof(T), alignof(T));
+		nodeCount[kind]++;
+		nodeBytes[kind] += sizeof(T);
+		return new (memory) T(std::forward<Args>(args)...);
+	}
+
+	Arena arena;
+	// Nodi che vanno distrutti prima di liberare l'arena
 	std::vector<Block*> blockNodes;
-	std::vector<Statement*> statementNodes;
-	std::vector<NumExpr*> numExprNodes;
-	std::vector<BoolExpr*> boolExprNodes;
+	std::vector<Variable*> variableNodes;
+
+	std::size_t nodeCount[NODE_KINDS];
+	std::size_t nodeBytes[NODE_KINDS];
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,11 +1,16 @@
 #include "NumExpr.h"
 #include "Visitor.h"
-// Dentro il file *.cpp  possibile includere Visitor
+#include "Evaluator.h"
+// Dentro il file *.cpp è possibile includere Visitor
 
 void Operator::accept(Visitor* v) { (*v).visitOperator(this); }
 void Number::accept(Visitor* v) { v->visitNumber(this); }
 void Variable::accept(Visitor* v) { v->visitVariable(this); }
 
+int Operator::eval(Evaluator* e) { return e->evalOperator(this); }
+int Number::eval(Evaluator* e) { return e->evalNumber(this); }
+int Variable::eval(Evaluator* e) { return e->evalVariable(this); }
+
 Operator::OpCode Operator::tokenToOpCode(const Token& t)
 {
     if (t.tag == Token::ADD) return PLUS;
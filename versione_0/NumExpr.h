@@ -1,22 +1,38 @@
 #ifndef NUM_EXPR_H
 #define NUM_EXPR_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 #include "Token.h"
 
-// Visitor include gi NumExpr, quindi NumExpr non pu includere
+// Visitor include già NumExpr, quindi NumExpr non può includere
 // a sua volta Visitor, ma la classe deve comunque essere dichiarata
 class Visitor;
+class Evaluator;
 
 /*
- * Espressione numerica generica
+ * Espressione numerica generica, con il tipo concreto in kind
+ * (vedi Statement)
  */
 class NumExpr
 {
 public:
+	enum Kind : std::uint8_t { OPERATOR, NUMBER, VARIABLE };
+
 	virtual ~NumExpr() {};
 	virtual void accept(Visitor* v) = 0;
+	// valuta l'espressione restituendo il risultato
+	virtual int eval(Evaluator* e) = 0;
+
+	Kind getKind() const { return kind; }
+protected:
+	NumExpr(Kind k) : kind{ k } {}
+	NumExpr(const NumExpr& other) = default;
+	NumExpr& operator=(const NumExpr& other) = default;
+private:
+	Kind kind;
 };
 
 /*
@@ -29,11 +45,12 @@ public:
 	enum OpCode { PLUS, MINUS, TIMES, DIV, ERR };
 
 	Operator(OpCode o, NumExpr* lop, NumExpr* rop) :
-		operation{ o }, left{ lop }, right{ rop } {}
+		NumExpr{ OPERATOR }, operation{ o }, left{ lop }, right{ rop } {}
 	Operator(const Operator& other) = default;
 	~Operator() = default;
 
 	void accept(Visitor* v) override;
+	int eval(Evaluator* e) override;
 
 	OpCode getOp() const { return operation; }
 	NumExpr* getLeft() const { return left; }
@@ -53,19 +70,20 @@ private:
 class Number : public NumExpr
 {
 public:
-	Number(int v) : value{ v } {}
+	Number(int v) : NumExpr{ NUMBER }, value{ v } {}
 	Number(const Number& other) = default;
 	~Number() {}
 	Number& operator=(const Number& other) = default;
 
 	int getValue() const { return value; }
 
-	// mentre i visitor sono molteplici, il metodo accept  unico.
-	// in effetti l'oggetto non  in grado n di interpretarsi e
-	// n di stampare s stesso, ma "chiama" un visitor esterno
+	// mentre i visitor sono molteplici, il metodo accept è unico.
+	// in effetti l'oggetto non è in grado né di interpretarsi e
+	// né di stampare sé stesso, ma "chiama" un visitor esterno
 	// specializzato in quell'operazione in modo che la faccia al
 	// suo posto.
 	void accept(Visitor* v) override;
+	int eval(Evaluator* e) override;
 
 private:
 	int value;
@@ -74,21 +92,28 @@ private:
 /*
  * Rappresenta variabile con un id a valore intero.
  * Il valore non viene memorizzato all'interno della
- * struttura dati, poich la variabile assume dei
+ * struttura dati, poiché la variabile assume dei
  * valori solamente a runtime.
+ * Lo slot è l'indice della variabile nella SymbolTable,
+ * assegnato da SymbolResolver dopo il parsing (-1 prima).
  */
 class Variable : public NumExpr
 {
 public:
-	Variable(const std::string& var_id) :
-		name{ var_id } {}
+	Variable(std::string_view var_id) :
+		NumExpr{ VARIABLE }, slot{ -1 }, name{ var_id } {}
 	Variable(const Variable& other) = default;
 	~Variable() = default;
 
 	void accept(Visitor* v) override;
+	int eval(Evaluator* e) override;
 
-	std::string getName() const { return name; }
+	const std::string& getName() const { return name; }
+	int getSlot() const { return slot; }
+	void setSlot(int s) { slot = s; }
 private:
+	// slot prima di name, per occupare lo spazio libero dopo kind
+	int slot;
 	std::string name;
 };
 
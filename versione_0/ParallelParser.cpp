@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "ParallelParser.h"
+#include "Parser.h"
+#include "TokenCursor.h"
+#include "Exceptions.h"
+
+/**
+ * operator()
+ *
+ * Divide gli Statement del Block principale in parti, ognuna
+ * con circa lo stesso numero di Token, e le analizza in
+ * parallelo: la prima sul thread corrente, le altre su un
+ * thread ciascuna.
+ *
+ * Ogni Statement viene analizzato con un cursore limitato ai
+ * suoi Token, e deve usarli tutti. Se una parte fallisce
+ * il lavoro delle altre viene scartato, e l'intero programma
+ * viene analizzato da Parser: così l'errore segnalato è quello
+ * del primo Statement sbagliato (o un errore nella struttura
+ * del Block), esattamente come senza ParallelParser.
+ */
+Block* ParallelParser::operator()(const std::vector<Token>& tokens)
+{
+	std::vector<std::size_t> bounds;
+	unsigned parts = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+	parts = (unsigned)std::min<std::size_t>(parts, tokens.size() / minPartTokens);
+
+	if (parts <= 1 || !findStatements(tokens, bounds))
+	{
+		VectorCursor cursor{ tokens };
+		Parser parse{ nm };
+		return parse(cursor);
+	}
+
+	// primo Statement di ogni parte, l'ultimo elemento è il
+	// numero di Statement
+	std::size_t count = bounds.size() - 1;
+	std::vector<std::size_t> partBegin{ 0 };
+	for (std::size_t i = 1; i < count && partBegin.size() < parts; i++)
+		if (bounds[i] - bounds[partBegin.back()] >= (bounds[count] - bounds[0]) / parts)
+			partBegin.push_back(i);
+	partBegin.push_back(count);
+	std::size_t partCount = partBegin.size() - 1;
+
+	std::vector<std::unique_ptr<NodeManager>> managers(partCount);
+	std::vector<std::vector<Statement*>> partStatements(partCount);
+	std::vector<char> failed(partCount, false);
+	auto parsePart = [&](std::size_t part)
+	{
+		try
+		{
+			managers[part] = std::make_unique<NodeManager>();
+			Parser parse{ managers[part].get() };
+			for (std::size_t i = partBegin[part]; i < partBegin[part + 1]; i++)
+			{
+				VectorCursor cursor{ tokens.data() + bounds[i], tokens.data() + bounds[i + 1] };
+				partStatements[part].push_back(parse.parseSingleStatement(cursor));
+				if (!cursor.atEnd())
+				{
+					failed[part] = true;
+					return;
+				}
+			}
+		}
+		catch (...)
+		{
+			failed[part] = true;
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (std::size_t part = 1; part < partCount; part++)
+		workers.emplace_back(parsePart, part);
+	parsePart(0);
+	for (std::thread& worker : workers)
+		worker.join();
+
+	if (std::find(failed.begin(), failed.end(), true) != failed.end())
+	{
+		VectorCursor cursor{ tokens };
+		Parser parse{ nm };
+		return parse(cursor);
+	}
+
+	Block* program = nm->beginBlock();
+	for (std::size_t part = 0; part < partCount; part++)
+	{
+		nm->merge(*managers[part]);
+		for (Statement* statement : partStatements[part])
+			nm->appendStatement(program, statement);
+	}
+	return nm->endBlock(program);
+}
+
+/**
+ * findStatements
+ *
+ * Controlla che il programma sia LP BLOCK <Statement> ... RP e
+ * trova i confini di ogni Statement contando le parentesi: in
+ * bounds l'indice del primo Token di ogni Statement, seguito
+ * dall'indice della RP finale del Block. Restituisce false se
+ * il programma non ha questa forma (ad esempio se le parentesi
+ * non sono bilanciate).
+ */
+bool ParallelParser::findStatements(const std::vector<Token>& tokens,
+	std::vector<std::size_t>& bounds)
+{
+	if (tokens.size() < 3 || tokens[0].tag != Token::LP || tokens[1].tag != Token::BLOCK)
+		return false;
+
+	std::size_t index = 2;
+	while (index < tokens.size() && tokens[index].tag == Token::LP)
+	{
+		bounds.push_back(index);
+		std::size_t depth = 0;
+		do
+		{
+			if (tokens[index].tag == Token::LP)
+				depth++;
+			else if (tokens[index].tag == Token::RP)
+				depth--;
+			index++;
+		} while (depth > 0 && index < tokens.size());
+		if (depth > 0)
+			return false;
+	}
+	if (bounds.empty() || index >= tokens.size() || tokens[index].tag != Token::RP)
+		return false;
+	bounds.push_back(index);
+	return true;
+}
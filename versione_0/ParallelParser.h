@@ -0,0 +1,47 @@
+#ifndef PARALLEL_PARSER_H
+#define PARALLEL_PARSER_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Token.h"
+#include "Block.h"
+#include "NodeManager.h"
+
+/**
+ * ParallelParser effettua il parsing di un programma formato da
+ * un solo grande Block analizzando in parallelo gli Statement
+ * del Block principale, che sono sottoalberi indipendenti.
+ *
+ * I confini di ogni Statement vengono trovati prima con una
+ * semplice scansione delle parentesi (LP e RP) dei Token; gli
+ * Statement vengono poi divisi in parti di dimensione simile,
+ * ognuna analizzata da un thread con il proprio Parser e il
+ * proprio NodeManager (quindi la propria arena). Alla fine i
+ * NodeManager vengono uniti a quello ricevuto e gli Statement
+ * aggiunti in ordine al Block principale.
+ *
+ * Il risultato e gli errori sono gli stessi di Parser: se il
+ * programma non ha la forma attesa, oppure una parte contiene
+ * un errore, il programma viene analizzato di nuovo da Parser
+ * su un solo thread, che lancia il primo errore di sintassi.
+ */
+class ParallelParser
+{
+public:
+	// Numero massimo di thread, 0 per usare tutti i core
+	ParallelParser(NodeManager* manager, unsigned threads = 0) : nm{ manager }, threads{ threads } {}
+
+	Block* operator()(const std::vector<Token>& tokens);
+private:
+	// Dimensione minima di ogni parte, in Token
+	static const std::size_t minPartTokens = 64 * 1024;
+
+	static bool findStatements(const std::vector<Token>& tokens,
+		std::vector<std::size_t>& bounds);
+
+	NodeManager* nm;
+	unsigned threads;
+};
+
+#endif
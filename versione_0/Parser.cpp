@@ -3,6 +3,8 @@
 #include <string>
 #include <sstream>
 #include <exception>
+#include <type_traits>
+#include <cassert>
 
 #include "Parser.h"
 #include "Block.h"
@@ -10,7 +12,12 @@
 #include "NumExpr.h"
 #include "BoolExpr.h"
 #include "NodeManager.h"
+#include "CompactAst.h"
 #include "Token.h"
+#include "TokenCursor.h"
+#include "TokenStream.h"
+#include "SourceCursor.h"
+#include "IncrementalParser.h"
 #include "Exceptions.h"
 
 
@@ -18,10 +25,11 @@
 /**
  * throwSyntaxError
  * 
- * Funzione di utilit per lanciare un errore di sintassi,
+ * Funzione di utilità per lanciare un errore di sintassi,
  * l'eccezione specifica il token che l'ha scatenata.
  */
-void Parser::throwSyntaxError(Token failedToken,
+template <class Builder, class Cursor>
+void BasicParser<Builder, Cursor>::throwSyntaxError(Token failedToken,
     std::string expectedToken)
 {
     std::stringstream errorMessage{};
@@ -68,24 +76,239 @@ void Parser::throwSyntaxError(Token failedToken,
 /**
  * operator()
  *
- * Effettua il parsing di un vettore di Token, e restituisce
+ * Effettua il parsing dei Token letti dal cursore, e restituisce
  * il nodo iniziale della struttura dati contenente il programma.
  *
- * Per effettuare il parsing di Block, Statement, NumExpr e
- * BoolExpr vengono chiamati dei metodi appositi.
+ * I metodi parseBlock, parseStatement, parseNumExpr, ...
+ * controllano i primi Token del simbolo e mettono nella pila
+ * work quello che resta da fare: i sotto-simboli e la parte
+ * che li segue (ad esempio IF_END, che controlla la RP finale
+ * e costruisce l'IfStmt). Il ciclo esegue il lavoro in cima
+ * alla pila finché la pila non è vuota; ogni simbolo concluso
+ * lascia il suo nodo nella pila del suo tipo (blocks,
+ * statements, numExprs, boolExprs).
+ *
+ * I Token vengono controllati nello stesso ordine di un parser
+ * ricorsivo discendente, quindi gli errori sono gli stessi.
  */
-Block* Parser::operator()(const std::vector<Token>& tokenStream)
+template <class Builder, class Cursor>
+typename BasicParser<Builder, Cursor>::BlockRef BasicParser<Builder, Cursor>::operator()(Cursor& itr)
 {
     //std::cout << "PAR: Begin parsing" << std::endl;
-    auto itr = tokenStream.begin();    
-    auto end = tokenStream.end();
 
     // Se non ci sono Token
-    if (tokenStream.size() == 0)
-        return nullptr;
+    if (itr.atEnd())
+        return BlockRef{};
+
+    // Un intero programma è uno statement block
+    run(itr, STMT_BLOCK);
+    return pop(blocks);
+}
+
+/**
+ * parseSingleStatement, parseSingleNumExpr, parseSingleBoolExpr
+ *
+ * Effettuano il parsing di un solo simbolo, a partire dal Token
+ * corrente, e portano il cursore sul Token che lo segue. Usati
+ * da ParallelParser per gli Statement del Block principale e da
+ * IncrementalParser per le forme modificate.
+ */
+template <class Builder, class Cursor>
+typename BasicParser<Builder, Cursor>::StmtRef BasicParser<Builder, Cursor>::parseSingleStatement(Cursor& itr)
+{
+    run(itr, STATEMENT);
+    return pop(statements);
+}
 
-    // Un intero programma  uno statement block
-    return parseStmtBlock(itr, end);
+template <class Builder, class Cursor>
+typename BasicParser<Builder, Cursor>::NumRef BasicParser<Builder, Cursor>::parseSingleNumExpr(Cursor& itr)
+{
+    run(itr, NUM_EXPR);
+    return pop(numExprs);
+}
+
+template <class Builder, class Cursor>
+typename BasicParser<Builder, Cursor>::BoolRef BasicParser<Builder, Cursor>::parseSingleBoolExpr(Cursor& itr)
+{
+    run(itr, BOOL_EXPR);
+    return pop(boolExprs);
+}
+
+/**
+ * run
+ *
+ * Esegue il lavoro a partire da start finché la pila work non
+ * è vuota; il nodo del simbolo start resta nella sua pila.
+ */
+template <class Builder, class Cursor>
+void BasicParser<Builder, Cursor>::run(Cursor& itr, Task start)
+{
+    work.clear();
+    blocks.clear();
+    statements.clear();
+    numExprs.clear();
+    boolExprs.clear();
+
+    // Il primo sotto-simbolo di un simbolo non passa dalla
+    // pila: il metodo di parsing lo restituisce come prossimo
+    // lavoro (DONE se non ce ne sono)
+    Frame frame{ start, 0, VarRef{}, OpenBlock{} };
+    while (true)
+    {
+        if (frame.task == DONE)
+        {
+            if (work.empty())
+                break;
+            frame = pop(work);
+        }
+        switch (frame.task)
+        {
+        case DONE:
+            break;
+        case STMT_BLOCK:
+            frame.task = parseStmtBlock(itr);
+            continue;
+        case BLOCK:
+            frame.task = parseBlock(itr);
+            continue;
+        case STATEMENT:
+            frame.task = parseStatement(itr);
+            continue;
+        case NUM_EXPR:
+            frame.task = parseNumExpr(itr);
+            continue;
+        case BOOL_EXPR:
+            frame.task = parseBoolExpr(itr);
+            continue;
+        case LAZY_STMT_BLOCK:
+            frame.task = skipStmtBlock(itr);
+            continue;
+
+        // Dopo ogni Statement di un Block: se segue un'altra LP
+        // c'è un altro Statement, altrimenti il Block è concluso
+        case BLOCK_NEXT:
+            nm->appendStatement(frame.block, pop(statements));
+            if (itr->tag == Token::LP)
+            {
+                push(BLOCK_NEXT, 0, VarRef{}, frame.block);
+                frame.task = STATEMENT;
+                continue;
+            }
+            // controlla l'ultima RP e porta l'interatore
+            // sul Token successivo
+            closeWithRP(itr);
+            blocks.push_back(nm->endBlock(frame.block));
+            frame.task = DONE;
+            break;
+
+        // Statement block formato da un solo Statement
+        case SINGLE_STMT_END:
+            nm->appendStatement(frame.block, pop(statements));
+            blocks.push_back(nm->endBlock(frame.block));
+            frame.task = DONE;
+            break;
+
+        // IfStmt: dopo la condizione e i due Block
+        case IF_END:
+        {
+            BlockRef blockElse = pop(blocks);
+            BlockRef blockIf = pop(blocks);
+            BoolRef condition = pop(boolExprs);
+            closeWithRP(itr);
+            statements.push_back(nm->makeIfStmt(condition, blockIf, blockElse));
+            frame.task = DONE;
+            break;
+        }
+
+        // WhileStmt: dopo la condizione e il Block
+        case WHILE_END:
+        {
+            BlockRef block = pop(blocks);
+            BoolRef condition = pop(boolExprs);
+            closeWithRP(itr);
+            statements.push_back(nm->makeWhileStmt(condition, block));
+            frame.task = DONE;
+            break;
+        }
+
+        // SetStmt: dopo l'espressione
+        case SET_END:
+        {
+            NumRef expression = pop(numExprs);
+            closeWithRP(itr);
+            statements.push_back(nm->makeSetStmt(frame.variable, expression));
+            frame.task = DONE;
+            break;
+        }
+
+        // PrintStmt: dopo l'espressione
+        case PRINT_END:
+        {
+            NumRef expression = pop(numExprs);
+            closeWithRP(itr);
+            statements.push_back(nm->makePrintStmt(expression));
+            frame.task = DONE;
+            break;
+        }
+
+        // Operator: dopo i due operandi
+        case OPERATOR_END:
+        {
+            NumRef opRight = pop(numExprs);
+            NumRef opLeft = pop(numExprs);
+            closeWithRP(itr);
+            numExprs.push_back(nm->makeOperator((Operator::OpCode)frame.opCode, opLeft, opRight));
+            frame.task = DONE;
+            break;
+        }
+
+        // BoolOp AND e OR: dopo i due operandi
+        case BOOL_OP_END:
+        {
+            BoolRef opRight = pop(boolExprs);
+            BoolRef opLeft = pop(boolExprs);
+            closeWithRP(itr);
+            boolExprs.push_back(nm->makeBoolOp((BoolOp::OpCode)frame.opCode, opLeft, opRight));
+            frame.task = DONE;
+            break;
+        }
+
+        // BoolOp NOT: dopo l'operando
+        case NOT_END:
+        {
+            BoolRef op = pop(boolExprs);
+            closeWithRP(itr);
+            boolExprs.push_back(nm->makeBoolOp(BoolOp::NOT, op, BoolRef{}));
+            frame.task = DONE;
+            break;
+        }
+
+        // RelOp: dopo i due operandi
+        case REL_OP_END:
+        {
+            NumRef opRight = pop(numExprs);
+            NumRef opLeft = pop(numExprs);
+            closeWithRP(itr);
+            boolExprs.push_back(nm->makeRelOp((RelOp::OpCode)frame.opCode, opLeft, opRight));
+            frame.task = DONE;
+            break;
+        }
+        }
+    }
+}
+
+/**
+ * closeWithRP
+ *
+ * Controlla la RP che chiude un simbolo e porta l'iteratore
+ * sul Token successivo.
+ */
+template <class Builder, class Cursor>
+void BasicParser<Builder, Cursor>::closeWithRP(Cursor& itr)
+{
+    if (itr->tag != Token::RP)
+        throwSyntaxError(*itr, "RP");
+    itr++;
 }
 
 /**
@@ -94,22 +317,21 @@ Block* Parser::operator()(const std::vector<Token>& tokenStream)
  * Effettua il parsing di un Block, i token devono essere:
  * LP BLOCK <Statement> ... <Statement> RP
  */
-Block* Parser::parseBlock(std::vector<Token>::const_iterator& itr,
-    const std::vector<Token>::const_iterator& end)
+template <class Builder, class Cursor>
+typename BasicParser<Builder, Cursor>::Task BasicParser<Builder, Cursor>::parseBlock(Cursor& itr)
 {
     // Controllo prima di non aver ricevuto un iteratore
     // fuori range
-    if (itr == end)
+    if (itr.atEnd())
         throw SyntaxError("Overflow in token stream.");
 
     //std::cout << "PAR: Inside parseBlock" << std::endl;
-    Block* block;
 
     // controlla LP
     if (itr->tag != Token::LP)
         throwSyntaxError(*itr, "LP");
     itr++;
-    if (itr == end)
+    if (itr.atEnd())
         throw SyntaxError("Overflow in token stream.");
     
     // controlla BLOCK
@@ -119,32 +341,20 @@ Block* Parser::parseBlock(std::vector<Token>::const_iterator& itr,
 
     //std::cout << "PAR: BLOCK OK" << std::endl;
 
-    block = nm->makeBlock();
+    OpenBlock block = nm->beginBlock();
 
-    // Il Block non pu essere vuoto, controlla che
+    // Il Block non può essere vuoto, controlla che
     // ci sia almeno uno Statement
     if (itr->tag != Token::LP)
         throwSyntaxError(*itr, "<Statement>");
-    // Non incremento l'indice perch la parentesi
-    // fa parte di Statement, verr controllata da
+    // Non incremento l'indice perché la parentesi
+    // fa parte di Statement, verrà controllata da
     // parseStatement
 
-    // controlla ogni statement che inizia con LP
-    do
-    {
-        //std::cout << "PAR: Parsing new statement inside Block..." << std::endl;
-        block->appendStatement(parseStatement(itr, end));
-    }
-    while (itr->tag == Token::LP);
-
-    // controlla l'ultima RP e porta l'interatore
-    // sul Token successivo
-    if (itr->tag != Token::RP)
-        throwSyntaxError(*itr, "RP");
-    itr++;
-
-    //std::cout << "PAR: Block ended" << std::endl;
-    return block;
+    // dopo ogni statement BLOCK_NEXT controlla se ne
+    // segue un altro
+    push(BLOCK_NEXT, 0, VarRef{}, block);
+    return STATEMENT;
 }
 
 /**
@@ -157,22 +367,26 @@ Block* Parser::parseBlock(std::vector<Token>::const_iterator& itr,
  * - InputStmt: (LP) INPUT VAR RP
  * - SetStmt:   (LP) SET VAR <NumExpr> RP
  * - PrintStmt: (LP) PRINT <NumExpr> RP
+ *
+ * Il primo sotto-simbolo viene restituito come prossimo lavoro,
+ * gli altri vengono messi nella pila work in ordine inverso, in
+ * modo da essere analizzati da sinistra a destra.
  */
-Statement* Parser::parseStatement(std::vector<Token>::const_iterator& itr,
-    const std::vector<Token>::const_iterator& end)
+template <class Builder, class Cursor>
+typename BasicParser<Builder, Cursor>::Task BasicParser<Builder, Cursor>::parseStatement(Cursor& itr)
 {
     //std::cout << "PAR: Inside parseStatement" << std::endl;
     
     // Controllo prima di non aver ricevuto un iteratore
     // fuori range
-    if (itr == end)
+    if (itr.atEnd())
         throw SyntaxError("Overflow in token stream.");
 
     // Controllo LP che apre lo statement
     if (itr->tag != Token::LP)
         throwSyntaxError(*itr, "LP");
     itr++;
-    if (itr == end)
+    if (itr.atEnd())
         throw SyntaxError("Overflow in token stream.");
 
     //std::cout << "PAR: LP OK" << std::endl;
@@ -182,122 +396,79 @@ Statement* Parser::parseStatement(std::vector<Token>::const_iterator& itr,
     if (itr->tag == Token::IF)
     {
         itr++;
-        if (itr == end)
+        if (itr.atEnd())
             throw SyntaxError("Overflow in token stream.");
 
-        // Controllo la condizione (BoolExpr), l'iteratore
-        //  gi sul Token successivo
-        BoolExpr* condition = parseBoolExpr(itr, end);
-
-        // Controllo il primo Block, l'iteratore  gi
-        // sul Token successivo
-        Block* blockIf = parseStmtBlock(itr, end);
-
-        // Controllo il secondo Block, l'iteratore 
-        // gi sul Token successivo
-        Block* blockElse = parseStmtBlock(itr, end);
-
-        // Controllo l'ultima RP che conclude lo
-        // statement e porto l'iteratore sul Token
-        // successivo
-        if (itr->tag != Token::RP)
-            throwSyntaxError(*itr, "RP");
-        itr++;
-        
-        return nm->makeIfStmt(condition, blockIf,
-            blockElse);
+        // Condizione, primo Block, secondo Block e infine
+        // la RP che conclude lo statement
+        // (con il parsing pigro i Block vengono solo saltati)
+        Task body = LAZY_BODIES && loader != nullptr ? LAZY_STMT_BLOCK : STMT_BLOCK;
+        push(IF_END);
+        push(body);
+        push(body);
+        return BOOL_EXPR;
     }
 
     // WhileStmt: WHILE <BoolExpr> <StmtBlock> RP
     if (itr->tag == Token::WHILE)
     {
-        //PrintVisitor pv{};
         itr++;
-        if (itr == end)
+        if (itr.atEnd())
             throw SyntaxError("Overflow in token stream.");
 
-        //std::cout << "PAR: Started to parse WHILE-Statement condition" << std::endl;
-
-        // Controllo la condizione (BoolExpr),
-        // l'iteratore  gi sul Token successivo
-        BoolExpr* condition = parseBoolExpr(itr, end);
-
-        //std::cout << "PAR: Visiting WHILE-Statement condition:" << std::endl;
-        //condition->accept(&pv);
-
-        // Controllo il primo Block, l'iteratore  gi
-        // sul Token successivo
-        Block* block = parseStmtBlock(itr, end);
-
-        // Controllo l'ultima RP che conclude lo
-        // statement e porto l'iteratore sul Token
-        // successivo
-        if (itr->tag != Token::RP)
-            throwSyntaxError(*itr, "RP");
-        itr++;
-
-        WhileStmt* result = nm->makeWhileStmt(condition, block);
-        //std::cout << "PAR: Visiting WHILE-Statement:" << std::endl;
-        //result->accept(&pv);
-        return result;
+        // Condizione, Block e infine la RP che conclude
+        // lo statement
+        push(WHILE_END);
+        push(LAZY_BODIES && loader != nullptr ? LAZY_STMT_BLOCK : STMT_BLOCK);
+        return BOOL_EXPR;
     }
 
     // InputStmt: INPUT VAR RP
     if (itr->tag == Token::INPUT)
     {
         itr++;
-        if (itr == end)
+        if (itr.atEnd())
             throw SyntaxError("Overflow in token stream.");
 
         // Controllo VAR e costruisco il nodo
         if (itr->tag != Token::VAR)
             throwSyntaxError(*itr, "VAR");
         // TODO: Variable ha sempre meno senso
-        Variable* variable = nm->makeVariable(itr->word);
+        VarRef variable = nm->makeVariable(itr->word);
         //std::cout << "PAR: Created Variable with name: " << variable->getName() << std::endl;
         itr++;
-        if (itr == end)
+        if (itr.atEnd())
             throw SyntaxError("Overflow in token stream.");
 
         // Controllo l'ultima RP che conclude lo
         // statement e porto l'iteratore sul token
         // successivo
-        if (itr->tag != Token::RP)
-            throwSyntaxError(*itr, "RP");
-        itr++;
+        closeWithRP(itr);
 
-        return nm->makeInputStmt(variable);
+        statements.push_back(nm->makeInputStmt(variable));
+        return DONE;
     }
 
     // SetStmt:   SET VAR <NumExpr> RP
     if (itr->tag == Token::SET)
     {
         itr++;
-        if (itr == end)
+        if (itr.atEnd())
             throw SyntaxError("Overflow in token stream.");
 
         // Controllo VAR e costruisco il nodo relativo
         if (itr->tag != Token::VAR)
             throwSyntaxError(*itr, "VAR");
         // TODO: Variable ha sempre meno senso
-        Variable* variable = nm->makeVariable(itr->word);
+        VarRef variable = nm->makeVariable(itr->word);
         //std::cout << "PAR: Created Variable with name: " << variable->getName() << std::endl;
         itr++;
-        if (itr == end)
+        if (itr.atEnd())
             throw SyntaxError("Overflow in token stream.");
 
-        // Controllo NumExpr, l'iteratore si trova
-        // gi sul token successivo
-        NumExpr* expression = parseNumExpr(itr, end);
-
-        // Controllo l'ultima RP che conclude lo
-        // statement e porto l'iteratore sul token
-        // successivo
-        if (itr->tag != Token::RP)
-            throwSyntaxError(*itr, "RP");
-        itr++;
-
-        return nm->makeSetStmt(variable, expression);
+        // NumExpr e infine la RP che conclude lo statement
+        push(SET_END, 0, variable);
+        return NUM_EXPR;
     }
 
     // PrintStmt: PRINT <NumExpr> RP
@@ -305,68 +476,96 @@ Statement* Parser::parseStatement(std::vector<Token>::const_iterator& itr,
     {
         //std::cout << "PAR: PRINT Statement recognized" << std::endl;
         itr++;
-        if (itr == end)
+        if (itr.atEnd())
             throw SyntaxError("Overflow in token stream.");
 
-        // Controllo NumExpr, l'iteratore si trova
-        // gi sul token successivo
-        NumExpr* expression = parseNumExpr(itr, end);
-
-        // Controllo l'ultima RP che conclude lo
-        // statement e porto l'iteratore sul token
-        // successivo
-        if (itr->tag != Token::RP)
-            throwSyntaxError(*itr, "RP");
-        itr++;
-
-        return nm->makePrintStmt(expression);
+        // NumExpr e infine la RP che conclude lo statement
+        push(PRINT_END);
+        return NUM_EXPR;
     }
 
     //std::cout << "PAR: Unknown Statement" << std::endl;
     
-    // Se non  nessuno degli Statement gi controllati,
-    // c' un errore di sintassi
+    // Se non è nessuno degli Statement già controllati,
+    // c'è un errore di sintassi
     throwSyntaxError(*itr, "<StmtType>");
 
-    // Per evitare il warning. In realt questo codice
-    //  irraggiungibile perch il metodo sopra lancia
+    // Per evitare il warning. In realtà questo codice
+    // è irraggiungibile perché il metodo sopra lancia
     // un'eccezione, ma il compilatore non lo sa.
-    return nullptr;
+    return DONE;
 }
 
 /**
  * parseStmtBlock
  *
  * Effettua il parsing di uno Statement oppure di un Block,
- * utilizza parseStatement e parseB
+ * utilizza parseStatement e parseBlock
  */
-Block* Parser::parseStmtBlock(std::vector<Token>::const_iterator& itr,
-    const std::vector<Token>::const_iterator& end)
+template <class Builder, class Cursor>
+typename BasicParser<Builder, Cursor>::Task BasicParser<Builder, Cursor>::parseStmtBlock(Cursor& itr)
 {
-    // Prima si aumenta l'iteratore di due per stabilire se
-    // lo statement block  un solo Statement o  un Block,
-    // in modo da chiamare il metodo di parsing adeguato.
-    itr += 1;
-    if (itr == end)
+    // Si guarda il Token successivo per stabilire se lo
+    // statement block è un solo Statement o è un Block, in
+    // modo da chiamare il metodo di parsing adeguato.
+    const Token* next = itr.peekNext();
+    if (next == nullptr)
         throw SyntaxError("Overflow in token stream.");
 
-    if (itr->tag == Token::BLOCK)
+    if (next->tag == Token::BLOCK)
+        return parseBlock(itr);
+
+    // Un solo Statement diventa un Block con un solo
+    // elemento
+    OpenBlock block = nm->beginBlock();
+    push(SINGLE_STMT_END, 0, VarRef{}, block);
+    return STATEMENT;
+}
+
+/**
+ * skipStmtBlock
+ *
+ * Con il parsing pigro salta uno statement block controllando
+ * solo che le parentesi siano bilanciate, e genera un Block
+ * pigro con i Token saltati: il resto della sintassi viene
+ * controllato dal BlockLoader quando il Block viene eseguito.
+ *
+ * Solo i parser con LAZY_BODIES hanno setLazyBodies, quindi
+ * per gli altri loader è sempre nullptr e il metodo non viene
+ * mai chiamato.
+ */
+template <class Builder, class Cursor>
+typename BasicParser<Builder, Cursor>::Task BasicParser<Builder, Cursor>::skipStmtBlock(Cursor& itr)
+{
+    if (itr.peekNext() == nullptr)
+        throw SyntaxError("Overflow in token stream.");
+    if (itr->tag != Token::LP)
+        throwSyntaxError(*itr, "LP");
+
+    // i Token sono nel vettore del Tokenizer, quindi il
+    // loro indirizzo resta valido dopo il parsing
+    const Token* first = &*itr;
+    std::size_t depth = 0;
+    do
     {
-        // L'iteratore si riporta all'inizio per poter usare
-        // il metodo di parsing.
-        itr -= 1;
-        return parseBlock(itr, end);
+        if (itr->tag == Token::LP)
+            depth++;
+        else if (itr->tag == Token::RP)
+            depth--;
+        itr++;
+    } while (depth != 0);
+    // dopo il Block c'è almeno la RP dello statement
+    const Token* last = &*itr;
+
+    if constexpr (LAZY_BODIES)
+    {
+        Block* block = nm->makeBlock();
+        block->defer(loader, first, last);
+        blocks.push_back(block);
     }
-    // L'iteratore si riporta all'inizio per poter usare
-    // il metodo di parsing.
-    itr -= 1;
-
-    Block* block = nm->makeBlock();
-    block->appendStatement(parseStatement(itr, end));
-    //std::cout << "PAR: Block " << block << " now has " << block->getStatements().size() << " Statement(s):" << std::endl;
-    //for (Statement* stmt : block->getStatements())
-    //    std::cout << "at " << stmt << std::endl;
-    return block;
+    else
+        assert(false && "parsing pigro senza LAZY_BODIES");
+    return DONE;
 }
 
 /**
@@ -378,14 +577,14 @@ Block* Parser::parseStmtBlock(std::vector<Token>::const_iterator& itr,
  * - Variable:  VAR
  * - Operator:  LP <opCode> <NumExpr> <NumExpr> RP
  */
-NumExpr* Parser::parseNumExpr(std::vector<Token>::const_iterator& itr,
-    const std::vector<Token>::const_iterator& end)
+template <class Builder, class Cursor>
+typename BasicParser<Builder, Cursor>::Task BasicParser<Builder, Cursor>::parseNumExpr(Cursor& itr)
 {
     //std::cout << "PAR: Parsing NumExpr, received token " << Token::tagToStr(itr->tag) << std::endl;
     
     // Controllo prima di non aver ricevuto un iteratore
     // fuori range
-    if (itr == end)
+    if (itr.atEnd())
         throw SyntaxError("Overflow in token stream.");
 
     // Number
@@ -393,25 +592,24 @@ NumExpr* Parser::parseNumExpr(std::vector<Token>::const_iterator& itr,
     {
         //std::cout << "PAR: Parsing Number, received word " << itr->word << std::endl;
 
-        // conversione creativa
-        std::stringstream buffer;
-        int value;
-        buffer << itr->word;
-        buffer >> value;
+        // il valore è già stato calcolato dal Tokenizer
+        int value = itr->value;
 
         itr++;
 
-        return nm->makeNumber(value);
+        numExprs.push_back(nm->makeNumber(value));
+        return DONE;
     }
 
     // Variable
     if (itr->tag == Token::VAR)
     {
-        Variable* variable = nm->makeVariable(itr->word);
+        VarRef variable = nm->makeVariable(itr->word);
         //std::cout << "PAR: Created Variable with name: " << variable->getName() << std::endl;
         itr++;
 
-        return variable;
+        numExprs.push_back(variable);
+        return DONE;
     }
 
     // Operator
@@ -420,7 +618,7 @@ NumExpr* Parser::parseNumExpr(std::vector<Token>::const_iterator& itr,
     if (itr->tag != Token::LP)
         throwSyntaxError(*itr, "LP");
     itr++;
-    if (itr == end)
+    if (itr.atEnd())
         throw SyntaxError("Overflow in token stream.");
 
     // Controllo <opCode> e creo l'OpCode
@@ -433,23 +631,14 @@ NumExpr* Parser::parseNumExpr(std::vector<Token>::const_iterator& itr,
     Operator::OpCode opCode;
     opCode = Operator::tokenToOpCode(*itr);
     itr++;
-    if (itr == end)
+    if (itr.atEnd())
         throw SyntaxError("Overflow in token stream.");
 
-    // Controllo NumExpr, l'iteratore si trova
-    // gi sul token successivo
-    NumExpr* opLeft = parseNumExpr(itr, end);
-    
-    // Controllo NumExpr, l'iteratore si trova
-    // gi sul token successivo
-    NumExpr* opRight = parseNumExpr(itr, end);
-
-    // Controllo RP che chiude ogni operazione
-    if (itr->tag != Token::RP)
-        throwSyntaxError(*itr, "RP");
-    itr++;
-
-    return nm->makeOperator(opCode, opLeft, opRight);
+    // I due operandi e infine la RP che chiude
+    // l'operazione
+    push(OPERATOR_END, opCode);
+    push(NUM_EXPR);
+    return NUM_EXPR;
 }
 
 /**
@@ -461,25 +650,27 @@ NumExpr* Parser::parseNumExpr(std::vector<Token>::const_iterator& itr,
  * - BoolOp:    LP <opCode> <BoolExpr> <BoolExpr> RP
  * - RelOp:     LP <opCode> <NumExpr> <NumExpr> RP
  */
-BoolExpr* Parser::parseBoolExpr(std::vector<Token>::const_iterator& itr,
-    const std::vector<Token>::const_iterator& end)
+template <class Builder, class Cursor>
+typename BasicParser<Builder, Cursor>::Task BasicParser<Builder, Cursor>::parseBoolExpr(Cursor& itr)
 {
     // Controllo prima di non aver ricevuto un iteratore
     // fuori range
-    if (itr == end)
+    if (itr.atEnd())
         throw SyntaxError("Overflow in token stream.");
 
     // BoolConst
     if (itr->tag == Token::TRUE)
     {
         itr++;
-        return nm->makeBoolConst(true);
+        boolExprs.push_back(nm->makeBoolConst(true));
+        return DONE;
     }
         
     if (itr->tag == Token::FALSE)
     {
         itr++;
-        return nm->makeBoolConst(false);
+        boolExprs.push_back(nm->makeBoolConst(false));
+        return DONE;
     }
 
     // BoolOp e RelOp
@@ -488,67 +679,38 @@ BoolExpr* Parser::parseBoolExpr(std::vector<Token>::const_iterator& itr,
     if (itr->tag != Token::LP)
         throwSyntaxError(*itr, "LP");
     itr++;
-    if (itr == end)
+    if (itr.atEnd())
         throw SyntaxError("Overflow in token stream.");
 
-    //std::cout << "PAR: Parsing an AND or OR BoolOp" << std::endl;
     // BoolOp:  AND <BoolExpr> <BoolExpr> RP
     //          OR <BoolExpr> <BoolExpr> RP
     if ((itr->tag == Token::AND) ||
         (itr->tag == Token::OR))
     {
-        //PrintVisitor pv{};
-        //std::cout << "PAR: Inside " << this << ", with token " << Token::tagToStr(itr->tag) << std::endl;
-
         // opCode
         BoolOp::OpCode opCode;
         opCode = BoolOp::tokenToOpCode(*itr);
         itr++;
-        if (itr == end)
+        if (itr.atEnd())
             throw SyntaxError("Overflow in token stream.");
 
-        //std::cout << "PAR: Operator is " << BoolOp::opCodeToStr(opCode) << std::endl;
-
-        // Primo operando
-        BoolExpr* opLeft = parseBoolExpr(itr, end);
-        //std::cout << "PAR: Visiting opLeft from parseBoolExpr:" << std::endl;
-        //opLeft->accept(&pv);
-
-        // Secondo operando
-        BoolExpr* opRight = parseBoolExpr(itr, end);
-        //std::cout << "PAR: Visiting opRight from parseBoolExpr:" << std::endl;
-        //opRight->accept(&pv);
-
-        //std::cout << "PAR: Created operands " << opLeft << " and " << opRight << std::endl;
-
-        // Controllo RP che chiude ogni operazione
-        if (itr->tag != Token::RP)
-            throwSyntaxError(*itr, "RP");
-        itr++;
-
-        BoolOp* result = nm->makeBoolOp(opCode, opLeft, opRight);
-        //std::cout << "PAR: Operands are " << result->getLeft() << " and " << result->getRight() << std::endl;
-        //std::cout << "PAR: Visiting BoolOp from parseBoolExpr:" << std::endl;
-        //result->accept(&pv);
-        return result;
+        // I due operandi e infine la RP che chiude
+        // l'operazione
+        push(BOOL_OP_END, opCode);
+        push(BOOL_EXPR);
+        return BOOL_EXPR;
     }
 
     // BoolOp:  NOT <BoolExpr> RP
     if (itr->tag == Token::NOT)
     {
         itr++;
-        if (itr == end)
+        if (itr.atEnd())
             throw SyntaxError("Overflow in token stream.");
 
-        // Operando
-        BoolExpr* op = parseBoolExpr(itr, end);
-
-        // Controllo RP che chiude ogni operazione
-        if (itr->tag != Token::RP)
-            throwSyntaxError(*itr, "RP");
-        itr++;
-
-        return nm->makeBoolOp(BoolOp::NOT, op, nullptr);
+        // Operando e infine la RP che chiude l'operazione
+        push(NOT_END);
+        return BOOL_EXPR;
     }
 
     // RelOp:   LT <NumExpr> <NumExpr> RP
@@ -562,29 +724,35 @@ BoolExpr* Parser::parseBoolExpr(std::vector<Token>::const_iterator& itr,
         RelOp::OpCode opCode;
         opCode = RelOp::tokenToOpCode(*itr);
         itr++;
-        if (itr == end)
+        if (itr.atEnd())
             throw SyntaxError("Overflow in token stream.");
 
-        // Primo operando
-        NumExpr* opLeft = parseNumExpr(itr, end);
-
-        // Secondo operando
-        NumExpr* opRight = parseNumExpr(itr, end);
-
-        // Controllo RP che chiude ogni operazione
-        if (itr->tag != Token::RP)
-            throwSyntaxError(*itr, "RP");
-        itr++;
-
-        return nm->makeRelOp(opCode, opLeft, opRight);
+        // I due operandi e infine la RP che chiude
+        // l'operazione
+        push(REL_OP_END, opCode);
+        push(NUM_EXPR);
+        return NUM_EXPR;
     }
 
-    // Se non  nessuno degli OpCode gi controllati,
-    // c' un errore di sintassi
+    // Se non è nessuno degli OpCode già controllati,
+    // c'è un errore di sintassi
     throwSyntaxError(*itr, "<opCode>");
 
-    // Per evitare il warning. In realt questo codice
-    //  irraggiungibile perch il metodo sopra lancia
+    // Per evitare il warning. In realtà questo codice
+    // è irraggiungibile perché il metodo sopra lancia
     // un'eccezione, ma il compilatore non lo sa.
-    return nullptr;
+    return DONE;
 }
+
+
+
+/*
+ * Istanze del parser per i due Builder e i due cursori
+ */
+template class BasicParser<NodeManager, VectorCursor>;
+template class BasicParser<CompactAst, VectorCursor>;
+template class BasicParser<NodeManager, TokenStream>;
+template class BasicParser<CompactAst, TokenStream>;
+template class BasicParser<NodeManager, SourceCursor>;
+template class BasicParser<CompactAst, SourceCursor>;
+template class BasicParser<IncrementalParser::Builder, IncrementalParser::Cursor>;
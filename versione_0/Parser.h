@@ -2,39 +2,138 @@
 #define PARSER_H
 
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "NodeManager.h"
+#include "CompactAst.h"
 #include "Block.h"
 #include "Statement.h"
 #include "NumExpr.h"
 #include "BoolExpr.h"
 #include "Token.h"
+#include "TokenCursor.h"
+#include "TokenStream.h"
+#include "SourceCursor.h"
 
 /**
- * Parser si occupa di fare il parsing di un vettore
- * di Token e di generare la struttura dati per memorizzare
- * in modo ordinato il programma.
+ * BasicParser si occupa di fare il parsing dei Token e di
+ * generare la struttura dati per memorizzare in modo ordinato
+ * il programma.
+ *
+ * I nodi vengono creati da un Builder, che stabilisce anche
+ * il tipo dei riferimenti ai nodi (BlockRef, StmtRef, ...):
+ * - Parser usa NodeManager e genera nodi ordinari
+ * - CompactParser usa CompactAst e genera l'albero compatto
+ * Il parsing e gli errori di sintassi sono gli stessi.
+ *
+ * Il parsing non è ricorsivo: il lavoro ancora da fare è in
+ * una pila esplicita allocata nello heap (work), e i nodi già
+ * costruiti in una pila per ogni tipo di nodo. In questo modo
+ * la profondità di annidamento del programma non è limitata
+ * dalla dimensione dello stack del processo.
+ *
+ * I Token vengono letti da un Cursor:
+ * - VectorCursor scorre il vettore generato dal Tokenizer
+ * - TokenStream genera i Token durante il parsing, leggendo
+ *   il testo a blocchi (StreamParser, CompactStreamParser)
+ * - SourceCursor riconosce i Token nel sorgente in memoria
+ *   durante il parsing, in una sola passata sul testo
+ *   (FusedParser, CompactFusedParser)
  */
-class Parser
+template <class Builder, class Cursor = VectorCursor>
+class BasicParser
 {
 public:
-	Parser(NodeManager* manager) : nm{ manager } {}
-	Block* operator()(const std::vector<Token>& tokenStream);
+	typedef typename Builder::BlockRef BlockRef;
+	typedef typename Builder::StmtRef StmtRef;
+	typedef typename Builder::NumRef NumRef;
+	typedef typename Builder::BoolRef BoolRef;
+	typedef typename Builder::VarRef VarRef;
+	typedef typename Builder::OpenBlock OpenBlock;
+
+	BasicParser(Builder* manager) : nm{ manager } {}
+	BlockRef operator()(Cursor& tokens);
+	// Parsing di un solo Statement (vedi ParallelParser) o di
+	// una sola espressione (vedi IncrementalParser)
+	StmtRef parseSingleStatement(Cursor& tokens);
+	NumRef parseSingleNumExpr(Cursor& tokens);
+	BoolRef parseSingleBoolExpr(Cursor& tokens);
+	// Parsing pigro dei corpi di IfStmt e WhileStmt (vedi
+	// LazyLoader): solo con NodeManager e VectorCursor, perché
+	// i Token devono restare in memoria. Per gli altri parser
+	// setLazyBodies non esiste
+	static constexpr bool LAZY_BODIES =
+		std::is_same<Builder, NodeManager>::value && std::is_same<Cursor, VectorCursor>::value;
+	template <bool Enabled = LAZY_BODIES, typename std::enable_if<Enabled, int>::type = 0>
+	void setLazyBodies(BlockLoader* blockLoader) { loader = blockLoader; }
 private:
-	NodeManager* nm;
+	// Lavoro nella pila work: il parsing di un simbolo oppure
+	// la parte di un simbolo che segue un sotto-simbolo (DONE
+	// indica nessun lavoro)
+	enum Task : unsigned char
+	{
+		DONE, STMT_BLOCK, BLOCK, STATEMENT, NUM_EXPR, BOOL_EXPR,
+		LAZY_STMT_BLOCK, BLOCK_NEXT, SINGLE_STMT_END, IF_END, WHILE_END, SET_END,
+		PRINT_END, OPERATOR_END, BOOL_OP_END, NOT_END, REL_OP_END
+	};
+
+	struct Frame
+	{
+		Task task;
+		int opCode;
+		VarRef variable;
+		OpenBlock block;
+	};
+
+	Builder* nm;
+	BlockLoader* loader = nullptr;
+
+	std::vector<Frame> work;
+	std::vector<BlockRef> blocks;
+	std::vector<StmtRef> statements;
+	std::vector<NumRef> numExprs;
+	std::vector<BoolRef> boolExprs;
 
 	void throwSyntaxError(Token failedToken, std::string expectedToken);
 
-	Block* parseBlock(std::vector<Token>::const_iterator& itr,
-		const std::vector<Token>::const_iterator& end);
-	Statement* parseStatement(std::vector<Token>::const_iterator& itr,
-		const std::vector<Token>::const_iterator& end);
-	Block* parseStmtBlock(std::vector<Token>::const_iterator& itr,
-		const std::vector<Token>::const_iterator& end);
-	NumExpr* parseNumExpr(std::vector<Token>::const_iterator& itr,
-		const std::vector<Token>::const_iterator& end);
-	BoolExpr* parseBoolExpr(std::vector<Token>::const_iterator& itr,
-		const std::vector<Token>::const_iterator& end);
+	void push(Task task, int opCode = 0, VarRef variable = VarRef{}, OpenBlock block = OpenBlock{})
+	{
+		work.push_back(Frame{ task, opCode, variable, block });
+	}
+	template <class T>
+	static T pop(std::vector<T>& stack)
+	{
+		T top = stack.back();
+		stack.pop_back();
+		return top;
+	}
+
+	void run(Cursor& itr, Task start);
+
+	// Ogni metodo restituisce il lavoro da eseguire subito dopo
+	Task parseBlock(Cursor& itr);
+	Task parseStatement(Cursor& itr);
+	Task parseStmtBlock(Cursor& itr);
+	Task skipStmtBlock(Cursor& itr);
+	Task parseNumExpr(Cursor& itr);
+	Task parseBoolExpr(Cursor& itr);
+	void closeWithRP(Cursor& itr);
 };
 
-#endif
\ No newline at end of file
+// Le istanze sono generate in Parser.cpp
+typedef BasicParser<NodeManager> Parser;
+typedef BasicParser<CompactAst> CompactParser;
+typedef BasicParser<NodeManager, TokenStream> StreamParser;
+typedef BasicParser<CompactAst, TokenStream> CompactStreamParser;
+typedef BasicParser<NodeManager, SourceCursor> FusedParser;
+typedef BasicParser<CompactAst, SourceCursor> CompactFusedParser;
+
+extern template class BasicParser<NodeManager, VectorCursor>;
+extern template class BasicParser<CompactAst, VectorCursor>;
+extern template class BasicParser<NodeManager, TokenStream>;
+extern template class BasicParser<CompactAst, TokenStream>;
+extern template class BasicParser<NodeManager, SourceCursor>;
+extern template class BasicParser<CompactAst, SourceCursor>;
+
+#endif
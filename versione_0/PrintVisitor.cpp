@@ -81,9 +81,9 @@ void PrintVisitor::visitWhileStmt(WhileStmt* whileStmtNode)
  * - "(IF "
  * - La BoolExpr
  * - " "
- * - Il Block se BoolExpr  vera
+ * - Il Block se BoolExpr è vera
  * - " "
- * - Il Block se BoolExpr  falsa
+ * - Il Block se BoolExpr è falsa
  * - ") "
  */
 void PrintVisitor::visitIfStmt(IfStmt* ifStmtBlock)
@@ -176,7 +176,7 @@ void PrintVisitor::visitBoolConst(BoolConst* boolConstNode)
  * - La seconda BoolExpr
  * - ")"
  * 
- * oppure se l'operazione  un NOT:
+ * oppure se l'operazione è un NOT:
  * - "(NOT "
  * - La BoolExpr
  * - ")"
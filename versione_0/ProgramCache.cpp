@@ -0,0 +1,436 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "ProgramCache.h"
+#include "SourceFile.h"
+#include "Visitor.h"
+
+const char ProgramCache::magic[8] = { 'L', 'I', 'S', 'P', 'C', 'A', 'C', 'H' };
+
+namespace
+{
+	// Letto come 0x04030201 su una macchina con l'altro
+	// ordine dei byte
+	const std::uint32_t byteOrderMark = 0x01020304;
+
+	/**
+	 * CacheWriter percorre l'albero sintattico e scrive i nodi
+	 * in ordine anticipato nel formato letto da ProgramCache.
+	 * I nomi delle variabili vengono numerati nell'ordine in
+	 * cui compaiono e scritti a parte.
+	 */
+	class CacheWriter : public Visitor
+	{
+	public:
+		std::string nodes;
+		std::string names;
+
+		void visitBlock(Block* blockNode) override
+		{
+			writeKind(NodeManager::BLOCK);
+			write((std::uint32_t)blockNode->getStatements().size());
+			for (Statement* stmt : blockNode->getStatements())
+				stmt->accept(this);
+		}
+
+		void visitPrintStmt(PrintStmt* printStmtNode) override
+		{
+			writeKind(NodeManager::PRINT_STMT);
+			printStmtNode->getPrintValue()->accept(this);
+		}
+		void visitSetStmt(SetStmt* setStmtNode) override
+		{
+			writeKind(NodeManager::SET_STMT);
+			writeName(setStmtNode->getVarId());
+			setStmtNode->getNewValue()->accept(this);
+		}
+		void visitInputStmt(InputStmt* inputStmtNode) override
+		{
+			writeKind(NodeManager::INPUT_STMT);
+			writeName(inputStmtNode->getVarId());
+		}
+		void visitWhileStmt(WhileStmt* whileStmtNode) override
+		{
+			writeKind(NodeManager::WHILE_STMT);
+			whileStmtNode->getCondition()->accept(this);
+			whileStmtNode->getBlock()->accept(this);
+		}
+		void visitIfStmt(IfStmt* ifStmtNode) override
+		{
+			writeKind(NodeManager::IF_STMT);
+			ifStmtNode->getCondition()->accept(this);
+			ifStmtNode->getBlockIf()->accept(this);
+			ifStmtNode->getBlockElse()->accept(this);
+		}
+
+		void visitOperator(Operator* operatorNode) override
+		{
+			writeKind(NodeManager::OPERATOR);
+			write((std::uint8_t)operatorNode->getOp());
+			operatorNode->getLeft()->accept(this);
+			operatorNode->getRight()->accept(this);
+		}
+		void visitNumber(Number* numberNode) override
+		{
+			writeKind(NodeManager::NUMBER);
+			write((std::int32_t)numberNode->getValue());
+		}
+		void visitVariable(Variable* variableNode) override
+		{
+			writeKind(NodeManager::VARIABLE);
+			writeName(variableNode);
+		}
+
+		void visitRelOp(RelOp* relOpNode) override
+		{
+			writeKind(NodeManager::REL_OP);
+			write((std::uint8_t)relOpNode->getOp());
+			relOpNode->getLeft()->accept(this);
+			relOpNode->getRight()->accept(this);
+		}
+		void visitBoolConst(BoolConst* boolConstNode) override
+		{
+			writeKind(NodeManager::BOOL_CONST);
+			write((std::uint8_t)(boolConstNode->getValue() ? 1 : 0));
+		}
+		// NOT ha un solo operando
+		void visitBoolOp(BoolOp* boolOpNode) override
+		{
+			writeKind(NodeManager::BOOL_OP);
+			write((std::uint8_t)boolOpNode->getOp());
+			boolOpNode->getLeft()->accept(this);
+			if (boolOpNode->getOp() != BoolOp::NOT)
+				boolOpNode->getRight()->accept(this);
+		}
+
+		std::uint32_t nameCount() const { return (std::uint32_t)nameIndices.size(); }
+	private:
+		std::unordered_map<std::string, std::uint32_t> nameIndices;
+
+		template <class T>
+		void write(T value)
+		{
+			nodes.append((const char*)&value, sizeof(T));
+		}
+		void writeKind(NodeManager::NodeKind kind) { write((std::uint8_t)kind); }
+
+		// Indice del nome, che viene aggiunto a names se è nuovo
+		void writeName(Variable* variable)
+		{
+			auto inserted = nameIndices.emplace(variable->getName(), (std::uint32_t)nameIndices.size());
+			if (inserted.second)
+			{
+				std::uint32_t length = (std::uint32_t)variable->getName().size();
+				names.append((const char*)&length, sizeof(length));
+				names.append(variable->getName());
+			}
+			write(inserted.first->second);
+		}
+	};
+}
+
+/**
+ * hash
+ *
+ * Combina 8 byte alla volta con una rotazione e una
+ * moltiplicazione, poi i byte rimanenti; basta per
+ * riconoscere un sorgente modificato o un file corrotto, non
+ * per resistere a modifiche fatte apposta.
+ */
+std::uint64_t ProgramCache::hash(std::string_view data)
+{
+	const std::uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+	std::uint64_t h = data.size() * multiplier;
+	std::size_t i = 0;
+	for (; i + 8 <= data.size(); i += 8)
+	{
+		std::uint64_t word;
+		std::memcpy(&word, data.data() + i, 8);
+		h = (((h << 29) | (h >> 35)) ^ word) * multiplier;
+	}
+	for (; i < data.size(); i++)
+		h = (((h << 29) | (h >> 35)) ^ (unsigned char)data[i]) * multiplier;
+	return h ^ (h >> 32);
+}
+
+/**
+ * pathFor
+ *
+ * Nella directory di cache il nome contiene l'hash del
+ * percorso completo del sorgente, in modo che file con lo
+ * stesso nome in directory diverse non si sovrascrivano.
+ */
+std::string ProgramCache::pathFor(const std::string& sourceName, const std::string& directory)
+{
+	if (directory.empty())
+		return sourceName + ".cache";
+
+	std::error_code error;
+	std::filesystem::path fullPath = std::filesystem::absolute(sourceName, error);
+	std::string fullName = error ? sourceName : fullPath.string();
+	std::filesystem::create_directories(directory, error);
+
+	char suffix[20];
+	std::snprintf(suffix, sizeof(suffix), ".%016llx", (unsigned long long)hash(fullName));
+	std::string fileName = std::filesystem::path(sourceName).filename().string() + suffix + ".cache";
+	return (std::filesystem::path(directory) / fileName).string();
+}
+
+/**
+ * load
+ *
+ * Controlla l'intestazione, l'hash del sorgente e il checksum
+ * dei dati, poi ricostruisce i nodi. I nodi già creati prima
+ * di trovare un errore restano nel NodeManager, senza essere
+ * usati.
+ */
+Block* ProgramCache::load(const std::string& path, std::string_view source)
+{
+	SourceFile file{};
+	if (!file.open(path.c_str()))
+		return nullptr;
+	std::string_view data = file.getText();
+	if (data.size() < sizeof(Header))
+		return nullptr;
+
+	Header header;
+	std::memcpy(&header, data.data(), sizeof(Header));
+	if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+		header.version != formatVersion ||
+		header.byteOrder != byteOrderMark ||
+		header.payloadSize != data.size() - sizeof(Header) ||
+		header.sourceSize != source.size())
+		return nullptr;
+
+	if (hashedSource.data() != source.data() || hashedSource.size() != source.size())
+	{
+		sourceHash = hash(source);
+		hashedSource = source;
+	}
+	if (header.sourceHash != sourceHash)
+		return nullptr;
+	std::string_view payload = data.substr(sizeof(Header));
+	if (hash(payload) != header.checksum)
+		return nullptr;
+
+	position = payload.data();
+	end = payload.data() + payload.size();
+	try
+	{
+		std::uint32_t nameCount = read<std::uint32_t>();
+		names.clear();
+		for (std::uint32_t i = 0; i < nameCount; i++)
+		{
+			std::uint32_t length = read<std::uint32_t>();
+			if ((std::size_t)(end - position) < length)
+				throw CorruptCache{};
+			names.emplace_back(position, length);
+			position += length;
+		}
+		if (read<std::uint8_t>() != NodeManager::BLOCK)
+			throw CorruptCache{};
+		Block* program = readBlock();
+		if (position != end)
+			throw CorruptCache{};
+		return program;
+	}
+	catch (CorruptCache)
+	{
+		return nullptr;
+	}
+}
+
+/**
+ * save
+ *
+ * Il file viene scritto con un nome temporaneo e poi
+ * rinominato, in modo che un'altra esecuzione non possa
+ * leggere un file scritto a metà.
+ */
+bool ProgramCache::save(const std::string& path, Block* program, std::string_view source)
+{
+	CacheWriter write{};
+	program->accept(&write);
+
+	std::string payload;
+	std::uint32_t nameCount = write.nameCount();
+	payload.append((const char*)&nameCount, sizeof(nameCount));
+	payload += write.names;
+	payload += write.nodes;
+
+	if (hashedSource.data() != source.data() || hashedSource.size() != source.size())
+	{
+		sourceHash = hash(source);
+		hashedSource = source;
+	}
+	Header header{};
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.version = formatVersion;
+	header.byteOrder = byteOrderMark;
+	header.sourceSize = source.size();
+	header.sourceHash = sourceHash;
+	header.payloadSize = payload.size();
+	header.checksum = hash(payload);
+
+	// il file temporaneo ha il pid nel nome, così due processi
+	// che salvano la stessa cache non scrivono sullo stesso file
+#ifdef _WIN32
+	std::string temporary = path + "." + std::to_string(_getpid()) + ".tmp";
+#else
+	std::string temporary = path + "." + std::to_string(getpid()) + ".tmp";
+#endif
+	{
+		std::ofstream out{ temporary, std::ios::binary | std::ios::trunc };
+		out.write((const char*)&header, sizeof(Header));
+		out.write(payload.data(), payload.size());
+		out.close();
+		if (!out)
+		{
+			std::remove(temporary.c_str());
+			return false;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(temporary, path, error);
+	if (error)
+	{
+		std::remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * LETTURA DEI NODI
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+template <class T>
+T ProgramCache::read()
+{
+	if ((std::size_t)(end - position) < sizeof(T))
+		throw CorruptCache{};
+	T value;
+	std::memcpy(&value, position, sizeof(T));
+	position += sizeof(T);
+	return value;
+}
+
+/**
+ * readBlock
+ *
+ * Il tipo BLOCK è già stato letto: un Block è sempre figlio di
+ * un nodo che ha solo Block in quella posizione.
+ */
+Block* ProgramCache::readBlock()
+{
+	std::uint32_t count = read<std::uint32_t>();
+	if (count == 0)
+		throw CorruptCache{};
+	Block* block = nm->makeBlock();
+	for (std::uint32_t i = 0; i < count; i++)
+		block->appendStatement(readStatement());
+	return block;
+}
+
+Statement* ProgramCache::readStatement()
+{
+	switch (read<std::uint8_t>())
+	{
+	case NodeManager::IF_STMT:
+	{
+		BoolExpr* condition = readBoolExpr();
+		if (read<std::uint8_t>() != NodeManager::BLOCK)
+			throw CorruptCache{};
+		Block* blockIf = readBlock();
+		if (read<std::uint8_t>() != NodeManager::BLOCK)
+			throw CorruptCache{};
+		Block* blockElse = readBlock();
+		return nm->makeIfStmt(condition, blockIf, blockElse);
+	}
+	case NodeManager::WHILE_STMT:
+	{
+		BoolExpr* condition = readBoolExpr();
+		if (read<std::uint8_t>() != NodeManager::BLOCK)
+			throw CorruptCache{};
+		return nm->makeWhileStmt(condition, readBlock());
+	}
+	case NodeManager::INPUT_STMT:
+		return nm->makeInputStmt(readVariable());
+	case NodeManager::SET_STMT:
+	{
+		Variable* variable = readVariable();
+		return nm->makeSetStmt(variable, readNumExpr());
+	}
+	case NodeManager::PRINT_STMT:
+		return nm->makePrintStmt(readNumExpr());
+	}
+	throw CorruptCache{};
+}
+
+NumExpr* ProgramCache::readNumExpr()
+{
+	switch (read<std::uint8_t>())
+	{
+	case NodeManager::OPERATOR:
+	{
+		std::uint8_t op = read<std::uint8_t>();
+		if (op > Operator::DIV)
+			throw CorruptCache{};
+		NumExpr* left = readNumExpr();
+		return nm->makeOperator((Operator::OpCode)op, left, readNumExpr());
+	}
+	case NodeManager::NUMBER:
+		return nm->makeNumber(read<std::int32_t>());
+	case NodeManager::VARIABLE:
+		return readVariable();
+	}
+	throw CorruptCache{};
+}
+
+BoolExpr* ProgramCache::readBoolExpr()
+{
+	switch (read<std::uint8_t>())
+	{
+	case NodeManager::REL_OP:
+	{
+		std::uint8_t op = read<std::uint8_t>();
+		if (op > RelOp::EQ)
+			throw CorruptCache{};
+		NumExpr* left = readNumExpr();
+		return nm->makeRelOp((RelOp::OpCode)op, left, readNumExpr());
+	}
+	case NodeManager::BOOL_OP:
+	{
+		std::uint8_t op = read<std::uint8_t>();
+		if (op > BoolOp::NOT)
+			throw CorruptCache{};
+		BoolExpr* left = readBoolExpr();
+		BoolExpr* right = op == BoolOp::NOT ? nullptr : readBoolExpr();
+		return nm->makeBoolOp((BoolOp::OpCode)op, left, right);
+	}
+	case NodeManager::BOOL_CONST:
+		return nm->makeBoolConst(read<std::uint8_t>() != 0);
+	}
+	throw CorruptCache{};
+}
+
+// Il nome è l'indice nella tabella dei nomi
+Variable* ProgramCache::readVariable()
+{
+	std::uint32_t name = read<std::uint32_t>();
+	if (name >= names.size())
+		throw CorruptCache{};
+	return nm->makeVariable(names[name]);
+}
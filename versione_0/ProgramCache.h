@@ -0,0 +1,97 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Block.h"
+#include "Statement.h"
+#include "NumExpr.h"
+#include "BoolExpr.h"
+#include "NodeManager.h"
+
+/**
+ * ProgramCache salva l'albero sintattico di un programma in un
+ * file binario, in modo che le esecuzioni successive dello
+ * stesso programma non debbano ripetere tokenizzazione e
+ * parsing (--cache, --cache-dir).
+ *
+ * Il file contiene un'intestazione e, dopo, i nomi delle
+ * variabili e i nodi in ordine anticipato (pre-order): un byte
+ * con il tipo del nodo (NodeManager::NodeKind) seguito dai suoi
+ * campi. I figli seguono il padre, quindi non ci sono puntatori
+ * né offset e il file non dipende dall'indirizzo a cui viene
+ * caricato. Gli interi sono scritti nell'ordine dei byte della
+ * macchina, indicato nell'intestazione.
+ *
+ * L'intestazione contiene la versione del formato, la
+ * dimensione e l'hash del sorgente da cui è stato generato, e
+ * il checksum del resto del file. Il file viene letto con una
+ * mappatura in memoria (SourceFile) e i nodi vengono ricostruiti
+ * con un NodeManager in una sola passata; se il file manca, ha
+ * un'altra versione, non corrisponde al sorgente o è corrotto,
+ * load restituisce nullptr e il programma va analizzato e
+ * salvato di nuovo.
+ */
+class ProgramCache
+{
+public:
+	ProgramCache(NodeManager* manager) : nm{ manager } {}
+
+	// Percorso del file di cache per il sorgente sourceName:
+	// accanto al sorgente se directory è vuota, altrimenti in
+	// directory, con un nome che dipende dal percorso completo
+	static std::string pathFor(const std::string& sourceName, const std::string& directory);
+
+	// Restituisce il programma salvato in path, nullptr se il
+	// file non è aggiornato rispetto a source
+	Block* load(const std::string& path, std::string_view source);
+	// Salva program, generato da source, in path; restituisce
+	// false se il file non può essere scritto
+	bool save(const std::string& path, Block* program, std::string_view source);
+
+	// Hash non crittografico, 8 byte alla volta
+	static std::uint64_t hash(std::string_view data);
+private:
+	static const char magic[8];
+	static const std::uint32_t formatVersion = 1;
+
+	struct Header
+	{
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t byteOrder;
+		std::uint64_t sourceSize;
+		std::uint64_t sourceHash;
+		std::uint64_t payloadSize;
+		std::uint64_t checksum;
+	};
+	// l'intestazione viene scritta così com'è, senza spazi
+	static_assert(sizeof(Header) == 48, "unexpected padding in ProgramCache::Header");
+
+	// Lettura dei nodi: ogni metodo legge un nodo e i suoi figli,
+	// e lancia CorruptCache se il file finisce prima o contiene
+	// un valore non valido
+	struct CorruptCache {};
+	Block* readBlock();
+	Statement* readStatement();
+	NumExpr* readNumExpr();
+	BoolExpr* readBoolExpr();
+	Variable* readVariable();
+	template <class T>
+	T read();
+
+	NodeManager* nm;
+	// Posizione di lettura e fine dei dati
+	const char* position = nullptr;
+	const char* end = nullptr;
+	std::vector<std::string_view> names;
+	// hash del sorgente calcolato da load, riusato da save
+	std::string_view hashedSource;
+	std::uint64_t sourceHash = 0;
+};
+
+#endif
@@ -0,0 +1,214 @@
+#include <initializer_list>
+#include <sstream>
+#include <string>
+
+#include "Recognizer.h"
+#include "Exceptions.h"
+
+namespace
+{
+	/*
+	 * Simboli della grammatica nella pila. Il simbolo in cima
+	 * viene sostituito dai simboli della regola scelta in base
+	 * al Token corrente; solo STMT_BLOCK sceglie in base al Token
+	 * successivo (Block se è BLOCK, altrimenti Statement), come
+	 * BasicParser::parseStmtBlock.
+	 */
+	enum Symbol : unsigned char
+	{
+		STMT_BLOCK,		// <StmtBlock>
+		BLOCK_OPEN,		// LP BLOCK ...
+		BLOCK_KEYWORD,	// BLOCK ...
+		BLOCK_BODY,		// <Statement> ... RP, almeno uno Statement
+		BLOCK_NEXT,		// altri Statement oppure RP
+		STATEMENT,		// LP <StmtType> ...
+		STMT_TYPE,		// IF, WHILE, INPUT, SET, PRINT e il resto
+		NUM_EXPR,		// NUM, VAR oppure LP <opCode> ...
+		NUM_OP,			// ADD, SUB, MUL, DIV e il resto
+		BOOL_EXPR,		// TRUE, FALSE oppure LP <opCode> ...
+		BOOL_OP,		// AND, OR, NOT, LT, GT, EQ e il resto
+		EXPECT_VAR,		// VAR
+		EXPECT_RP,		// RP
+		SYMBOL_COUNT
+	};
+
+	// Errori di sintassi, con gli stessi messaggi di
+	// BasicParser::throwSyntaxError
+	enum Error : unsigned char
+	{
+		NO_ERROR, MISSING_LP, MISSING_RP, UNKNOWN_OPCODE, EXPECTED_VAR,
+		EMPTY_BLOCK, BAD_EXPRESSION
+	};
+
+	/*
+	 * Azione per un simbolo e un tipo di Token: l'errore da
+	 * lanciare, oppure se consumare il Token e i simboli da
+	 * mettere al posto del simbolo (il primo finisce in cima)
+	 */
+	struct Rule
+	{
+		Error error;
+		bool consume;
+		unsigned char length;
+		Symbol symbols[4];
+	};
+
+	struct Table
+	{
+		Rule rules[SYMBOL_COUNT][Token::TAG_COUNT];
+	};
+
+	constexpr Rule fail(Error error) { return Rule{ error, false, 0, {} }; }
+	constexpr Rule expand(bool consume) { return Rule{ NO_ERROR, consume, 0, {} }; }
+	constexpr Rule expand(bool consume, Symbol a) { return Rule{ NO_ERROR, consume, 1, { a } }; }
+	constexpr Rule expand(bool consume, Symbol a, Symbol b) { return Rule{ NO_ERROR, consume, 2, { a, b } }; }
+	constexpr Rule expand(bool consume, Symbol a, Symbol b, Symbol c) { return Rule{ NO_ERROR, consume, 3, { a, b, c } }; }
+	constexpr Rule expand(bool consume, Symbol a, Symbol b, Symbol c, Symbol d) { return Rule{ NO_ERROR, consume, 4, { a, b, c, d } }; }
+
+	/*
+	 * La tabella viene calcolata durante la compilazione: ogni
+	 * riga parte dall'errore che BasicParser lancia per un Token
+	 * inatteso, poi vengono scritte le regole dei Token attesi.
+	 */
+	constexpr Table buildTable()
+	{
+		Table t{};
+		Error defaults[SYMBOL_COUNT] = {
+			NO_ERROR, MISSING_LP, BAD_EXPRESSION, EMPTY_BLOCK, MISSING_RP, MISSING_LP,
+			BAD_EXPRESSION, MISSING_LP, UNKNOWN_OPCODE, MISSING_LP, UNKNOWN_OPCODE,
+			EXPECTED_VAR, MISSING_RP
+		};
+		for (int symbol = 0; symbol < SYMBOL_COUNT; symbol++)
+			for (int tag = 0; tag < Token::TAG_COUNT; tag++)
+				t.rules[symbol][tag] = fail(defaults[symbol]);
+
+		// <StmtBlock>, deciso dal Token successivo
+		for (int tag = 0; tag < Token::TAG_COUNT; tag++)
+			t.rules[STMT_BLOCK][tag] = expand(false, STATEMENT);
+		t.rules[STMT_BLOCK][Token::BLOCK] = expand(false, BLOCK_OPEN);
+
+		// Block: LP BLOCK <Statement> ... <Statement> RP
+		t.rules[BLOCK_OPEN][Token::LP] = expand(true, BLOCK_KEYWORD);
+		t.rules[BLOCK_KEYWORD][Token::BLOCK] = expand(true, BLOCK_BODY);
+		t.rules[BLOCK_BODY][Token::LP] = expand(false, STATEMENT, BLOCK_NEXT);
+		t.rules[BLOCK_NEXT][Token::LP] = expand(false, STATEMENT, BLOCK_NEXT);
+		t.rules[BLOCK_NEXT][Token::RP] = expand(true);
+
+		// Statement
+		t.rules[STATEMENT][Token::LP] = expand(true, STMT_TYPE);
+		t.rules[STMT_TYPE][Token::IF] = expand(true, BOOL_EXPR, STMT_BLOCK, STMT_BLOCK, EXPECT_RP);
+		t.rules[STMT_TYPE][Token::WHILE] = expand(true, BOOL_EXPR, STMT_BLOCK, EXPECT_RP);
+		t.rules[STMT_TYPE][Token::INPUT] = expand(true, EXPECT_VAR, EXPECT_RP);
+		t.rules[STMT_TYPE][Token::SET] = expand(true, EXPECT_VAR, NUM_EXPR, EXPECT_RP);
+		t.rules[STMT_TYPE][Token::PRINT] = expand(true, NUM_EXPR, EXPECT_RP);
+
+		// NumExpr
+		t.rules[NUM_EXPR][Token::NUM] = expand(true);
+		t.rules[NUM_EXPR][Token::VAR] = expand(true);
+		t.rules[NUM_EXPR][Token::LP] = expand(true, NUM_OP);
+		for (Token::Tag tag : { Token::ADD, Token::SUB, Token::MUL, Token::DIV })
+			t.rules[NUM_OP][tag] = expand(true, NUM_EXPR, NUM_EXPR, EXPECT_RP);
+
+		// BoolExpr
+		t.rules[BOOL_EXPR][Token::TRUE] = expand(true);
+		t.rules[BOOL_EXPR][Token::FALSE] = expand(true);
+		t.rules[BOOL_EXPR][Token::LP] = expand(true, BOOL_OP);
+		t.rules[BOOL_OP][Token::AND] = expand(true, BOOL_EXPR, BOOL_EXPR, EXPECT_RP);
+		t.rules[BOOL_OP][Token::OR] = expand(true, BOOL_EXPR, BOOL_EXPR, EXPECT_RP);
+		t.rules[BOOL_OP][Token::NOT] = expand(true, BOOL_EXPR, EXPECT_RP);
+		for (Token::Tag tag : { Token::LT, Token::GT, Token::EQ })
+			t.rules[BOOL_OP][tag] = expand(true, NUM_EXPR, NUM_EXPR, EXPECT_RP);
+
+		// Token singoli
+		t.rules[EXPECT_VAR][Token::VAR] = expand(true);
+		t.rules[EXPECT_RP][Token::RP] = expand(true);
+		return t;
+	}
+
+	constexpr Table table = buildTable();
+
+	/**
+	 * throwSyntaxError
+	 *
+	 * Lancia l'errore di sintassi, con il messaggio che lancia
+	 * BasicParser per lo stesso Token.
+	 */
+	[[noreturn]] void throwSyntaxError(const Token& failedToken, Error error)
+	{
+		std::stringstream errorMessage{};
+		switch (error)
+		{
+		case MISSING_LP:
+			errorMessage << "Missing left parenthesis at token ";
+			break;
+		case MISSING_RP:
+			errorMessage << "Missing right parenthesis at token ";
+			break;
+		case UNKNOWN_OPCODE:
+			errorMessage << "Unrecognized operator ";
+			break;
+		case EXPECTED_VAR:
+			errorMessage << "Expected a variable, got ";
+			break;
+		case EMPTY_BLOCK:
+			throw SyntaxError("Empty BLOCK statement");
+		default:
+			errorMessage << "Cannot parse expression at token ";
+			break;
+		}
+		errorMessage << failedToken.word;
+		throw SyntaxError(errorMessage.str());
+	}
+}
+
+/**
+ * operator()
+ *
+ * Riconosce un programma, cioè uno statement block, a partire
+ * dal Token corrente; come in BasicParser i Token che seguono
+ * il programma non vengono letti. Leggere un Token dopo la
+ * fine lancia "Overflow in token stream.", come in BasicParser.
+ */
+template <class Cursor>
+bool BasicRecognizer<Cursor>::operator()(Cursor& itr)
+{
+	if (itr.atEnd())
+		return false;
+
+	stack.clear();
+	stack.push_back(STMT_BLOCK);
+	while (!stack.empty())
+	{
+		Symbol symbol = (Symbol)stack.back();
+		stack.pop_back();
+
+		Token::Tag tag;
+		if (symbol == STMT_BLOCK)
+		{
+			const Token* next = itr.peekNext();
+			if (next == nullptr)
+				throw SyntaxError("Overflow in token stream.");
+			tag = next->tag;
+		}
+		else
+			tag = itr->tag;
+
+		const Rule& rule = table.rules[symbol][tag];
+		if (rule.error != NO_ERROR)
+			throwSyntaxError(*itr, rule.error);
+		if (rule.consume)
+			itr++;
+		for (unsigned char i = rule.length; i > 0; i--)
+			stack.push_back(rule.symbols[i - 1]);
+	}
+	return true;
+}
+
+
+
+/*
+ * Istanze del riconoscitore per i tre cursori
+ */
+template class BasicRecognizer<VectorCursor>;
+template class BasicRecognizer<TokenStream>;
+template class BasicRecognizer<SourceCursor>;
@@ -0,0 +1,53 @@
+#ifndef RECOGNIZER_H
+#define RECOGNIZER_H
+
+#include <vector>
+
+#include "Token.h"
+#include "TokenCursor.h"
+#include "TokenStream.h"
+#include "SourceCursor.h"
+
+/**
+ * BasicRecognizer controlla la sintassi di un programma senza
+ * generare l'albero sintattico, ed è usato da --check.
+ *
+ * È un riconoscitore a pila guidato da una tabella: la pila
+ * contiene i simboli della grammatica ancora da riconoscere, e
+ * per ogni simbolo e tipo di Token la tabella indica se il
+ * Token viene consumato, con quali simboli viene sostituito il
+ * simbolo in cima alla pila, oppure quale errore di sintassi
+ * lanciare. Non vengono creati nodi, e l'unica memoria usata
+ * è la pila, che cresce con l'annidamento del programma.
+ *
+ * I controlli sono fatti nello stesso ordine di BasicParser, e
+ * i messaggi sono gli stessi: un programma è rifiutato con lo
+ * stesso primo errore dell'esecuzione completa.
+ *
+ * I Token vengono letti da un Cursor, come in BasicParser:
+ * - Recognizer scorre il vettore generato dal Tokenizer
+ * - StreamRecognizer legge il file a blocchi (TokenStream)
+ * - FusedRecognizer riconosce i Token nel sorgente in memoria
+ *   (SourceCursor)
+ */
+template <class Cursor = VectorCursor>
+class BasicRecognizer
+{
+public:
+	// Restituisce false se non ci sono Token, come BasicParser
+	// che in quel caso non genera il Block del programma
+	bool operator()(Cursor& tokens);
+private:
+	std::vector<unsigned char> stack;
+};
+
+// Le istanze sono generate in Recognizer.cpp
+typedef BasicRecognizer<VectorCursor> Recognizer;
+typedef BasicRecognizer<TokenStream> StreamRecognizer;
+typedef BasicRecognizer<SourceCursor> FusedRecognizer;
+
+extern template class BasicRecognizer<VectorCursor>;
+extern template class BasicRecognizer<TokenStream>;
+extern template class BasicRecognizer<SourceCursor>;
+
+#endif
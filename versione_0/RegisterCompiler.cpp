@@ -0,0 +1,482 @@
+#include <utility>
+
+#include "RegisterCompiler.h"
+#include "Block.h"
+#include "Statement.h"
+#include "NumExpr.h"
+#include "BoolExpr.h"
+
+/*
+ * Relazioni usate dai salti condizionati, nello stesso ordine
+ * dei codici operativi Jxx_RR e Jxx_RI
+ */
+enum Relation { REL_LT, REL_GT, REL_EQ, REL_GE, REL_LE, REL_NE };
+
+static const RegInstruction::OpCode branchRR[] = {
+	RegInstruction::JLT_RR, RegInstruction::JGT_RR, RegInstruction::JEQ_RR,
+	RegInstruction::JGE_RR, RegInstruction::JLE_RR, RegInstruction::JNE_RR };
+static const RegInstruction::OpCode branchRI[] = {
+	RegInstruction::JLT_RI, RegInstruction::JGT_RI, RegInstruction::JEQ_RI,
+	RegInstruction::JGE_RI, RegInstruction::JLE_RI, RegInstruction::JNE_RI };
+
+// Relazione opposta (a < b falsa <=> a >= b vera)
+static const Relation negated[] = { REL_GE, REL_LE, REL_NE, REL_LT, REL_GT, REL_EQ };
+// Relazione con gli operandi scambiati (a < b <=> b > a)
+static const Relation mirrored[] = { REL_GT, REL_LT, REL_EQ, REL_LE, REL_GE, REL_NE };
+
+/**
+ * operator()
+ *
+ * Compila il programma in due passate: la prima individua le
+ * variabili che possono essere lette prima di essere definite,
+ * la seconda genera il codice definitivo, in cui solo quelle
+ * variabili aggiornano la tabella delle variabili definite.
+ */
+RegisterProgram RegisterCompiler::operator()(Block* root)
+{
+	program = RegisterProgram{};
+	program.variableNames = symbols->getNames();
+	needsCheck.assign(symbols->size(), false);
+
+	// I temporanei seguono le variabili
+	firstTemp = (int)symbols->size();
+
+	// Prima passata
+	finalPass = false;
+	compileProgram(root);
+
+	// Seconda passata
+	finalPass = true;
+	compileProgram(root);
+
+	program.numRegisters = firstTemp + (int)tempBusy.size();
+	return std::move(program);
+}
+
+/**
+ * compileProgram
+ *
+ * Traduce il programma a partire da uno stato vuoto: nessuna
+ * variabile assegnata e nessun temporaneo occupato.
+ */
+void RegisterCompiler::compileProgram(Block* root)
+{
+	program.code.clear();
+	assigned.assign(symbols->size(), false);
+	tempBusy.clear();
+
+	root->accept(this);
+	emit(RegInstruction::HALT, 0, 0, 0);
+}
+
+/**
+ * compileNumExpr
+ *
+ * Traduce una NumExpr e restituisce l'operando che ne contiene
+ * il valore. Se destination >= 0 e l'espressione è un Operator,
+ * il risultato viene scritto direttamente in quel registro.
+ */
+RegisterCompiler::Operand RegisterCompiler::compileNumExpr(NumExpr* expression, int dst)
+{
+	destination = dst;
+	expression->accept(this);
+	destination = -1;
+	return result;
+}
+
+/**
+ * compileBranch
+ *
+ * Traduce una BoolExpr in salti condizionati: il codice
+ * generato salta se la condizione vale jumpWhen, altrimenti
+ * prosegue con l'istruzione successiva. Gli indici dei salti
+ * da completare vengono aggiunti a jumps.
+ */
+void RegisterCompiler::compileBranch(BoolExpr* condition, bool jumpWhen, std::vector<int>& jumps)
+{
+	branchWhen = jumpWhen;
+	branchJumps = &jumps;
+	condition->accept(this);
+}
+
+/**
+ * patchJumps
+ *
+ * Completa i salti facendoli puntare all'istruzione target.
+ */
+void RegisterCompiler::patchJumps(const std::vector<int>& jumps, int target)
+{
+	for (int jump : jumps)
+		program.code[jump].dst = target;
+}
+
+/**
+ * emit
+ *
+ * Aggiunge un'istruzione e ne restituisce la posizione.
+ */
+int RegisterCompiler::emit(RegInstruction::OpCode op, int dst, int a, int b)
+{
+	program.code.push_back(RegInstruction{ op, dst, a, b });
+	return (int)program.code.size() - 1;
+}
+
+/**
+ * checkVariable
+ *
+ * Prima della lettura di una variabile che potrebbe non essere
+ * ancora definita viene emesso un CHECK; superato il controllo
+ * la variabile è sicuramente definita.
+ */
+void RegisterCompiler::checkVariable(int reg)
+{
+	if (assigned[reg])
+		return;
+	emit(RegInstruction::CHECK, 0, reg, 0);
+	if (!finalPass)
+		needsCheck[reg] = true;
+	assigned[reg] = true;
+}
+
+/**
+ * defineVariable
+ *
+ * Dopo una scrittura la variabile è sicuramente definita. La
+ * tabella delle variabili definite viene aggiornata (DEF) solo
+ * per le variabili controllate da qualche CHECK, e solo se
+ * la variabile potrebbe non essere già definita.
+ */
+void RegisterCompiler::defineVariable(int reg)
+{
+	if (finalPass && needsCheck[reg] && !assigned[reg])
+		emit(RegInstruction::DEF, reg, 0, 0);
+	assigned[reg] = true;
+}
+
+/**
+ * allocTemp
+ *
+ * Restituisce il primo registro temporaneo libero.
+ */
+int RegisterCompiler::allocTemp()
+{
+	for (int i = 0; i < (int)tempBusy.size(); i++)
+	{
+		if (!tempBusy[i])
+		{
+			tempBusy[i] = true;
+			return firstTemp + i;
+		}
+	}
+	tempBusy.push_back(true);
+	return firstTemp + (int)tempBusy.size() - 1;
+}
+
+/**
+ * freeOperand
+ *
+ * Se l'operando è un temporaneo, il suo intervallo di vita è
+ * terminato e il registro torna disponibile.
+ */
+void RegisterCompiler::freeOperand(Operand operand)
+{
+	if (!operand.immediate && operand.value >= firstTemp)
+		tempBusy[operand.value - firstTemp] = false;
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * REGISTERCOMPILER PER BLOCK E STATEMENTS
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * Un blocco si traduce concatenando i suoi statement
+ */
+void RegisterCompiler::visitBlock(Block* blockNode)
+{
+	for (Statement* stmt : blockNode->getStatements())
+		stmt->accept(this);
+}
+
+/**
+ * Un IF-Statement si traduce in:
+ *      <salta a else se la condizione è falsa>
+ *      <blocco if>
+ *      JUMP end
+ * else:
+ *      <blocco else>
+ * end:
+ *
+ * Dopo l'IF sono sicuramente assegnate le variabili assegnate
+ * in entrambi i rami.
+ */
+void RegisterCompiler::visitIfStmt(IfStmt* ifStmtNode)
+{
+	std::vector<int> jumpsElse;
+	compileBranch(ifStmtNode->getCondition(), false, jumpsElse);
+	std::vector<bool> assignedBefore = assigned;
+
+	ifStmtNode->getBlockIf()->accept(this);
+	std::vector<bool> assignedIf = assigned;
+	int jumpEnd = emit(RegInstruction::JUMP, -1, 0, 0);
+
+	patchJumps(jumpsElse, (int)program.code.size());
+	assigned = assignedBefore;
+	ifStmtNode->getBlockElse()->accept(this);
+
+	patchJumps({ jumpEnd }, (int)program.code.size());
+	for (int reg = 0; reg < (int)assigned.size(); reg++)
+		assigned[reg] = assigned[reg] && assignedIf[reg];
+}
+
+/**
+ * Un WHILE-Statement si traduce con la condizione in fondo,
+ * in modo da eseguire un solo salto per ogni iterazione:
+ *      JUMP cond
+ * body:
+ *      <blocco>
+ * cond:
+ *      <salta a body se la condizione è vera>
+ *
+ * Il blocco potrebbe non essere mai eseguito, quindi le sue
+ * assegnazioni non valgono dopo il WHILE.
+ */
+void RegisterCompiler::visitWhileStmt(WhileStmt* whileStmtNode)
+{
+	int jumpCond = emit(RegInstruction::JUMP, -1, 0, 0);
+	std::vector<bool> assignedBefore = assigned;
+
+	int bodyStart = (int)program.code.size();
+	whileStmtNode->getBlock()->accept(this);
+
+	patchJumps({ jumpCond }, (int)program.code.size());
+	assigned = assignedBefore;
+	std::vector<int> jumpsBody;
+	compileBranch(whileStmtNode->getCondition(), true, jumpsBody);
+	patchJumps(jumpsBody, bodyStart);
+}
+
+/**
+ * Un INPUT-Statement si traduce in INPUT variabile
+ */
+void RegisterCompiler::visitInputStmt(InputStmt* inputStmtNode)
+{
+	int reg = inputStmtNode->getVarId()->getSlot();
+	emit(RegInstruction::INPUT, reg, 0, 0);
+	defineVariable(reg);
+}
+
+/**
+ * Un SET-Statement scrive il risultato dell'espressione
+ * direttamente nel registro della variabile, per esempio
+ * (SET i (ADD i 1)) diventa ADD_RI i, i, #1.
+ * Se l'espressione è una costante o un'altra variabile si usa
+ * LOADI o MOV.
+ */
+void RegisterCompiler::visitSetStmt(SetStmt* setStmtNode)
+{
+	int reg = setStmtNode->getVarId()->getSlot();
+	Operand value = compileNumExpr(setStmtNode->getNewValue(), reg);
+
+	if (value.immediate)
+		emit(RegInstruction::LOADI, reg, value.value, 0);
+	else if (value.value != reg)
+		emit(RegInstruction::MOV, reg, value.value, 0);
+
+	defineVariable(reg);
+}
+
+/**
+ * Un PRINT-Statement si traduce in PRINT_R o PRINT_I
+ */
+void RegisterCompiler::visitPrintStmt(PrintStmt* printStmtNode)
+{
+	Operand value = compileNumExpr(printStmtNode->getPrintValue(), -1);
+	freeOperand(value);
+
+	if (value.immediate)
+		emit(RegInstruction::PRINT_I, 0, value.value, 0);
+	else
+		emit(RegInstruction::PRINT_R, 0, value.value, 0);
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * REGISTERCOMPILER PER ESPRESSIONI NUMERICHE E BOOLEANE
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * Un Operator si traduce in una sola istruzione che legge i
+ * due operandi e scrive il risultato nel registro di
+ * destinazione (o in un nuovo temporaneo).
+ */
+void RegisterCompiler::visitOperator(Operator* operatorNode)
+{
+	int dst = destination;
+	Operand left = compileNumExpr(operatorNode->getLeft(), -1);
+	Operand right = compileNumExpr(operatorNode->getRight(), -1);
+
+	// i temporanei degli operandi vengono letti dall'istruzione
+	// stessa, quindi possono già essere riusati come destinazione
+	freeOperand(left);
+	freeOperand(right);
+	if (dst < 0)
+		dst = allocTemp();
+
+	// due costanti: la prima viene caricata nella destinazione
+	if (left.immediate && right.immediate)
+	{
+		emit(RegInstruction::LOADI, dst, left.value, 0);
+		left = Operand{ false, dst };
+	}
+
+	RegInstruction::OpCode rr, ri, ir;
+	switch (operatorNode->getOp())
+	{
+	case Operator::PLUS:
+		rr = RegInstruction::ADD_RR; ri = RegInstruction::ADD_RI; ir = RegInstruction::ADD_RI;
+		break;
+	case Operator::MINUS:
+		rr = RegInstruction::SUB_RR; ri = RegInstruction::SUB_RI; ir = RegInstruction::SUB_IR;
+		break;
+	case Operator::TIMES:
+		rr = RegInstruction::MUL_RR; ri = RegInstruction::MUL_RI; ir = RegInstruction::MUL_RI;
+		break;
+	default:
+		rr = RegInstruction::DIV_RR; ri = RegInstruction::DIV_RI; ir = RegInstruction::DIV_IR;
+		break;
+	}
+
+	if (!left.immediate && !right.immediate)
+		emit(rr, dst, left.value, right.value);
+	else if (right.immediate)
+		emit(ri, dst, left.value, right.value);
+	else if (ir == ri)
+		// ADD e MUL sono commutative, basta scambiare gli operandi
+		emit(ri, dst, right.value, left.value);
+	else
+		emit(ir, dst, left.value, right.value);
+
+	result = Operand{ false, dst };
+}
+
+/**
+ * Un Number è un operando costante, non genera istruzioni
+ */
+void RegisterCompiler::visitNumber(Number* numberNode)
+{
+	result = Operand{ true, numberNode->getValue() };
+}
+
+/**
+ * Una Variable è un operando registro, preceduto da un CHECK
+ * se la variabile potrebbe non essere definita
+ */
+void RegisterCompiler::visitVariable(Variable* variableNode)
+{
+	int reg = variableNode->getSlot();
+	checkVariable(reg);
+	result = Operand{ false, reg };
+}
+
+/**
+ * Un RelOp si traduce in un confronto con salto, la relazione
+ * viene negata se il salto va eseguito quando è falsa.
+ */
+void RegisterCompiler::visitRelOp(RelOp* relOpNode)
+{
+	bool jumpWhen = branchWhen;
+	std::vector<int>& jumps = *branchJumps;
+
+	Operand left = compileNumExpr(relOpNode->getLeft(), -1);
+	Operand right = compileNumExpr(relOpNode->getRight(), -1);
+	freeOperand(left);
+	freeOperand(right);
+
+	Relation relation;
+	switch (relOpNode->getOp())
+	{
+	case RelOp::LT:
+		relation = REL_LT;
+		break;
+	case RelOp::GT:
+		relation = REL_GT;
+		break;
+	default:
+		relation = REL_EQ;
+		break;
+	}
+	if (!jumpWhen)
+		relation = negated[relation];
+
+	// due costanti: la prima viene caricata in un temporaneo
+	if (left.immediate && right.immediate)
+	{
+		int temp = allocTemp();
+		emit(RegInstruction::LOADI, temp, left.value, 0);
+		left = Operand{ false, temp };
+		freeOperand(left);
+	}
+	// costante a sinistra: si scambiano gli operandi
+	else if (left.immediate)
+	{
+		std::swap(left, right);
+		relation = mirrored[relation];
+	}
+
+	if (right.immediate)
+		jumps.push_back(emit(branchRI[relation], -1, left.value, right.value));
+	else
+		jumps.push_back(emit(branchRR[relation], -1, left.value, right.value));
+}
+
+/**
+ * Una BoolConst salta sempre o non salta mai
+ */
+void RegisterCompiler::visitBoolConst(BoolConst* boolConstNode)
+{
+	if ((bool)boolConstNode->getValue() == branchWhen)
+		branchJumps->push_back(emit(RegInstruction::JUMP, -1, 0, 0));
+}
+
+/**
+ * Un BoolOp si traduce componendo i salti dei suoi operandi:
+ * - NOT: salta quando l'operando vale il contrario
+ * - AND: se deve saltare quando è falso, salta quando uno dei
+ *   due operandi è falso; se deve saltare quando è vero, salta
+ *   oltre il secondo operando quando il primo è falso
+ * - OR: simmetrico ad AND
+ *
+ * Il secondo operando viene valutato solo se il primo non
+ * determina il risultato (cortocircuitazione), quindi le
+ * variabili controllate al suo interno non sono sicuramente
+ * definite dopo l'espressione.
+ */
+void RegisterCompiler::visitBoolOp(BoolOp* boolOpNode)
+{
+	bool jumpWhen = branchWhen;
+	std::vector<int>& jumps = *branchJumps;
+
+	if (boolOpNode->getOp() == BoolOp::NOT)
+	{
+		compileBranch(boolOpNode->getLeft(), !jumpWhen, jumps);
+		return;
+	}
+
+	// AND si cortocircuita quando il primo operando è falso,
+	// OR quando è vero
+	bool shortCircuit = (boolOpNode->getOp() == BoolOp::OR);
+	std::vector<int> skip;
+	if (jumpWhen == shortCircuit)
+		compileBranch(boolOpNode->getLeft(), shortCircuit, jumps);
+	else
+		compileBranch(boolOpNode->getLeft(), shortCircuit, skip);
+
+	std::vector<bool> assignedBefore = assigned;
+	compileBranch(boolOpNode->getRight(), jumpWhen, jumps);
+	assigned = assignedBefore;
+
+	patchJumps(skip, (int)program.code.size());
+}
@@ -0,0 +1,93 @@
+#ifndef REGISTER_COMPILER_H
+#define REGISTER_COMPILER_H
+
+#include <vector>
+
+#include "Visitor.h"
+#include "RegisterProgram.h"
+#include "SymbolTable.h"
+
+/**
+ * RegisterCompiler traduce l'albero sintattico del programma
+ * in istruzioni per RegisterVM.
+ *
+ * - Le variabili occupano un registro fisso ciascuna: il
+ *   registro è lo slot assegnato da SymbolResolver.
+ * - I risultati intermedi delle NumExpr occupano registri
+ *   temporanei, assegnati con un'allocazione linear-scan: ogni
+ *   temporaneo vive dall'istruzione che lo scrive a quella che
+ *   lo legge, poi il registro torna libero per i successivi.
+ * - Le BoolExpr non producono valori ma salti condizionati
+ *   (con la cortocircuitazione di AND e OR).
+ * - Una variabile viene controllata a runtime (CHECK) solo se
+ *   può essere letta prima di essere stata definita: il
+ *   compilatore tiene traccia delle variabili sicuramente
+ *   assegnate in ogni punto del programma.
+ */
+class RegisterCompiler : public Visitor
+{
+public:
+	RegisterCompiler(const SymbolTable* st) : symbols{ st } {}
+
+	RegisterProgram operator()(Block* program);
+
+	void visitBlock(Block* blockNode) override;
+
+	void visitPrintStmt(PrintStmt* printStmtNode) override;
+	void visitSetStmt(SetStmt* setStmtNode) override;
+	void visitInputStmt(InputStmt* inputStmtNode) override;
+	void visitWhileStmt(WhileStmt* whileStmtNode) override;
+	void visitIfStmt(IfStmt* ifStmtBlock) override;
+
+	void visitOperator(Operator* operatorNode) override;
+	void visitNumber(Number* numberNode) override;
+	void visitVariable(Variable* variableNode) override;
+
+	void visitRelOp(RelOp* relOpNode) override;
+	void visitBoolConst(BoolConst* boolConstNode) override;
+	void visitBoolOp(BoolOp* boolOpNode) override;
+private:
+	// Operando di un'istruzione: registro o costante
+	struct Operand
+	{
+		bool immediate;
+		int value;
+	};
+
+	void compileProgram(Block* program);
+	Operand compileNumExpr(NumExpr* expression, int destination);
+	void compileBranch(BoolExpr* condition, bool jumpWhen, std::vector<int>& jumps);
+	void patchJumps(const std::vector<int>& jumps, int target);
+
+	int emit(RegInstruction::OpCode op, int dst, int a, int b);
+	void checkVariable(int reg);
+	void defineVariable(int reg);
+	int allocTemp();
+	void freeOperand(Operand operand);
+
+	const SymbolTable* symbols;
+	RegisterProgram program;
+
+	// Variabili che richiedono il controllo a runtime, calcolate
+	// dalla prima passata di compilazione
+	std::vector<bool> needsCheck;
+	bool finalPass = false;
+	// Variabili sicuramente assegnate nel punto corrente
+	std::vector<bool> assigned;
+
+	// Registri temporanei occupati, l'indice è relativo al primo
+	// temporaneo
+	std::vector<bool> tempBusy;
+	int firstTemp = 0;
+
+	// Parametri e risultato della visita delle espressioni:
+	// le NumExpr scrivono in result (in destination se >= 0),
+	// le BoolExpr aggiungono a branchJumps i salti da eseguire
+	// se la condizione vale branchWhen
+	Operand result{ true, 0 };
+	int destination = -1;
+	bool branchWhen = false;
+	std::vector<int>* branchJumps = nullptr;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef REGISTER_PROGRAM_H
+#define REGISTER_PROGRAM_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Istruzione della macchina a registri (RegisterVM).
+ *
+ * Ogni istruzione nomina direttamente i suoi operandi, per
+ * esempio (SET i (ADD i 1)) diventa ADD_RI r_i, r_i, #1.
+ * Il suffisso del codice operativo indica il tipo degli
+ * operandi a e b:
+ * - R: registro (variabile o temporaneo)
+ * - I: costante intera
+ *
+ * I registri 0 .. numVariables-1 contengono le variabili del
+ * programma, i successivi i valori temporanei assegnati da
+ * RegisterCompiler.
+ *
+ * Nei salti condizionati dst è la destinazione (indice
+ * assoluto dell'istruzione): Jxx salta se a xx b è vera.
+ */
+struct RegInstruction
+{
+	// L'ordine deve corrispondere alla tabella di dispatch
+	// di RegisterVM
+	enum OpCode : unsigned char {
+		MOV, LOADI, CHECK, DEF, INPUT, PRINT_R, PRINT_I,
+		ADD_RR, ADD_RI, SUB_RR, SUB_RI, SUB_IR,
+		MUL_RR, MUL_RI, DIV_RR, DIV_RI, DIV_IR,
+		JLT_RR, JLT_RI, JGT_RR, JGT_RI, JEQ_RR, JEQ_RI,
+		JGE_RR, JGE_RI, JLE_RR, JLE_RI, JNE_RR, JNE_RI,
+		JUMP, HALT };
+
+	RegInstruction(OpCode o, int d, int x, int y) :
+		op{ o }, dst{ d }, a{ x }, b{ y } {}
+
+	OpCode op;
+	int dst;
+	int a;
+	int b;
+};
+
+/**
+ * Programma compilato da RegisterCompiler, contiene:
+ * - Il flusso di istruzioni, terminato da HALT
+ * - I nomi delle variabili, nell'ordine dei registri
+ * - Il numero totale di registri (variabili e temporanei)
+ */
+struct RegisterProgram
+{
+	std::vector<RegInstruction> code;
+	std::vector<std::string> variableNames;
+	int numRegisters = 0;
+};
+
+#endif
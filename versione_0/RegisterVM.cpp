@@ -0,0 +1,160 @@
+#include <vector>
+
+#include "RegisterVM.h"
+#include "RegisterProgram.h"
+#include "Runtime.h"
+
+/*
+ * Macro per il ciclo di esecuzione: con il computed goto ogni
+ * istruzione salta direttamente all'etichetta della successiva,
+ * altrimenti si torna allo switch in testa al ciclo.
+ */
+#ifdef REGISTERVM_COMPUTED_GOTO
+#define VM_DISPATCH() goto *dispatchTable[pc->op]
+#define VM_CASE(name) label_##name:
+#define VM_LOOP_BEGIN VM_DISPATCH();
+#define VM_LOOP_END
+#else
+#define VM_DISPATCH() continue
+#define VM_CASE(name) case RegInstruction::name:
+#define VM_LOOP_BEGIN for (;;) { switch (pc->op) {
+#define VM_LOOP_END } }
+#endif
+
+// Operazioni aritmetiche e salti condizionati, per ogni
+// combinazione di operandi registro (R) e costante (I)
+#define VM_ARITH(name, expr) \
+	VM_CASE(name) \
+		r[pc->dst] = (expr); \
+		pc++; \
+		VM_DISPATCH();
+
+#define VM_BRANCH(name, cond) \
+	VM_CASE(name) \
+		if (cond) \
+			pc = code + pc->dst; \
+		else \
+			pc++; \
+		VM_DISPATCH();
+
+/**
+ * operator()
+ *
+ * Esegue il programma a partire dalla prima istruzione fino
+ * a HALT.
+ */
+void RegisterVM::operator()(const RegisterProgram& program)
+{
+	std::vector<int> registers(program.numRegisters);
+	std::vector<unsigned char> defined(program.variableNames.size(), 0);
+
+	const RegInstruction* code = program.code.data();
+	const RegInstruction* pc = code;
+	int* r = registers.data();
+
+#ifdef REGISTERVM_COMPUTED_GOTO
+	// Stesso ordine di RegInstruction::OpCode
+	static void* const dispatchTable[] = {
+		&&label_MOV, &&label_LOADI, &&label_CHECK, &&label_DEF,
+		&&label_INPUT, &&label_PRINT_R, &&label_PRINT_I,
+		&&label_ADD_RR, &&label_ADD_RI, &&label_SUB_RR,
+		&&label_SUB_RI, &&label_SUB_IR, &&label_MUL_RR,
+		&&label_MUL_RI, &&label_DIV_RR, &&label_DIV_RI,
+		&&label_DIV_IR, &&label_JLT_RR, &&label_JLT_RI,
+		&&label_JGT_RR, &&label_JGT_RI, &&label_JEQ_RR,
+		&&label_JEQ_RI, &&label_JGE_RR, &&label_JGE_RI,
+		&&label_JLE_RR, &&label_JLE_RI, &&label_JNE_RR,
+		&&label_JNE_RI, &&label_JUMP, &&label_HALT
+	};
+#endif
+
+	VM_LOOP_BEGIN
+
+	VM_CASE(MOV)
+		r[pc->dst] = r[pc->a];
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(LOADI)
+		r[pc->dst] = pc->a;
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(CHECK)
+		if (!defined[pc->a])
+			Runtime::throwUndefinedVariable(program.variableNames[pc->a]);
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(DEF)
+		defined[pc->dst] = 1;
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(INPUT)
+		r[pc->dst] = Runtime::readInput();
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(PRINT_R)
+		Runtime::print(r[pc->a]);
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(PRINT_I)
+		Runtime::print(pc->a);
+		pc++;
+		VM_DISPATCH();
+
+	VM_ARITH(ADD_RR, r[pc->a] + r[pc->b])
+	VM_ARITH(ADD_RI, r[pc->a] + pc->b)
+	VM_ARITH(SUB_RR, r[pc->a] - r[pc->b])
+	VM_ARITH(SUB_RI, r[pc->a] - pc->b)
+	VM_ARITH(SUB_IR, pc->a - r[pc->b])
+	VM_ARITH(MUL_RR, r[pc->a] * r[pc->b])
+	VM_ARITH(MUL_RI, r[pc->a] * pc->b)
+
+	// La divisione per 0 non è ammessa
+	VM_CASE(DIV_RR)
+		if (r[pc->b] == 0)
+			Runtime::throwDivisionByZero();
+		r[pc->dst] = r[pc->a] / r[pc->b];
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(DIV_RI)
+		if (pc->b == 0)
+			Runtime::throwDivisionByZero();
+		r[pc->dst] = r[pc->a] / pc->b;
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(DIV_IR)
+		if (r[pc->b] == 0)
+			Runtime::throwDivisionByZero();
+		r[pc->dst] = pc->a / r[pc->b];
+		pc++;
+		VM_DISPATCH();
+
+	VM_BRANCH(JLT_RR, r[pc->a] < r[pc->b])
+	VM_BRANCH(JLT_RI, r[pc->a] < pc->b)
+	VM_BRANCH(JGT_RR, r[pc->a] > r[pc->b])
+	VM_BRANCH(JGT_RI, r[pc->a] > pc->b)
+	VM_BRANCH(JEQ_RR, r[pc->a] == r[pc->b])
+	VM_BRANCH(JEQ_RI, r[pc->a] == pc->b)
+	VM_BRANCH(JGE_RR, r[pc->a] >= r[pc->b])
+	VM_BRANCH(JGE_RI, r[pc->a] >= pc->b)
+	VM_BRANCH(JLE_RR, r[pc->a] <= r[pc->b])
+	VM_BRANCH(JLE_RI, r[pc->a] <= pc->b)
+	VM_BRANCH(JNE_RR, r[pc->a] != r[pc->b])
+	VM_BRANCH(JNE_RI, r[pc->a] != pc->b)
+
+	VM_CASE(JUMP)
+		pc = code + pc->dst;
+		VM_DISPATCH();
+
+	VM_CASE(HALT)
+		return;
+
+	VM_LOOP_END
+}
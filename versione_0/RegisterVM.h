@@ -0,0 +1,29 @@
+#ifndef REGISTER_VM_H
+#define REGISTER_VM_H
+
+#include "RegisterProgram.h"
+
+// Con GCC e Clang il ciclo di esecuzione usa il computed goto
+// (goto *etichetta), altrimenti uno switch dentro un ciclo
+#if defined(__GNUC__) || defined(__clang__)
+#define REGISTERVM_COMPUTED_GOTO
+#endif
+
+/**
+ * RegisterVM esegue un programma compilato da RegisterCompiler.
+ *
+ * I registri sono un vettore di interi allocato una sola volta
+ * prima dell'esecuzione; una seconda tabella indica quali
+ * variabili sono state definite, ed è consultata solo dalle
+ * istruzioni CHECK.
+ * Gli errori di esecuzione (variabili non definite, divisione
+ * per 0, input non valido) sono gli stessi di ExecutionVisitor.
+ */
+class RegisterVM
+{
+public:
+	// uso costruttori e distruttore di default
+	void operator()(const RegisterProgram& program);
+};
+
+#endif
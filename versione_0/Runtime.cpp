@@ -0,0 +1,63 @@
+#include <iostream>
+#include <string>
+#include <sstream>
+
+#include "Runtime.h"
+#include "Exceptions.h"
+
+/**
+ * readInput
+ *
+ * Riceve un input da tastiera e lo converte in un intero.
+ * Se la conversione fallisce lancia un InputError.
+ */
+int Runtime::readInput()
+{
+	std::string inputString;
+	std::cin >> inputString;
+	try
+	{
+		return std::stoi(inputString);
+	}
+	catch (std::exception& e)
+	{
+		std::stringstream errorMessage;
+		errorMessage << inputString;
+		errorMessage << " is not a valid variable value, must be an integer number";
+		throw InputError(errorMessage.str());
+	}
+}
+
+/**
+ * print
+ *
+ * Stampa il valore su terminale, uno per riga.
+ */
+void Runtime::print(int value)
+{
+	std::cout << value << std::endl;
+}
+
+/**
+ * throwUndefinedVariable
+ *
+ * Lancia l'errore per una variabile letta prima di essere
+ * stata definita da SET o INPUT.
+ */
+void Runtime::throwUndefinedVariable(const std::string& name)
+{
+	std::stringstream errorMessage{};
+	errorMessage << "Undefined variable ";
+	errorMessage << name;
+	throw UndefinedReferenceError(errorMessage.str());
+}
+
+/**
+ * throwDivisionByZero
+ *
+ * Lancia l'errore per una divisione per 0.
+ */
+void Runtime::throwDivisionByZero()
+{
+	throw MathError("Division by 0.");
+}
@@ -0,0 +1,27 @@
+#ifndef RUNTIME_H
+#define RUNTIME_H
+
+#include <string>
+
+/**
+ * Runtime raccoglie le operazioni di ingresso/uscita e gli
+ * errori di esecuzione comuni a tutti i motori di esecuzione
+ * (ExecutionVisitor, StackVM, ...), in modo che ogni motore
+ * produca esattamente lo stesso output e gli stessi messaggi
+ * di errore.
+ */
+struct Runtime
+{
+	// Legge un intero da terminale, lancia InputError se
+	// il valore inserito non è un numero intero
+	static int readInput();
+
+	// Stampa un valore su terminale
+	static void print(int value);
+
+	// Lanciano rispettivamente UndefinedReferenceError e MathError
+	[[noreturn]] static void throwUndefinedVariable(const std::string& name);
+	[[noreturn]] static void throwDivisionByZero();
+};
+
+#endif
@@ -0,0 +1,28 @@
+#include "SourceCursor.h"
+
+/**
+ * Il primo Token viene riconosciuto subito, in modo che
+ * atEnd e operator-> non debbano controllare il testo.
+ */
+SourceCursor::SourceCursor(std::string_view text, StructuralScanner::Level level) :
+	text{ text }, scanner{ level }, masks{ scanner, text }
+{
+	index = masks.skip(&StructuralScanner::Masks::space, 0);
+	if (scanNext(window[0]))
+		windowSize = 1;
+}
+
+/**
+ * scanNext
+ *
+ * Riconosce il Token successivo, restituisce false alla fine
+ * del testo.
+ */
+bool SourceCursor::scanNext(Token& token)
+{
+	if (index >= text.size())
+		return false;
+	Tokenizer::scanStructural(text, masks, index, token);
+	tokenCount++;
+	return true;
+}
@@ -0,0 +1,83 @@
+#ifndef SOURCE_CURSOR_H
+#define SOURCE_CURSOR_H
+
+#include <cstddef>
+#include <string_view>
+
+#include "Token.h"
+#include "Tokenizer.h"
+#include "StructuralScanner.h"
+#include "Exceptions.h"
+
+/**
+ * SourceCursor riconosce i Token direttamente nel testo del
+ * sorgente, già in memoria, mentre il parser li legge: il
+ * lexer e il parser lavorano in una sola passata sul testo,
+ * senza il vettore di tutti i Token.
+ *
+ * I Token sono riconosciuti da Tokenizer::scanStructural, con
+ * le maschere di StructuralScanner, quindi sono gli stessi (e
+ * con gli stessi errori) del Tokenizer. Il testo deve restare
+ * in memoria finché si usano i Token.
+ *
+ * A differenza di TokenStream il testo non viene copiato in un
+ * buffer: le word dei Token puntano al sorgente, e in memoria
+ * ci sono solo il Token corrente e quello successivo.
+ *
+ * L'interfaccia è la stessa di VectorCursor, per usarlo come
+ * cursore di BasicParser (vedi FusedParser).
+ */
+class SourceCursor
+{
+public:
+	// Cursore sul testo, con lo scanner strutturale del livello
+	// richiesto (NONE usa la classificazione scalare)
+	SourceCursor(std::string_view text, StructuralScanner::Level level);
+	SourceCursor(const SourceCursor& other) = delete;
+	SourceCursor& operator=(const SourceCursor& other) = delete;
+
+	bool atEnd() const { return windowSize == 0; }
+
+	const Token* operator->() const
+	{
+		if (windowSize == 0)
+			throw SyntaxError("Overflow in token stream.");
+		return &window[0];
+	}
+	const Token& operator*() const { return *operator->(); }
+
+	void operator++(int)
+	{
+		if (windowSize == 2)
+		{
+			window[0] = window[1];
+			windowSize = 1;
+		}
+		else if (windowSize == 1)
+			windowSize = scanNext(window[0]) ? 1 : 0;
+	}
+
+	const Token* peekNext()
+	{
+		if (windowSize == 1 && scanNext(window[1]))
+			windowSize = 2;
+		return windowSize == 2 ? &window[1] : nullptr;
+	}
+
+	// Numero di Token riconosciuti finora
+	std::size_t getTokenCount() const { return tokenCount; }
+private:
+	bool scanNext(Token& token);
+
+	std::string_view text;
+	StructuralScanner scanner;
+	MaskReader masks;
+	std::size_t index;
+
+	// Token corrente e successivo, windowSize è 0 alla fine
+	Token window[2] = { { Token::ERR, "" }, { Token::ERR, "" } };
+	std::size_t windowSize = 0;
+	std::size_t tokenCount = 0;
+};
+
+#endif
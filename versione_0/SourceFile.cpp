@@ -0,0 +1,156 @@
+#include "SourceFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+
+/**
+ * open (Windows)
+ *
+ * Un file su disco con dimensione non nulla viene mappato con
+ * CreateFileMapping e MapViewOfFile, il resto viene letto.
+ */
+bool SourceFile::open(const char* fileName)
+{
+	close();
+	if (std::strcmp(fileName, "-") == 0)
+	{
+		_setmode(_fileno(stdin), _O_BINARY);
+		return readAll(_fileno(stdin));
+	}
+
+	HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &size) && size.QuadPart > 0)
+	{
+		HANDLE map = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (map != nullptr)
+		{
+			mapping = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+			// la vista resta valida anche dopo la chiusura degli handle
+			CloseHandle(map);
+			if (mapping != nullptr)
+			{
+				mappingSize = (std::size_t)size.QuadPart;
+				text = std::string_view((const char*)mapping, mappingSize);
+				CloseHandle(file);
+				return true;
+			}
+		}
+	}
+
+	// lettura in un buffer
+	char chunk[64 * 1024];
+	DWORD bytesRead;
+	while (ReadFile(file, chunk, sizeof(chunk), &bytesRead, nullptr) && bytesRead > 0)
+		buffer.append(chunk, bytesRead);
+	CloseHandle(file);
+	text = buffer;
+	return true;
+}
+
+void SourceFile::close()
+{
+	if (mapping != nullptr)
+		UnmapViewOfFile(mapping);
+	mapping = nullptr;
+	mappingSize = 0;
+	buffer.clear();
+	text = std::string_view();
+}
+
+bool SourceFile::readAll(int fd)
+{
+	char chunk[64 * 1024];
+	int bytesRead;
+	while ((bytesRead = _read(fd, chunk, sizeof(chunk))) > 0)
+		buffer.append(chunk, bytesRead);
+	text = buffer;
+	return bytesRead == 0;
+}
+
+#else
+
+/**
+ * open (POSIX)
+ *
+ * Un file regolare con dimensione non nulla viene mappato con
+ * mmap, il resto (pipe, terminali, /dev/stdin, ...) viene
+ * letto con read.
+ */
+bool SourceFile::open(const char* fileName)
+{
+	close();
+	if (std::strcmp(fileName, "-") == 0)
+		return readAll(STDIN_FILENO);
+
+	int fd = ::open(fileName, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || S_ISDIR(info.st_mode))
+	{
+		::close(fd);
+		return false;
+	}
+
+	if (S_ISREG(info.st_mode) && info.st_size > 0)
+	{
+		void* address = mmap(nullptr, (std::size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (address != MAP_FAILED)
+		{
+			// il file viene letto una sola volta dall'inizio alla fine
+			madvise(address, (std::size_t)info.st_size, MADV_SEQUENTIAL);
+			mapping = address;
+			mappingSize = (std::size_t)info.st_size;
+			text = std::string_view((const char*)mapping, mappingSize);
+			// la mappatura resta valida anche dopo la chiusura
+			::close(fd);
+			return true;
+		}
+	}
+
+	bool ok = readAll(fd);
+	::close(fd);
+	return ok;
+}
+
+void SourceFile::close()
+{
+	if (mapping != nullptr)
+		munmap(mapping, mappingSize);
+	mapping = nullptr;
+	mappingSize = 0;
+	buffer.clear();
+	text = std::string_view();
+}
+
+bool SourceFile::readAll(int fd)
+{
+	char chunk[64 * 1024];
+	ssize_t bytesRead;
+	while ((bytesRead = read(fd, chunk, sizeof(chunk))) > 0)
+		buffer.append(chunk, (std::size_t)bytesRead);
+	text = buffer;
+	return bytesRead == 0;
+}
+
+#endif
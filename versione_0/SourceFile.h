@@ -0,0 +1,44 @@
+#ifndef SOURCE_FILE_H
+#define SOURCE_FILE_H
+
+#include <string>
+#include <string_view>
+
+/**
+ * SourceFile fornisce il testo del programma come una vista
+ * sui byte del file, senza copiarlo:
+ * - i file regolari vengono mappati in memoria in sola lettura
+ *   (mmap su POSIX, MapViewOfFile su Windows)
+ * - pipe, terminali e standard input (nome "-"), che non
+ *   possono essere mappati, vengono letti in un buffer
+ *
+ * Il testo resta valido finché esiste l'oggetto SourceFile,
+ * quindi anche i Token che puntano al testo.
+ */
+class SourceFile
+{
+public:
+	SourceFile() = default;
+	SourceFile(const SourceFile& other) = delete;
+	SourceFile& operator=(const SourceFile& other) = delete;
+	~SourceFile() { close(); }
+
+	// Apre il file, restituisce false se non è leggibile
+	bool open(const char* fileName);
+	void close();
+
+	std::string_view getText() const { return text; }
+	// true se il testo è mappato in memoria
+	bool isMapped() const { return mapping != nullptr; }
+private:
+	bool readAll(int fd);
+
+	std::string_view text;
+	// Indirizzo e dimensione della mappatura, se presente
+	void* mapping = nullptr;
+	std::size_t mappingSize = 0;
+	// Testo letto da pipe o standard input
+	std::string buffer;
+};
+
+#endif
@@ -0,0 +1,171 @@
+#include <vector>
+
+#include "StackVM.h"
+#include "Bytecode.h"
+#include "Runtime.h"
+
+/*
+ * Macro per il ciclo di esecuzione: con il computed goto ogni
+ * istruzione salta direttamente all'etichetta della successiva,
+ * altrimenti si torna allo switch in testa al ciclo.
+ */
+#ifdef STACKVM_COMPUTED_GOTO
+#define VM_DISPATCH() goto *dispatchTable[pc->op]
+#define VM_CASE(name) label_##name:
+#define VM_LOOP_BEGIN VM_DISPATCH();
+#define VM_LOOP_END
+#else
+#define VM_DISPATCH() continue
+#define VM_CASE(name) case Instruction::name:
+#define VM_LOOP_BEGIN for (;;) { switch (pc->op) {
+#define VM_LOOP_END } }
+#endif
+
+/**
+ * operator()
+ *
+ * Esegue il programma a partire dalla prima istruzione fino
+ * a HALT. sp punta alla prima posizione libera della pila.
+ */
+void StackVM::operator()(const BytecodeProgram& program)
+{
+	std::vector<int> stack(program.maxStackDepth + 1);
+	std::vector<int> variables(program.variableNames.size());
+	std::vector<unsigned char> defined(program.variableNames.size(), 0);
+
+	const Instruction* pc = program.code.data();
+	int* sp = stack.data();
+
+#ifdef STACKVM_COMPUTED_GOTO
+	// Stesso ordine di Instruction::OpCode
+	static void* const dispatchTable[] = {
+		&&label_PUSH, &&label_LOAD, &&label_STORE, &&label_INPUT,
+		&&label_PRINT, &&label_ADD, &&label_SUB, &&label_MUL,
+		&&label_DIV, &&label_GT, &&label_LT, &&label_EQ,
+		&&label_NOT, &&label_JUMP, &&label_JUMP_IF_FALSE,
+		&&label_JUMP_IF_FALSE_OR_POP, &&label_JUMP_IF_TRUE_OR_POP,
+		&&label_HALT
+	};
+#endif
+
+	VM_LOOP_BEGIN
+
+	VM_CASE(PUSH)
+		*sp++ = pc->arg;
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(LOAD)
+		if (!defined[pc->arg])
+			Runtime::throwUndefinedVariable(program.variableNames[pc->arg]);
+		*sp++ = variables[pc->arg];
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(STORE)
+		variables[pc->arg] = *--sp;
+		defined[pc->arg] = 1;
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(INPUT)
+		variables[pc->arg] = Runtime::readInput();
+		defined[pc->arg] = 1;
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(PRINT)
+		Runtime::print(*--sp);
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(ADD)
+		sp--;
+		sp[-1] = sp[-1] + sp[0];
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(SUB)
+		sp--;
+		sp[-1] = sp[-1] - sp[0];
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(MUL)
+		sp--;
+		sp[-1] = sp[-1] * sp[0];
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(DIV)
+		sp--;
+		// La divisione per 0 non è ammessa
+		if (sp[0] == 0)
+			Runtime::throwDivisionByZero();
+		sp[-1] = sp[-1] / sp[0];
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(GT)
+		sp--;
+		sp[-1] = sp[-1] > sp[0];
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(LT)
+		sp--;
+		sp[-1] = sp[-1] < sp[0];
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(EQ)
+		sp--;
+		sp[-1] = sp[-1] == sp[0];
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(NOT)
+		sp[-1] = !sp[-1];
+		pc++;
+		VM_DISPATCH();
+
+	VM_CASE(JUMP)
+		pc += pc->arg + 1;
+		VM_DISPATCH();
+
+	VM_CASE(JUMP_IF_FALSE)
+		if (*--sp)
+			pc++;
+		else
+			pc += pc->arg + 1;
+		VM_DISPATCH();
+
+	// Cortocircuitazione di AND: se il primo operando è falso
+	// rimane sulla pila come risultato
+	VM_CASE(JUMP_IF_FALSE_OR_POP)
+		if (sp[-1])
+		{
+			sp--;
+			pc++;
+		}
+		else
+			pc += pc->arg + 1;
+		VM_DISPATCH();
+
+	// Cortocircuitazione di OR: se il primo operando è vero
+	// rimane sulla pila come risultato
+	VM_CASE(JUMP_IF_TRUE_OR_POP)
+		if (sp[-1])
+			pc += pc->arg + 1;
+		else
+		{
+			sp--;
+			pc++;
+		}
+		VM_DISPATCH();
+
+	VM_CASE(HALT)
+		return;
+
+	VM_LOOP_END
+}
@@ -0,0 +1,28 @@
+#ifndef STACK_VM_H
+#define STACK_VM_H
+
+#include "Bytecode.h"
+
+// Con GCC e Clang il ciclo di esecuzione usa il computed goto
+// (goto *etichetta), altrimenti uno switch dentro un ciclo
+#if defined(__GNUC__) || defined(__clang__)
+#define STACKVM_COMPUTED_GOTO
+#endif
+
+/**
+ * StackVM esegue un programma compilato da BytecodeCompiler.
+ *
+ * La pila e le variabili sono vettori di interi allocati una
+ * sola volta prima dell'esecuzione; la pila è dimensionata
+ * sulla profondità massima calcolata dal compilatore.
+ * Gli errori di esecuzione (variabili non definite, divisione
+ * per 0, input non valido) sono gli stessi di ExecutionVisitor.
+ */
+class StackVM
+{
+public:
+	// uso costruttori e distruttore di default
+	void operator()(const BytecodeProgram& program);
+};
+
+#endif
@@ -1,6 +1,6 @@
 #include "Statement.h"
 #include "Visitor.h"
-// Dentro il file *.cpp  possibile includere Visitor
+// Dentro il file *.cpp è possibile includere Visitor
 
 void PrintStmt::accept(Visitor* v) { (*v).visitPrintStmt(this); }
 void SetStmt::accept(Visitor* v) { (*v).visitSetStmt(this); }
@@ -1,10 +1,12 @@
 #ifndef STATEMENT_H
 #define STATEMENT_H
 
+#include <cstdint>
+
 #include "NumExpr.h"
 #include "BoolExpr.h"
 
-// Visitor include gi Statement, quindi Statement non pu includere
+// Visitor include già Statement, quindi Statement non può includere
 // a sua volta Visitor, ma la classe deve comunque essere dichiarata
 class Visitor;
 // Stesso per Block
@@ -12,12 +14,25 @@ class Block;
 
 /*
  * Statement generico all'interno del programma
+ *
+ * Il tipo concreto è anche memorizzato in kind, in modo che
+ * l'esecuzione possa scegliere il metodo con uno switch e uno
+ * static_cast invece di due chiamate virtuali (accept e visit).
  */
 class Statement
 {
 public:
+	enum Kind : std::uint8_t { IF, WHILE, INPUT, SET, PRINT };
+
 	virtual ~Statement() {};
 	virtual void accept(Visitor* v) = 0;
+
+	Kind getKind() const { return kind; }
+protected:
+	Statement(Kind k) : kind{ k } {}
+	Statement(const Statement& other) = default;
+private:
+	Kind kind;
 };
 
 /*
@@ -26,14 +41,14 @@ public:
  * Corrisponde a:
  * (IF boolExpr, stmtBlockTrue, stmtBlockFalse)
  * 
- * Esegue stmtBlockTrue se boolExpr  vera
- * Esegue stmtBlockFalse se boolExpr  falsa
+ * Esegue stmtBlockTrue se boolExpr è vera
+ * Esegue stmtBlockFalse se boolExpr è falsa
  * 
  * Possono verificarsi gli errori:
- * - la dichiarazione non  sintatticamente corretta
- * - boolExpr non  sintatticamente corretta o contiene variabili non
+ * - la dichiarazione non è sintatticamente corretta
+ * - boolExpr non è sintatticamente corretta o contiene variabili non
  *   definite in precedenza
- * - uno dei due stmtBlock non  sintatticamente corretto
+ * - uno dei due stmtBlock non è sintatticamente corretto
  * - uno dei due stmtBlock, se eseguito, contiene errori semantici (ad
  *   esempio divisione per 0)
  */
@@ -41,7 +56,7 @@ class IfStmt : public Statement
 {
 public:
 	IfStmt(BoolExpr* c, Block* b_if, Block* b_else)
-		: condition{ c }, blockIf{ b_if }, blockElse{ b_else } {};
+		: Statement{ IF }, condition{ c }, blockIf{ b_if }, blockElse{ b_else } {};
 	// facciamo che vanno bene i costruttori e distruttori di default
 	IfStmt(const IfStmt& other) = default;
 	~IfStmt() = default;
@@ -63,14 +78,14 @@ private:
  * Corrisponde a:
  * (WHILE boolExpr, stmtBlock)
  *
- * Esegue stmtBlock finch boolExpr  vera. L'esecuzione non avviene
- * se smtBlock  falsa in partenza.
+ * Esegue stmtBlock finché boolExpr è vera. L'esecuzione non avviene
+ * se smtBlock è falsa in partenza.
  *
  * Possono verificarsi gli errori:
- * - la dichiarazione non  sintatticamente corretta
- * - boolExpr non  sintatticamente corretta o contiene variabili non
+ * - la dichiarazione non è sintatticamente corretta
+ * - boolExpr non è sintatticamente corretta o contiene variabili non
  *   definite in precedenza
- * - lo stmtBlock non  sintatticamente corretto
+ * - lo stmtBlock non è sintatticamente corretto
  * - lo stmtBlock, se eseguito, contiene errori semantici (ad
  *   esempio divisione per 0)
  */
@@ -78,7 +93,7 @@ class WhileStmt : public Statement
 {
 public:
 	WhileStmt(BoolExpr* c, Block* b)
-		: condition{ c }, block{ b } {};
+		: Statement{ WHILE }, condition{ c }, block{ b } {};
 	// facciamo che vanno bene i costruttori e distruttori di default
 	WhileStmt(const WhileStmt& other) = default;
 	~WhileStmt() = default;
@@ -98,20 +113,20 @@ private:
  * Corrisponde a:
  * (INPUT id_variabile)
  *
- * Crea la variabile con id id_variabile se non era gi presente, e assegna
+ * Crea la variabile con id id_variabile se non era già presente, e assegna
  * ad essa un valore ottenuto in input da terminale.
  *
  * Possono verificarsi gli errori:
- * - la dichiarazione non  sintatticamente corretta
- * - l'istruzione non  sintatticamente corretta
- * - id_variabile  una parola chiave
+ * - la dichiarazione non è sintatticamente corretta
+ * - l'istruzione non è sintatticamente corretta
+ * - id_variabile è una parola chiave
  * - viene inserito da console un valore illecito
  */
 class InputStmt : public Statement
 {
 public:
 	InputStmt(Variable* var_id)
-		: varId{ var_id } {};
+		: Statement{ INPUT }, varId{ var_id } {};
 	// facciamo che vanno bene i costruttori e distruttori di default
 	InputStmt(const InputStmt& other) = default;
 	~InputStmt() = default;
@@ -129,13 +144,13 @@ private:
  * Corrisponde a:
  * (SET id_variabile, num_expr)
  *
- * Crea la variabile con id id_variabile se non era gi presente, e assegna
+ * Crea la variabile con id id_variabile se non era già presente, e assegna
  * ad essa il valore dell'espressione num_expr
  *
  * Possono verificarsi gli errori:
- * - la dichiarazione non  sintatticamente corretta
- * - id_variabile  una parola chiave
- * - la num_expr non  sintatticamente corretta
+ * - la dichiarazione non è sintatticamente corretta
+ * - id_variabile è una parola chiave
+ * - la num_expr non è sintatticamente corretta
  * - la num_expr, se eseguita, contiene errori semantici (ad
  *   esempio divisione per 0)
  */
@@ -143,7 +158,7 @@ class SetStmt : public Statement
 {
 public:
 	SetStmt(Variable* var_id, NumExpr* num_expr)
-		: varId{ var_id }, newValue{ num_expr } {};
+		: Statement{ SET }, varId{ var_id }, newValue{ num_expr } {};
 	// facciamo che vanno bene i costruttori e distruttori di default
 	SetStmt(const SetStmt& other) = default;
 	~SetStmt() = default;
@@ -166,7 +181,7 @@ private:
  * Stampa su terminale il valore risultante dall'espressione numerica
  * 
  * Possono verificarsi gli errori:
- * - la num_expr non  sintatticamente corretta
+ * - la num_expr non è sintatticamente corretta
  * - la num_expr contiene variabili non definite in precedenza
  * - la num_expr, se eseguita, contiene errori semantici (ad
  *   esempio divisione per 0)
@@ -175,7 +190,7 @@ class PrintStmt : public Statement
 {
 public:
 	PrintStmt(NumExpr* num_expr)
-		: printValue{ num_expr } {};
+		: Statement{ PRINT }, printValue{ num_expr } {};
 	// facciamo che vanno bene i costruttori e distruttori di default
 	PrintStmt(const PrintStmt& other) = default;
 	~PrintStmt() = default;
@@ -0,0 +1,327 @@
+#include "StencilCompiler.h"
+
+namespace
+{
+	// Condizioni dei salti (secondo byte di 0F 8x)
+	const unsigned char JE = 0x84, JNE = 0x85;
+	const unsigned char JL = 0x8C, JGE = 0x8D, JLE = 0x8E, JG = 0x8F;
+
+	unsigned char relOpJump(RelOp::OpCode op, bool jumpWhen)
+	{
+		switch (op)
+		{
+		case RelOp::GT:
+			return jumpWhen ? JG : JLE;
+		case RelOp::LT:
+			return jumpWhen ? JL : JGE;
+		default:
+			return jumpWhen ? JE : JNE;
+		}
+	}
+
+	void write32(std::vector<unsigned char>& code, int at, int value)
+	{
+		for (int i = 0; i < 4; i++)
+			code[at + i] = (unsigned char)((unsigned)value >> (8 * i));
+	}
+
+	void write64(std::vector<unsigned char>& code, int at, const void* address)
+	{
+		unsigned long long value = (unsigned long long)address;
+		for (int i = 0; i < 8; i++)
+			code[at + i] = (unsigned char)(value >> (8 * i));
+	}
+
+	bool isConstant(NumExpr* expression) { return expression->getKind() == NumExpr::NUMBER; }
+	bool isVariable(NumExpr* expression) { return expression->getKind() == NumExpr::VARIABLE; }
+	int constantOf(NumExpr* expression) { return static_cast<Number*>(expression)->getValue(); }
+	int slotOf(NumExpr* expression) { return static_cast<Variable*>(expression)->getSlot(); }
+}
+
+/**
+ * operator()
+ *
+ * Stessa struttura del codice di JitCompiler: prologo,
+ * Statement, uscita normale, epilogo e segnalazioni degli
+ * errori.
+ */
+bool StencilCompiler::operator()(Block* program)
+{
+	if (!JitProgram::isSupported())
+		return false;
+	code.clear();
+	exitJumps.clear();
+	undefinedJumps.clear();
+	divisionJumps.clear();
+
+	copy(Stencils::PROLOGUE);
+	compileBlock(program);
+	copy(Stencils::RETURN_OK);
+	int epilogue = position();
+	copy(Stencils::EPILOGUE);
+	patchJumps(exitJumps, epilogue);
+
+	exitJumps.clear();
+	for (const auto& [slot, jumps] : undefinedJumps)
+	{
+		patchJumps(jumps, position());
+		copy(Stencils::UNDEFINED_STUB, { slot });
+	}
+	if (!divisionJumps.empty())
+	{
+		patchJumps(divisionJumps, position());
+		copy(Stencils::DIVISION_STUB);
+	}
+	patchJumps(exitJumps, epilogue);
+
+	return jit->load(code, symbols->getNames());
+}
+
+void StencilCompiler::compileBlock(Block* block)
+{
+	for (Statement* statement : block->getStatements())
+		compileStatement(statement);
+}
+
+void StencilCompiler::compileStatement(Statement* statement)
+{
+	switch (statement->getKind())
+	{
+	case Statement::IF:
+	{
+		IfStmt* ifStmt = static_cast<IfStmt*>(statement);
+		std::vector<int> elseJumps;
+		std::vector<int> endJumps;
+		compileBranch(ifStmt->getCondition(), false, elseJumps);
+		compileBlock(ifStmt->getBlockIf());
+		copy(Stencils::JUMP, {}, &endJumps);
+		patchJumps(elseJumps, position());
+		compileBlock(ifStmt->getBlockElse());
+		patchJumps(endJumps, position());
+		return;
+	}
+	case Statement::WHILE:
+	{
+		// la condizione sta in fondo al ciclo, come in JitCompiler
+		WhileStmt* whileStmt = static_cast<WhileStmt*>(statement);
+		std::vector<int> conditionJumps;
+		copy(Stencils::JUMP, {}, &conditionJumps);
+		int body = position();
+		compileBlock(whileStmt->getBlock());
+		patchJumps(conditionJumps, position());
+		std::vector<int> loopJumps;
+		compileBranch(whileStmt->getCondition(), true, loopJumps);
+		patchJumps(loopJumps, body);
+		return;
+	}
+	case Statement::INPUT:
+		copy(Stencils::INPUT, { static_cast<InputStmt*>(statement)->getVarId()->getSlot() });
+		return;
+	case Statement::SET:
+	{
+		SetStmt* setStmt = static_cast<SetStmt*>(statement);
+		int slot = setStmt->getVarId()->getSlot();
+		if (isConstant(setStmt->getNewValue()))
+			copy(Stencils::SET_CONST, { slot, constantOf(setStmt->getNewValue()) });
+		else
+		{
+			compileNumExpr(setStmt->getNewValue());
+			copy(Stencils::SET, { slot });
+		}
+		return;
+	}
+	default:
+		compileNumExpr(static_cast<PrintStmt*>(statement)->getPrintValue());
+		copy(Stencils::PRINT);
+		return;
+	}
+}
+
+/**
+ * compileNumExpr
+ *
+ * Calcola l'espressione in eax; l'operando sinistro viene
+ * calcolato prima del destro, come in ExecutionVisitor.
+ */
+void StencilCompiler::compileNumExpr(NumExpr* expression)
+{
+	if (isConstant(expression))
+	{
+		copy(Stencils::LOAD_CONST, { constantOf(expression) });
+		return;
+	}
+	if (isVariable(expression))
+	{
+		copy(Stencils::LOAD_VAR, { slotOf(expression) });
+		return;
+	}
+
+	Operator* operatorNode = static_cast<Operator*>(expression);
+	NumExpr* left = operatorNode->getLeft();
+	NumExpr* right = operatorNode->getRight();
+	Operator::OpCode op = operatorNode->getOp();
+
+	// variabile e costante con un solo stencil
+	if (op != Operator::DIV && isVariable(left) && isConstant(right))
+	{
+		const Stencil& stencil = op == Operator::PLUS ? Stencils::ADD_VAR_CONST
+			: op == Operator::MINUS ? Stencils::SUB_VAR_CONST : Stencils::MUL_VAR_CONST;
+		copy(stencil, { slotOf(left), constantOf(right) });
+		return;
+	}
+
+	compileNumExpr(left);
+	if (isConstant(right))
+		copy(Stencils::RIGHT_CONST, { constantOf(right) });
+	else if (isVariable(right))
+		copy(Stencils::RIGHT_VAR, { slotOf(right) });
+	else
+	{
+		copy(Stencils::PUSH);
+		compileNumExpr(right);
+		copy(Stencils::POP_RIGHT);
+	}
+
+	switch (op)
+	{
+	case Operator::PLUS:
+		copy(Stencils::ADD);
+		return;
+	case Operator::MINUS:
+		copy(Stencils::SUB);
+		return;
+	case Operator::TIMES:
+		copy(Stencils::MUL);
+		return;
+	default:
+		// La divisione per 0 non è ammessa
+		if (isConstant(right) && constantOf(right) != 0)
+			copy(Stencils::DIV_NONZERO);
+		else
+			copy(Stencils::DIV);
+		return;
+	}
+}
+
+/**
+ * compileBranch
+ *
+ * Come in JitCompiler: salti quando la condizione vale
+ * jumpWhen, con la cortocircuitazione di AND e OR.
+ */
+void StencilCompiler::compileBranch(BoolExpr* condition, bool jumpWhen, std::vector<int>& jumps)
+{
+	switch (condition->getKind())
+	{
+	case BoolExpr::REL_OP:
+	{
+		RelOp* relOp = static_cast<RelOp*>(condition);
+		NumExpr* left = relOp->getLeft();
+		NumExpr* right = relOp->getRight();
+		unsigned char jump = relOpJump(relOp->getOp(), jumpWhen);
+		if (isVariable(left) && isConstant(right))
+			copy(Stencils::CMP_VAR_CONST_JCC, { slotOf(left), constantOf(right) }, &jumps, jump);
+		else if (isVariable(left) && isVariable(right))
+			copy(Stencils::CMP_VAR_VAR_JCC, { slotOf(left), slotOf(right) }, &jumps, jump);
+		else
+		{
+			compileNumExpr(left);
+			if (isConstant(right))
+				copy(Stencils::RIGHT_CONST, { constantOf(right) });
+			else if (isVariable(right))
+				copy(Stencils::RIGHT_VAR, { slotOf(right) });
+			else
+			{
+				copy(Stencils::PUSH);
+				compileNumExpr(right);
+				copy(Stencils::POP_RIGHT);
+			}
+			copy(Stencils::CMP_JCC, {}, &jumps, jump);
+		}
+		return;
+	}
+	case BoolExpr::BOOL_CONST:
+		if ((static_cast<BoolConst*>(condition)->getValue() != 0) == jumpWhen)
+			copy(Stencils::JUMP, {}, &jumps);
+		return;
+	default:
+		break;
+	}
+
+	BoolOp* boolOp = static_cast<BoolOp*>(condition);
+	if (boolOp->getOp() == BoolOp::NOT)
+	{
+		compileBranch(boolOp->getLeft(), !jumpWhen, jumps);
+		return;
+	}
+	bool isAnd = boolOp->getOp() == BoolOp::AND;
+	if (jumpWhen != isAnd)
+	{
+		compileBranch(boolOp->getLeft(), jumpWhen, jumps);
+		compileBranch(boolOp->getRight(), jumpWhen, jumps);
+	}
+	else
+	{
+		std::vector<int> skipJumps;
+		compileBranch(boolOp->getLeft(), !jumpWhen, skipJumps);
+		compileBranch(boolOp->getRight(), jumpWhen, jumps);
+		patchJumps(skipJumps, position());
+	}
+}
+
+void StencilCompiler::patchJumps(const std::vector<int>& jumps, int target)
+{
+	for (int jump : jumps)
+		write32(code, jump, target - (jump + 4));
+}
+
+void StencilCompiler::copy(const Stencil& stencil, std::initializer_list<int> operands,
+	std::vector<int>* targets, unsigned char condition)
+{
+	int start = position();
+	code.insert(code.end(), stencil.bytes, stencil.bytes + stencil.size);
+
+	for (int i = 0; i < stencil.holeCount; i++)
+	{
+		const Stencil::Hole& hole = stencil.holes[i];
+		int at = start + hole.offset;
+		int operand = hole.operand < operands.size() ? operands.begin()[hole.operand] : 0;
+		switch (hole.kind)
+		{
+		case Stencil::VALUE:
+			write32(code, at, operand * 4);
+			break;
+		case Stencil::DEFINED:
+		case Stencil::IMM:
+			write32(code, at, operand);
+			break;
+		case Stencil::UNDEFINED:
+			undefinedJumps[operand].push_back(at);
+			break;
+		case Stencil::TARGET:
+			targets->push_back(at);
+			break;
+		case Stencil::DIVISION:
+			divisionJumps.push_back(at);
+			break;
+		case Stencil::EXIT:
+			exitJumps.push_back(at);
+			break;
+		case Stencil::COND:
+			code[at] = condition;
+			break;
+		case Stencil::PRINT_HELPER:
+			write64(code, at, (const void*)&JitProgram::print);
+			break;
+		case Stencil::INPUT_HELPER:
+			write64(code, at, (const void*)&JitProgram::input);
+			break;
+		case Stencil::UNDEFINED_HELPER:
+			write64(code, at, (const void*)&JitProgram::undefinedVariable);
+			break;
+		case Stencil::DIVISION_HELPER:
+			write64(code, at, (const void*)&JitProgram::divisionByZero);
+			break;
+		}
+	}
+}
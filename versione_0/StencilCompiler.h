@@ -0,0 +1,66 @@
+#ifndef STENCIL_COMPILER_H
+#define STENCIL_COMPILER_H
+
+#include <initializer_list>
+#include <map>
+#include <vector>
+
+#include "Block.h"
+#include "Statement.h"
+#include "NumExpr.h"
+#include "BoolExpr.h"
+#include "JitProgram.h"
+#include "Stencils.h"
+#include "SymbolTable.h"
+
+/**
+ * StencilCompiler genera codice macchina con la tecnica
+ * "copy-and-patch": per ogni nodo sceglie uno Stencil già
+ * assemblato (vedi Stencils.h), lo copia in fondo al codice e
+ * ne completa i buchi con slot, costanti e destinazioni dei
+ * salti. Il codice viene eseguito da JitProgram, come quello
+ * di JitCompiler, con gli stessi registri e le stesse funzioni
+ * di supporto; la differenza è che qui nessuna istruzione
+ * viene codificata durante la compilazione.
+ *
+ * Oltre agli stencil per i singoli nodi ci sono quelli per le
+ * forme più frequenti nei cicli:
+ * - ADD/SUB/MUL con una variabile e una costante
+ * - SET con una costante
+ * - GT/LT/EQ tra una variabile e una costante o tra due
+ *   variabili, con il salto condizionato
+ */
+class StencilCompiler
+{
+public:
+	StencilCompiler(const SymbolTable* st, JitProgram* target) :
+		symbols{ st }, jit{ target } {}
+
+	// false se il processore non è supportato o se il sistema
+	// non concede memoria eseguibile (vedi JitCompiler)
+	bool operator()(Block* program);
+private:
+	void compileBlock(Block* block);
+	void compileStatement(Statement* statement);
+	void compileNumExpr(NumExpr* expression);
+	void compileBranch(BoolExpr* condition, bool jumpWhen, std::vector<int>& jumps);
+	void patchJumps(const std::vector<int>& jumps, int target);
+
+	// Copia lo stencil e ne completa i buchi: operands per
+	// VALUE, DEFINED, IMM e UNDEFINED, condition per COND; le
+	// posizioni dei buchi TARGET vengono aggiunte a targets
+	void copy(const Stencil& stencil, std::initializer_list<int> operands = {},
+		std::vector<int>* targets = nullptr, unsigned char condition = 0);
+	int position() const { return (int)code.size(); }
+
+	const SymbolTable* symbols;
+	JitProgram* jit;
+
+	std::vector<unsigned char> code;
+	// Buchi da completare alla fine, come in JitCompiler
+	std::vector<int> exitJumps;
+	std::map<int, std::vector<int>> undefinedJumps;
+	std::vector<int> divisionJumps;
+};
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef STENCILS_H
+#define STENCILS_H
+
+#include <cstddef>
+
+#include "JitProgram.h"
+
+/**
+ * Stencil è un frammento di codice macchina x86-64 già
+ * assemblato, con dei "buchi" (Hole) da completare quando
+ * viene copiato: StencilCompiler genera il programma copiando
+ * uno stencil dopo l'altro e scrivendo nei buchi slot,
+ * costanti e destinazioni dei salti, senza codificare
+ * istruzioni.
+ *
+ * Tipi di buco (spiazzamenti e costanti a 32 bit, salvo
+ * dove indicato):
+ * - VALUE:     4 * slot dell'operando, per [rbx + VALUE]
+ * - DEFINED:   slot dell'operando, per [r12 + DEFINED]
+ * - IMM:       costante (o slot passato a una funzione)
+ * - UNDEFINED: salto alla segnalazione della variabile
+ *              dell'operando non definita
+ * - TARGET:    salto a una destinazione del programma
+ * - DIVISION:  salto alla segnalazione della divisione per 0
+ * - EXIT:      salto all'epilogo
+ * - COND:      8 bit, condizione del salto (0F 8x)
+ * - *_HELPER:  64 bit, indirizzo di una funzione di supporto
+ *              di JitProgram
+ * I registri e il JitContext sono quelli di JitCompiler.
+ */
+struct Stencil
+{
+	enum HoleKind : unsigned char
+	{
+		VALUE, DEFINED, IMM, UNDEFINED, TARGET, DIVISION, EXIT, COND,
+		PRINT_HELPER, INPUT_HELPER, UNDEFINED_HELPER, DIVISION_HELPER
+	};
+
+	struct Hole
+	{
+		unsigned char offset;
+		HoleKind kind;
+		// indice dell'operando per VALUE, DEFINED, IMM e UNDEFINED
+		unsigned char operand;
+	};
+
+	unsigned char size;
+	unsigned char bytes[48];
+	unsigned char holeCount;
+	Hole holes[8];
+};
+
+/*
+ * LIBRERIA DEGLI STENCIL
+ *
+ * I byte sono stati ottenuti assemblando il codice nei commenti
+ * (sintassi Intel) con valori segnaposto al posto dei buchi e
+ * sostituendo poi i segnaposto con zeri. Gli stencil che
+ * chiamano funzioni di supporto dipendono dalla convenzione di
+ * chiamata (System V o Microsoft x64).
+ */
+namespace Stencils
+{
+	// uscita normale, restituisce 0
+	//   xor eax, eax
+	constexpr Stencil RETURN_OK{ 2, { 0x31, 0xC0 },
+		0, {} };
+	// epilogo, destinazione dei salti EXIT
+	//   lea rsp, [rbp-24]; pop r13; pop r12; pop rbx; pop rbp; ret
+	constexpr Stencil EPILOGUE{ 11, { 0x48, 0x8D, 0x65, 0xE8, 0x41, 0x5D, 0x41, 0x5C, 0x5B, 0x5D, 0xC3 },
+		0, {} };
+	// eax = costante
+	//   mov eax, IMM0
+	constexpr Stencil LOAD_CONST{ 5, { 0xB8, 0x00, 0x00, 0x00, 0x00 },
+		1, { { 1, Stencil::IMM, 0 } } };
+	// eax = variabile (controllata)
+	//   cmp byte [r12+DEFINED0], 0; .byte 0xf,0x84; .long UNDEFINED0; mov eax, [rbx+VALUE0]
+	constexpr Stencil LOAD_VAR{ 21, { 0x41, 0x80, 0xBC, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x8B, 0x83, 0x00, 0x00, 0x00, 0x00 },
+		3, { { 4, Stencil::DEFINED, 0 }, { 11, Stencil::UNDEFINED, 0 }, { 17, Stencil::VALUE, 0 } } };
+	// salva l'operando sinistro
+	//   push rax
+	constexpr Stencil PUSH{ 1, { 0x50 },
+		0, {} };
+	// ecx = operando destro, eax = sinistro
+	//   mov ecx, eax; pop rax
+	constexpr Stencil POP_RIGHT{ 3, { 0x89, 0xC1, 0x58 },
+		0, {} };
+	// ecx = costante
+	//   mov ecx, IMM0
+	constexpr Stencil RIGHT_CONST{ 5, { 0xB9, 0x00, 0x00, 0x00, 0x00 },
+		1, { { 1, Stencil::IMM, 0 } } };
+	// ecx = variabile (controllata)
+	//   cmp byte [r12+DEFINED0], 0; .byte 0xf,0x84; .long UNDEFINED0; mov ecx, [rbx+VALUE0]
+	constexpr Stencil RIGHT_VAR{ 21, { 0x41, 0x80, 0xBC, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x8B, 0x8B, 0x00, 0x00, 0x00, 0x00 },
+		3, { { 4, Stencil::DEFINED, 0 }, { 11, Stencil::UNDEFINED, 0 }, { 17, Stencil::VALUE, 0 } } };
+	// eax += ecx
+	//   add eax, ecx
+	constexpr Stencil ADD{ 2, { 0x01, 0xC8 },
+		0, {} };
+	// eax -= ecx
+	//   sub eax, ecx
+	constexpr Stencil SUB{ 2, { 0x29, 0xC8 },
+		0, {} };
+	// eax *= ecx
+	//   imul eax, ecx
+	constexpr Stencil MUL{ 3, { 0x0F, 0xAF, 0xC1 },
+		0, {} };
+	// eax /= ecx, con il controllo della divisione per 0
+	//   test ecx, ecx; .byte 0xf,0x84; .long DIVISION; cdq; idiv ecx
+	constexpr Stencil DIV{ 11, { 0x85, 0xC9, 0x0F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x99, 0xF7, 0xF9 },
+		1, { { 4, Stencil::DIVISION, 0 } } };
+	// eax /= ecx, divisore costante diverso da 0
+	//   cdq; idiv ecx
+	constexpr Stencil DIV_NONZERO{ 3, { 0x99, 0xF7, 0xF9 },
+		0, {} };
+	// eax = variabile + costante
+	//   cmp byte [r12+DEFINED0], 0; .byte 0xf,0x84; .long UNDEFINED0; mov eax, [rbx+VALUE0]; add eax, IMM1
+	constexpr Stencil ADD_VAR_CONST{ 26, { 0x41, 0x80, 0xBC, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x8B, 0x83, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00 },
+		4, { { 4, Stencil::DEFINED, 0 }, { 11, Stencil::UNDEFINED, 0 }, { 17, Stencil::VALUE, 0 }, { 22, Stencil::IMM, 1 } } };
+	// eax = variabile - costante
+	//   cmp byte [r12+DEFINED0], 0; .byte 0xf,0x84; .long UNDEFINED0; mov eax, [rbx+VALUE0]; sub eax, IMM1
+	constexpr Stencil SUB_VAR_CONST{ 26, { 0x41, 0x80, 0xBC, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x8B, 0x83, 0x00, 0x00, 0x00, 0x00, 0x2D, 0x00, 0x00, 0x00, 0x00 },
+		4, { { 4, Stencil::DEFINED, 0 }, { 11, Stencil::UNDEFINED, 0 }, { 17, Stencil::VALUE, 0 }, { 22, Stencil::IMM, 1 } } };
+	// eax = variabile * costante
+	//   cmp byte [r12+DEFINED0], 0; .byte 0xf,0x84; .long UNDEFINED0; imul eax, dword [rbx+VALUE0], IMM1
+	constexpr Stencil MUL_VAR_CONST{ 25, { 0x41, 0x80, 0xBC, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x69, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+		4, { { 4, Stencil::DEFINED, 0 }, { 11, Stencil::UNDEFINED, 0 }, { 17, Stencil::VALUE, 0 }, { 21, Stencil::IMM, 1 } } };
+	// variabile = eax
+	//   mov [rbx+VALUE0], eax; mov byte [r12+DEFINED0], 1
+	constexpr Stencil SET{ 15, { 0x89, 0x83, 0x00, 0x00, 0x00, 0x00, 0x41, 0xC6, 0x84, 0x24, 0x00, 0x00, 0x00, 0x00, 0x01 },
+		2, { { 2, Stencil::VALUE, 0 }, { 10, Stencil::DEFINED, 0 } } };
+	// variabile = costante
+	//   mov dword [rbx+VALUE0], IMM1; mov byte [r12+DEFINED0], 1
+	constexpr Stencil SET_CONST{ 19, { 0xC7, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0xC6, 0x84, 0x24, 0x00, 0x00, 0x00, 0x00, 0x01 },
+		3, { { 2, Stencil::VALUE, 0 }, { 6, Stencil::IMM, 1 }, { 14, Stencil::DEFINED, 0 } } };
+	// salto se eax ? ecx
+	//   cmp eax, ecx; .byte 0xf,0x80; .long TARGET
+	constexpr Stencil CMP_JCC{ 8, { 0x39, 0xC8, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00 },
+		2, { { 3, Stencil::COND, 0 }, { 4, Stencil::TARGET, 0 } } };
+	// salto se variabile ? costante
+	//   cmp byte [r12+DEFINED0], 0; .byte 0xf,0x84; .long UNDEFINED0; cmp dword [rbx+VALUE0], IMM1; .byte 0xf,0x80; .long TARGET
+	constexpr Stencil CMP_VAR_CONST_JCC{ 31, { 0x41, 0x80, 0xBC, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x81, 0xBB, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00 },
+		6, { { 4, Stencil::DEFINED, 0 }, { 11, Stencil::UNDEFINED, 0 }, { 17, Stencil::VALUE, 0 }, { 21, Stencil::IMM, 1 }, { 26, Stencil::COND, 0 }, { 27, Stencil::TARGET, 0 } } };
+	// salto se variabile ? variabile
+	//   cmp byte [r12+DEFINED0], 0; .byte 0xf,0x84; .long UNDEFINED0; cmp byte [r12+DEFINED1], 0; .byte 0xf,0x84; .long UNDEFINED1; mov eax, [rbx+VALUE0]; cmp eax, [rbx+VALUE1]; .byte 0xf,0x80; .long TARGET
+	constexpr Stencil CMP_VAR_VAR_JCC{ 48, { 0x41, 0x80, 0xBC, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x41, 0x80, 0xBC, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x84, 0x00, 0x00, 0x00, 0x00, 0x8B, 0x83, 0x00, 0x00, 0x00, 0x00, 0x3B, 0x83, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00 },
+		8, { { 4, Stencil::DEFINED, 0 }, { 11, Stencil::UNDEFINED, 0 }, { 19, Stencil::DEFINED, 1 }, { 26, Stencil::UNDEFINED, 1 }, { 32, Stencil::VALUE, 0 }, { 38, Stencil::VALUE, 1 }, { 43, Stencil::COND, 0 }, { 44, Stencil::TARGET, 0 } } };
+	// salto incondizionato
+	//   jmp TARGET
+	constexpr Stencil JUMP{ 5, { 0xE9, 0x00, 0x00, 0x00, 0x00 },
+		1, { { 1, Stencil::TARGET, 0 } } };
+
+	// il prologo carica frame da [r13+0] e defined da [r13+8]
+	static_assert(offsetof(JitContext, frame) == 0 && offsetof(JitContext, defined) == 8,
+		"JitContext: spiazzamenti fissi nel prologo degli stencil");
+
+#ifdef _WIN32
+	// prologo: salva rbx, r12, r13 e carica frame e defined da JitContext
+	//   push rbp; mov rbp, rsp; push rbx; push r12; push r13; sub rsp, 40; mov r13, rcx; mov rbx, [r13+0]; mov r12, [r13+8]
+	constexpr Stencil PROLOGUE{ 24, { 0x55, 0x48, 0x89, 0xE5, 0x53, 0x41, 0x54, 0x41, 0x55, 0x48, 0x83, 0xEC, 0x28, 0x49, 0x89, 0xCD, 0x49, 0x8B, 0x5D, 0x00, 0x4D, 0x8B, 0x65, 0x08 },
+		0, {} };
+	// JitProgram::print(context, eax)
+	//   mov edx, eax; mov rcx, r13; movabs rax, PRINT_HELPER; call rax; test eax, eax; .byte 0xf,0x85; .long EXIT
+	constexpr Stencil PRINT{ 25, { 0x89, 0xC2, 0x4C, 0x89, 0xE9, 0x48, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xD0, 0x85, 0xC0, 0x0F, 0x85, 0x00, 0x00, 0x00, 0x00 },
+		2, { { 7, Stencil::PRINT_HELPER, 0 }, { 21, Stencil::EXIT, 0 } } };
+	// JitProgram::input(context, slot)
+	//   mov edx, IMM0; mov rcx, r13; movabs rax, INPUT_HELPER; call rax; test eax, eax; .byte 0xf,0x85; .long EXIT
+	constexpr Stencil INPUT{ 28, { 0xBA, 0x00, 0x00, 0x00, 0x00, 0x4C, 0x89, 0xE9, 0x48, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xD0, 0x85, 0xC0, 0x0F, 0x85, 0x00, 0x00, 0x00, 0x00 },
+		3, { { 1, Stencil::IMM, 0 }, { 10, Stencil::INPUT_HELPER, 0 }, { 24, Stencil::EXIT, 0 } } };
+	// JitProgram::undefinedVariable(context, slot), poi uscita
+	//   lea rsp, [rbp-64]; mov edx, IMM0; mov rcx, r13; movabs rax, UNDEFINED_HELPER; call rax; jmp EXIT
+	constexpr Stencil UNDEFINED_STUB{ 29, { 0x48, 0x8D, 0x65, 0xC0, 0xBA, 0x00, 0x00, 0x00, 0x00, 0x4C, 0x89, 0xE9, 0x48, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xD0, 0xE9, 0x00, 0x00, 0x00, 0x00 },
+		3, { { 5, Stencil::IMM, 0 }, { 14, Stencil::UNDEFINED_HELPER, 0 }, { 25, Stencil::EXIT, 0 } } };
+	// JitProgram::divisionByZero(context), poi uscita
+	//   lea rsp, [rbp-64]; mov rcx, r13; movabs rax, DIVISION_HELPER; call rax; jmp EXIT
+	constexpr Stencil DIVISION_STUB{ 24, { 0x48, 0x8D, 0x65, 0xC0, 0x4C, 0x89, 0xE9, 0x48, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xD0, 0xE9, 0x00, 0x00, 0x00, 0x00 },
+		2, { { 9, Stencil::DIVISION_HELPER, 0 }, { 20, Stencil::EXIT, 0 } } };
+#else
+	// prologo: salva rbx, r12, r13 e carica frame e defined da JitContext
+	//   push rbp; mov rbp, rsp; push rbx; push r12; push r13; sub rsp, 40; mov r13, rdi; mov rbx, [r13+0]; mov r12, [r13+8]
+	constexpr Stencil PROLOGUE{ 24, { 0x55, 0x48, 0x89, 0xE5, 0x53, 0x41, 0x54, 0x41, 0x55, 0x48, 0x83, 0xEC, 0x28, 0x49, 0x89, 0xFD, 0x49, 0x8B, 0x5D, 0x00, 0x4D, 0x8B, 0x65, 0x08 },
+		0, {} };
+	// JitProgram::print(context, eax)
+	//   mov esi, eax; mov rdi, r13; movabs rax, PRINT_HELPER; call rax; test eax, eax; .byte 0xf,0x85; .long EXIT
+	constexpr Stencil PRINT{ 25, { 0x89, 0xC6, 0x4C, 0x89, 0xEF, 0x48, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xD0, 0x85, 0xC0, 0x0F, 0x85, 0x00, 0x00, 0x00, 0x00 },
+		2, { { 7, Stencil::PRINT_HELPER, 0 }, { 21, Stencil::EXIT, 0 } } };
+	// JitProgram::input(context, slot)
+	//   mov esi, IMM0; mov rdi, r13; movabs rax, INPUT_HELPER; call rax; test eax, eax; .byte 0xf,0x85; .long EXIT
+	constexpr Stencil INPUT{ 28, { 0xBE, 0x00, 0x00, 0x00, 0x00, 0x4C, 0x89, 0xEF, 0x48, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xD0, 0x85, 0xC0, 0x0F, 0x85, 0x00, 0x00, 0x00, 0x00 },
+		3, { { 1, Stencil::IMM, 0 }, { 10, Stencil::INPUT_HELPER, 0 }, { 24, Stencil::EXIT, 0 } } };
+	// JitProgram::undefinedVariable(context, slot), poi uscita
+	//   lea rsp, [rbp-64]; mov esi, IMM0; mov rdi, r13; movabs rax, UNDEFINED_HELPER; call rax; jmp EXIT
+	constexpr Stencil UNDEFINED_STUB{ 29, { 0x48, 0x8D, 0x65, 0xC0, 0xBE, 0x00, 0x00, 0x00, 0x00, 0x4C, 0x89, 0xEF, 0x48, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xD0, 0xE9, 0x00, 0x00, 0x00, 0x00 },
+		3, { { 5, Stencil::IMM, 0 }, { 14, Stencil::UNDEFINED_HELPER, 0 }, { 25, Stencil::EXIT, 0 } } };
+	// JitProgram::divisionByZero(context), poi uscita
+	//   lea rsp, [rbp-64]; mov rdi, r13; movabs rax, DIVISION_HELPER; call rax; jmp EXIT
+	constexpr Stencil DIVISION_STUB{ 24, { 0x48, 0x8D, 0x65, 0xC0, 0x4C, 0x89, 0xEF, 0x48, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xD0, 0xE9, 0x00, 0x00, 0x00, 0x00 },
+		2, { { 9, Stencil::DIVISION_HELPER, 0 }, { 20, Stencil::EXIT, 0 } } };
+#endif
+}
+
+#endif
@@ -0,0 +1,169 @@
+#include "StructuralScanner.h"
+#include "CharClass.h"
+
+#ifdef STRUCTURAL_SCANNER_X86
+#include <immintrin.h>
+#endif
+
+// Su GCC e Clang le funzioni AVX2 (e SSE2 sulle CPU a 32 bit)
+// vengono compilate per quel set di istruzioni anche se il resto
+// del programma non lo usa; MSVC non ne ha bisogno
+#if defined(__GNUC__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define TARGET_AVX2
+#define TARGET_SSE2
+#endif
+
+namespace
+{
+	/**
+	 * VERSIONE SCALARE
+	 *
+	 * Un byte alla volta, con la tabella di CharClass.
+	 */
+	void classifyScalar(const char* block, StructuralScanner::Masks& masks)
+	{
+		std::uint64_t paren = 0, space = 0, alpha = 0, digit = 0;
+		for (unsigned i = 0; i < StructuralScanner::blockSize; i++)
+		{
+			std::uint64_t bit = (std::uint64_t)1 << i;
+			CharClass::Class c = CharClass::of(block[i]);
+			paren |= (c == CharClass::LP || c == CharClass::RP) ? bit : 0;
+			space |= (c == CharClass::SPACE || c == CharClass::NEWLINE) ? bit : 0;
+			alpha |= (c == CharClass::ALPHA) ? bit : 0;
+			digit |= (c == CharClass::DIGIT) ? bit : 0;
+		}
+		masks = { paren, space, alpha, digit };
+	}
+
+#ifdef STRUCTURAL_SCANNER_X86
+	/**
+	 * VERSIONE SSE2
+	 *
+	 * I confronti sono con segno: i byte non ASCII sono negativi
+	 * e non appartengono a nessun intervallo.
+	 */
+	TARGET_SSE2 void classifySse2(const char* block, StructuralScanner::Masks& masks)
+	{
+		std::uint64_t paren = 0, space = 0, alpha = 0, digit = 0;
+		for (unsigned i = 0; i < StructuralScanner::blockSize; i += 16)
+		{
+			__m128i c = _mm_loadu_si128((const __m128i*)(block + i));
+			__m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+
+			__m128i isParen = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('(')),
+				_mm_cmpeq_epi8(c, _mm_set1_epi8(')')));
+			__m128i isSpace = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(' ')),
+				_mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('\t' - 1)),
+					_mm_cmplt_epi8(c, _mm_set1_epi8('\r' + 1))));
+			__m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+				_mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+			__m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+				_mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+
+			paren |= (std::uint64_t)(unsigned)_mm_movemask_epi8(isParen) << i;
+			space |= (std::uint64_t)(unsigned)_mm_movemask_epi8(isSpace) << i;
+			alpha |= (std::uint64_t)(unsigned)_mm_movemask_epi8(isAlpha) << i;
+			digit |= (std::uint64_t)(unsigned)_mm_movemask_epi8(isDigit) << i;
+		}
+		masks = { paren, space, alpha, digit };
+	}
+
+	/**
+	 * VERSIONE AVX2
+	 *
+	 * Come SSE2, 32 byte alla volta.
+	 */
+	TARGET_AVX2 void classifyAvx2(const char* block, StructuralScanner::Masks& masks)
+	{
+		std::uint64_t paren = 0, space = 0, alpha = 0, digit = 0;
+		for (unsigned i = 0; i < StructuralScanner::blockSize; i += 32)
+		{
+			__m256i c = _mm256_loadu_si256((const __m256i*)(block + i));
+			__m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+
+			__m256i isParen = _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('(')),
+				_mm256_cmpeq_epi8(c, _mm256_set1_epi8(')')));
+			__m256i isSpace = _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8(' ')),
+				_mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('\t' - 1)),
+					_mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), c)));
+			__m256i isAlpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+				_mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+			__m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+				_mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+
+			paren |= (std::uint64_t)(unsigned)_mm256_movemask_epi8(isParen) << i;
+			space |= (std::uint64_t)(unsigned)_mm256_movemask_epi8(isSpace) << i;
+			alpha |= (std::uint64_t)(unsigned)_mm256_movemask_epi8(isAlpha) << i;
+			digit |= (std::uint64_t)(unsigned)_mm256_movemask_epi8(isDigit) << i;
+		}
+		masks = { paren, space, alpha, digit };
+	}
+#endif
+}
+
+StructuralScanner::StructuralScanner(Level level) : level{ level }, classifyBlock{ classifyScalar }
+{
+#ifdef STRUCTURAL_SCANNER_X86
+	if (level == SSE2)
+		classifyBlock = classifySse2;
+	else if (level == AVX2)
+		classifyBlock = classifyAvx2;
+#endif
+}
+
+/**
+ * isSupported
+ *
+ * SSE2 fa parte di tutte le CPU x86 a 64 bit; per AVX2 serve
+ * anche il supporto del sistema operativo ai registri a 256
+ * bit (controllato da __builtin_cpu_supports, e con xgetbv su
+ * MSVC).
+ */
+bool StructuralScanner::isSupported(Level level)
+{
+	if (level == NONE || level == SCALAR)
+		return true;
+#if defined(STRUCTURAL_SCANNER_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	bool sse2 = (info[3] & (1 << 26)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	if (level == SSE2)
+		return sse2;
+	if (!osxsave || (_xgetbv(0) & 6) != 6)
+		return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#elif defined(STRUCTURAL_SCANNER_X86)
+	__builtin_cpu_init();
+	if (level == SSE2)
+		return __builtin_cpu_supports("sse2");
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+StructuralScanner::Level StructuralScanner::detectLevel()
+{
+	if (isSupported(AVX2))
+		return AVX2;
+	if (isSupported(SSE2))
+		return SSE2;
+	return SCALAR;
+}
+
+const char* StructuralScanner::levelToStr(Level level)
+{
+	switch (level)
+	{
+	case NONE: return "none";
+	case SCALAR: return "scalar";
+	case SSE2: return "sse2";
+	case AVX2: return "avx2";
+	}
+	return "null";
+}
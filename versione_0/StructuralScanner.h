@@ -0,0 +1,150 @@
+#ifndef STRUCTURAL_SCANNER_H
+#define STRUCTURAL_SCANNER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define STRUCTURAL_SCANNER_X86
+#endif
+
+/**
+ * StructuralScanner è il primo stadio del Tokenizer strutturale:
+ * classifica un blocco di 64 byte del testo e produce una
+ * maschera di bit per ogni classe di caratteri (il bit i è 1 se
+ * il byte i del blocco appartiene alla classe): parentesi,
+ * spazi bianchi, lettere e cifre. Il Tokenizer riconosce poi
+ * i Token scorrendo le maschere invece dei byte.
+ *
+ * La classificazione è disponibile in tre versioni, scelta
+ * durante l'esecuzione in base alla CPU:
+ * - AVX2:   32 byte per istruzione
+ * - SSE2:   16 byte per istruzione
+ * - SCALAR: la tabella di CharClass, un byte alla volta,
+ *           usata sulle CPU non x86
+ * Le classi non dipendono dal locale: sono quelle di isspace,
+ * isalpha e isdigit nel locale "C".
+ */
+class StructuralScanner
+{
+public:
+	// NONE indica il Tokenizer che legge un byte alla volta,
+	// senza scanner strutturale
+	enum Level { NONE, SCALAR, SSE2, AVX2 };
+
+	// Maschere di un blocco di 64 byte
+	struct Masks
+	{
+		std::uint64_t paren;
+		std::uint64_t space;
+		std::uint64_t alpha;
+		std::uint64_t digit;
+	};
+
+	static const unsigned blockSize = 64;
+
+	// Scanner con il livello migliore supportato dalla CPU
+	StructuralScanner() : StructuralScanner(detectLevel()) {}
+	// Scanner con il livello richiesto, che deve essere supportato
+	StructuralScanner(Level level);
+
+	// Classifica i 64 byte a partire da block
+	void classify(const char* block, Masks& masks) const { classifyBlock(block, masks); }
+
+	Level getLevel() const { return level; }
+
+	// Livello migliore supportato dalla CPU
+	static Level detectLevel();
+	static bool isSupported(Level level);
+	static const char* levelToStr(Level level);
+
+	// Posizione del primo bit a 1 (bits non nullo)
+	static unsigned firstBit(std::uint64_t bits)
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		unsigned long index;
+		_BitScanForward64(&index, bits);
+		return (unsigned)index;
+#elif defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanForward(&index, (unsigned long)bits))
+			return (unsigned)index;
+		_BitScanForward(&index, (unsigned long)(bits >> 32));
+		return (unsigned)index + 32;
+#else
+		return (unsigned)__builtin_ctzll(bits);
+#endif
+	}
+private:
+	Level level;
+	void (*classifyBlock)(const char* block, Masks& masks);
+};
+
+/**
+ * MaskReader fornisce le maschere del blocco di 64 byte che
+ * contiene una posizione del testo, classificando ogni
+ * blocco una sola volta. L'ultimo blocco, incompleto, viene
+ * copiato in un buffer completato con byte nulli, che non
+ * appartengono a nessuna classe.
+ *
+ * Il testo deve restare in memoria finché si usa il MaskReader.
+ */
+class MaskReader
+{
+public:
+	typedef std::uint64_t StructuralScanner::Masks::* Class;
+
+	MaskReader(const StructuralScanner& s, std::string_view t) : scanner{ s }, text{ t } {}
+
+	// true se il byte in posizione index appartiene alla classe
+	bool has(Class mask, std::size_t index)
+	{
+		return ((at(index).*mask >> (index % StructuralScanner::blockSize)) & 1) != 0;
+	}
+
+	// Prima posizione da index in poi che non appartiene alla
+	// classe, oppure la fine del testo
+	std::size_t skip(Class mask, std::size_t index)
+	{
+		while (index < text.size())
+		{
+			std::uint64_t outside = ~(at(index).*mask) >> (index % StructuralScanner::blockSize);
+			if (outside != 0)
+				return std::min(index + StructuralScanner::firstBit(outside), text.size());
+			index = (index / StructuralScanner::blockSize + 1) * StructuralScanner::blockSize;
+		}
+		return text.size();
+	}
+private:
+	const StructuralScanner::Masks& at(std::size_t index)
+	{
+		std::size_t block = index / StructuralScanner::blockSize * StructuralScanner::blockSize;
+		if (block != current)
+		{
+			current = block;
+			if (block + StructuralScanner::blockSize <= text.size())
+				scanner.classify(text.data() + block, masks);
+			else
+			{
+				char last[StructuralScanner::blockSize] = {};
+				std::memcpy(last, text.data() + block, text.size() - block);
+				scanner.classify(last, masks);
+			}
+		}
+		return masks;
+	}
+
+	const StructuralScanner& scanner;
+	std::string_view text;
+	std::size_t current = (std::size_t)-1;
+	StructuralScanner::Masks masks{};
+};
+
+#endif
@@ -0,0 +1,122 @@
+#include "SymbolResolver.h"
+#include "Block.h"
+#include "Statement.h"
+#include "NumExpr.h"
+#include "BoolExpr.h"
+
+/**
+ * operator()
+ *
+ * Risolve tutte le variabili del programma. Gli slot vengono
+ * assegnati nello stesso ordine in cui le variabili compaiono
+ * nel sorgente.
+ */
+void SymbolResolver::operator()(Block* root)
+{
+	root->accept(this);
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * SYMBOLRESOLVER PER BLOCK E STATEMENTS
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+void SymbolResolver::visitBlock(Block* blockNode)
+{
+	// un Block pigro viene risolto da LazyLoader quando
+	// viene analizzato
+	if (!blockNode->isLoaded())
+		return;
+	for (Statement* stmt : blockNode->getStatements())
+		stmt->accept(this);
+}
+
+void SymbolResolver::visitIfStmt(IfStmt* ifStmtNode)
+{
+	ifStmtNode->getCondition()->accept(this);
+	ifStmtNode->getBlockIf()->accept(this);
+	ifStmtNode->getBlockElse()->accept(this);
+}
+
+void SymbolResolver::visitWhileStmt(WhileStmt* whileStmtNode)
+{
+	whileStmtNode->getCondition()->accept(this);
+	whileStmtNode->getBlock()->accept(this);
+}
+
+void SymbolResolver::visitInputStmt(InputStmt* inputStmtNode)
+{
+	inputStmtNode->getVarId()->accept(this);
+}
+
+/**
+ * SymbolResolver PER SET-STATEMENT
+ *
+ * L'espressione viene risolta prima della variabile assegnata,
+ * nello stesso ordine in cui viene eseguita.
+ */
+void SymbolResolver::visitSetStmt(SetStmt* setStmtNode)
+{
+	setStmtNode->getNewValue()->accept(this);
+	setStmtNode->getVarId()->accept(this);
+}
+
+void SymbolResolver::visitPrintStmt(PrintStmt* printStmtNode)
+{
+	printStmtNode->getPrintValue()->accept(this);
+}
+
+
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * SYMBOLRESOLVER PER ESPRESSIONI NUMERICHE E BOOLEANE
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+void SymbolResolver::visitOperator(Operator* operatorNode)
+{
+	operatorNode->getLeft()->accept(this);
+	operatorNode->getRight()->accept(this);
+}
+
+/**
+ * SymbolResolver PER COSTANTI NUMERICHE
+ *
+ * Una costante non contiene variabili, non c'è niente da risolvere.
+ */
+void SymbolResolver::visitNumber(Number*)
+{
+}
+
+/**
+ * SymbolResolver PER VARIABILI
+ *
+ * Unico nodo che cambia: riceve lo slot del suo identificatore.
+ */
+void SymbolResolver::visitVariable(Variable* variableNode)
+{
+	variableNode->setSlot(symbols->intern(variableNode->getName()));
+}
+
+void SymbolResolver::visitRelOp(RelOp* relOpNode)
+{
+	relOpNode->getLeft()->accept(this);
+	relOpNode->getRight()->accept(this);
+}
+
+/**
+ * SymbolResolver PER COSTANTI BOOLEANE
+ *
+ * Come per le costanti numeriche, non c'è niente da risolvere.
+ */
+void SymbolResolver::visitBoolConst(BoolConst*)
+{
+}
+
+void SymbolResolver::visitBoolOp(BoolOp* boolOpNode)
+{
+	boolOpNode->getLeft()->accept(this);
+	// NOT ha un solo operando
+	if (boolOpNode->getOp() != BoolOp::NOT)
+		boolOpNode->getRight()->accept(this);
+}
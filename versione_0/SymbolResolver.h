@@ -0,0 +1,43 @@
+#ifndef SYMBOL_RESOLVER_H
+#define SYMBOL_RESOLVER_H
+
+#include "Visitor.h"
+#include "SymbolTable.h"
+
+/**
+ * SymbolResolver visita l'albero sintattico subito dopo il
+ * parsing e assegna a ogni Variable (comprese quelle di
+ * SetStmt e InputStmt) lo slot del suo identificatore nella
+ * SymbolTable.
+ *
+ * Dopo la risoluzione nessun motore di esecuzione ha più
+ * bisogno di cercare le variabili per nome: il nome serve
+ * solo per i messaggi di errore.
+ */
+class SymbolResolver : public Visitor
+{
+public:
+	SymbolResolver(SymbolTable* st) : symbols{ st } {}
+
+	void operator()(Block* program);
+
+	void visitBlock(Block* blockNode) override;
+
+	void visitPrintStmt(PrintStmt* printStmtNode) override;
+	void visitSetStmt(SetStmt* setStmtNode) override;
+	void visitInputStmt(InputStmt* inputStmtNode) override;
+	void visitWhileStmt(WhileStmt* whileStmtNode) override;
+	void visitIfStmt(IfStmt* ifStmtBlock) override;
+
+	void visitOperator(Operator* operatorNode) override;
+	void visitNumber(Number* numberNode) override;
+	void visitVariable(Variable* variableNode) override;
+
+	void visitRelOp(RelOp* relOpNode) override;
+	void visitBoolConst(BoolConst* boolConstNode) override;
+	void visitBoolOp(BoolOp* boolOpNode) override;
+private:
+	SymbolTable* symbols;
+};
+
+#endif
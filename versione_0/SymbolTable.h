@@ -0,0 +1,43 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * SymbolTable associa a ogni identificatore del programma un
+ * indice (slot) denso: gli slot sono assegnati in ordine di
+ * prima occorrenza a partire da 0, quindi i motori di
+ * esecuzione possono memorizzare le variabili in un vettore
+ * di size() interi invece che in una mappa.
+ */
+class SymbolTable
+{
+public:
+	// uso costruttori e distruttore di default
+
+	// Restituisce lo slot dell'identificatore, assegnandone
+	// uno nuovo se non è ancora stato incontrato
+	int intern(const std::string& name)
+	{
+		auto found = slots.find(name);
+		if (found != slots.end())
+			return found->second;
+
+		int slot = (int)names.size();
+		slots.emplace(name, slot);
+		names.push_back(name);
+		return slot;
+	}
+
+	const std::string& getName(int slot) const { return names[slot]; }
+	const std::vector<std::string>& getNames() const { return names; }
+	std::size_t size() const { return names.size(); }
+private:
+	std::unordered_map<std::string, int> slots;
+	std::vector<std::string> names;
+};
+
+#endif
@@ -1,71 +1,180 @@
 #ifndef TOKEN_H
 #define TOKEN_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
+/*
+ * Elenco di tutti i tipi di Token, nell'ordine dell'enum Tag.
+ * È l'unico punto in cui sono definiti: l'enum, tagToStr e la
+ * tabella delle parole chiave vengono generati da qui.
+ * - SYMBOL:   token che non è una parola (parentesi, ERR)
+ * - KEYWORD:  parola chiave, scritta come il nome del tag
+ * - RESERVED: parola riservata che non può essere usata come
+ *             nome di variabile, ma non è una parola chiave:
+ *             il Tokenizer la riconosce come token ERR
+ */
+#define TOKEN_TAGS(SYMBOL, KEYWORD, RESERVED) \
+	SYMBOL(LP) SYMBOL(RP) \
+	KEYWORD(BLOCK) KEYWORD(IF) KEYWORD(WHILE) KEYWORD(INPUT) \
+	KEYWORD(SET) KEYWORD(PRINT) KEYWORD(ADD) KEYWORD(SUB) \
+	KEYWORD(MUL) KEYWORD(DIV) RESERVED(NUM) RESERVED(VAR) \
+	KEYWORD(GT) KEYWORD(LT) KEYWORD(EQ) KEYWORD(AND) \
+	KEYWORD(OR) KEYWORD(NOT) KEYWORD(TRUE) KEYWORD(FALSE) \
+	SYMBOL(ERR)
+
+#define TOKEN_TAG_NAME(name) name,
+#define TOKEN_TAG_STRING(name) #name,
+#define TOKEN_TAG_IGNORE(name)
+#define TOKEN_TAG_COUNT(name) + 1
+#define TOKEN_KEYWORD_ENTRY(name) { #name, Token::name },
+#define TOKEN_RESERVED_ENTRY(name) { #name, Token::ERR },
+
+/*
+ * Token prodotto dal Tokenizer.
+ *
+ * word non possiede il testo del token ma è una vista sul
+ * sorgente, che deve restare in memoria finché si usano i
+ * token; per i NUM, value contiene già il valore numerico.
+ * In questo modo la creazione di un token non richiede
+ * nessuna allocazione.
+ */
 struct Token
 {
-	enum Tag { LP, RP, BLOCK, IF, WHILE, INPUT, SET,
-		PRINT, ADD, SUB, MUL, DIV, NUM, VAR, GT, LT,
-		EQ, AND, OR, NOT, TRUE, FALSE, ERR };
+	enum Tag { TOKEN_TAGS(TOKEN_TAG_NAME, TOKEN_TAG_NAME, TOKEN_TAG_NAME) };
+	// numero dei tipi di Token, contati nell'elenco TOKEN_TAGS
+	static constexpr int TAG_COUNT = 0 TOKEN_TAGS(TOKEN_TAG_COUNT, TOKEN_TAG_COUNT, TOKEN_TAG_COUNT);
 
-	Token(Token::Tag t, const char* w) : tag{ t }, word{ w } {}
-	Token(Token::Tag t, std::string w) : tag{ t }, word{ w } {}
+	Token(Token::Tag t, std::string_view w, int v = 0) : tag{ t }, value{ v }, word{ w } {}
+
+	// Tipo del token scritto come s (parentesi o parola
+	// chiave), ERR se non esiste
+	static Tag strToTag(std::string_view s);
+
+	// Tipo di un identificatore: parola chiave, ERR per le
+	// parole riservate, VAR altrimenti
+	static Tag wordToTag(std::string_view word);
 
-	static Tag strToTag(std::string s)
-	{
-		if (s == "(") return LP;
-		if (s == ")") return RP;
-		if (s == "BLOCK") return BLOCK;
-		if (s == "IF") return IF;
-		if (s == "WHILE") return WHILE;
-		if (s == "INPUT") return INPUT;
-		if (s == "SET") return SET;
-		if (s == "PRINT") return PRINT;
-		if (s == "ADD") return ADD;
-		if (s == "SUB") return SUB;
-		if (s == "MUL") return MUL;
-		if (s == "DIV") return DIV;
-		if (s == "GT") return GT;
-		if (s == "LT") return LT;
-		if (s == "EQ") return EQ;
-		if (s == "AND") return AND;
-		if (s == "OR") return OR;
-		if (s == "NOT") return NOT;
-		if (s == "TRUE") return TRUE;
-		if (s == "FALSE") return FALSE;
-		return ERR;
-	}
-	
 	static std::string tagToStr(Tag s)
 	{
-		if (s == LP) return "LP";
-		if (s == RP) return "RP";
-		if (s == BLOCK) return "BLOCK";
-		if (s == IF) return "IF";
-		if (s == WHILE) return "WHILE";
-		if (s == INPUT) return "INPUT";
-		if (s == SET) return "SET";
-		if (s == PRINT) return "PRINT";
-		if (s == ADD) return "ADD";
-		if (s == SUB) return "SUB";
-		if (s == MUL) return "MUL";
-		if (s == DIV) return "DIV";
-		if (s == NUM) return "NUM";
-		if (s == VAR) return "VAR";
-		if (s == GT) return "GT";
-		if (s == LT) return "LT";
-		if (s == EQ) return "EQ";
-		if (s == AND) return "AND";
-		if (s == OR) return "OR";
-		if (s == NOT) return "NOT";
-		if (s == TRUE) return "TRUE";
-		if (s == FALSE) return "FALSE";
-		return "null";
-	};
-	
+		static const char* const names[] = {
+			TOKEN_TAGS(TOKEN_TAG_STRING, TOKEN_TAG_STRING, TOKEN_TAG_STRING)
+		};
+		if (s < LP || s >= ERR)
+			return "null";
+		return names[s];
+	}
+
 	Tag tag;
-	std::string word;
+	int value;
+	std::string_view word;
 };
 
-#endif
\ No newline at end of file
+/*
+ * KeywordTable riconosce le parole chiave e le parole
+ * riservate con una tabella hash perfetta calcolata durante
+ * la compilazione: ogni parola ha una posizione diversa
+ * nella tabella, quindi basta calcolare l'hash e confrontare
+ * la parola con l'unica candidata.
+ *
+ * L'hash usa lunghezza, prima, seconda e ultima lettera; il
+ * moltiplicatore (seed) viene cercato dal compilatore tra
+ * quelli che non producono collisioni.
+ */
+namespace KeywordTable
+{
+	struct Entry
+	{
+		std::string_view word;
+		Token::Tag tag;
+	};
+
+	// Dimensione della tabella, potenza di 2
+	inline constexpr unsigned size = 64;
+
+	inline constexpr Entry entries[] = {
+		TOKEN_TAGS(TOKEN_TAG_IGNORE, TOKEN_KEYWORD_ENTRY, TOKEN_RESERVED_ENTRY)
+	};
+	inline constexpr unsigned count = sizeof(entries) / sizeof(entries[0]);
+
+	constexpr unsigned hash(std::string_view word, unsigned seed)
+	{
+		unsigned h = (unsigned)word.size();
+		h = h * seed + (unsigned char)word[0];
+		h = h * seed + (unsigned char)word[word.size() > 1 ? 1 : 0];
+		h = h * seed + (unsigned char)word[word.size() - 1];
+		return (h ^ (h >> 7)) & (size - 1);
+	}
+
+	constexpr bool isPerfect(unsigned seed)
+	{
+		bool used[size] = {};
+		for (unsigned i = 0; i < count; i++)
+		{
+			unsigned slot = hash(entries[i].word, seed);
+			if (used[slot])
+				return false;
+			used[slot] = true;
+		}
+		return true;
+	}
+
+	constexpr unsigned findSeed()
+	{
+		for (unsigned seed = 1; seed < 100000; seed++)
+			if (isPerfect(seed))
+				return seed;
+		return 0;
+	}
+
+	inline constexpr unsigned seed = findSeed();
+	static_assert(seed != 0, "no perfect hash seed for the keyword list");
+
+	// Per ogni posizione, l'indice della parola in entries
+	// oppure -1
+	struct Slots
+	{
+		std::int8_t index[size];
+	};
+
+	constexpr Slots buildSlots()
+	{
+		Slots slots{};
+		for (unsigned i = 0; i < size; i++)
+			slots.index[i] = -1;
+		for (unsigned i = 0; i < count; i++)
+			slots.index[hash(entries[i].word, seed)] = (std::int8_t)i;
+		return slots;
+	}
+
+	inline constexpr Slots slots = buildSlots();
+
+	// Restituisce la parola chiave o riservata uguale a word,
+	// nullptr se word non lo è
+	inline const Entry* find(std::string_view word)
+	{
+		if (word.empty())
+			return nullptr;
+		int index = slots.index[hash(word, seed)];
+		if (index < 0 || entries[index].word != word)
+			return nullptr;
+		return &entries[index];
+	}
+}
+
+inline Token::Tag Token::strToTag(std::string_view s)
+{
+	if (s == "(") return LP;
+	if (s == ")") return RP;
+	const KeywordTable::Entry* entry = KeywordTable::find(s);
+	return entry != nullptr ? entry->tag : ERR;
+}
+
+inline Token::Tag Token::wordToTag(std::string_view word)
+{
+	const KeywordTable::Entry* entry = KeywordTable::find(word);
+	return entry != nullptr ? entry->tag : VAR;
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef TOKEN_CURSOR_H
+#define TOKEN_CURSOR_H
+
+#include <vector>
+
+#include "Token.h"
+#include "Exceptions.h"
+
+/**
+ * VectorCursor scorre un vettore di Token già generato dal
+ * Tokenizer, ed è il cursore usato da Parser e CompactParser.
+ *
+ * Offre la stessa interfaccia di TokenStream, in modo che
+ * BasicParser possa leggere i Token da entrambi:
+ * - atEnd() è vero dopo l'ultimo Token
+ * - itr->... e *itr leggono il Token corrente, e lanciano
+ *   SyntaxError se i Token sono finiti
+ * - itr++ passa al Token successivo
+ * - peekNext() restituisce il Token dopo quello corrente
+ *   senza avanzare, nullptr se non esiste
+ */
+class VectorCursor
+{
+public:
+	VectorCursor(const std::vector<Token>& tokens) :
+		itr{ tokens.data() }, end{ tokens.data() + tokens.size() } {}
+	// Cursore sui Token da begin (incluso) a end (escluso)
+	VectorCursor(const Token* begin, const Token* end) : itr{ begin }, end{ end } {}
+
+	bool atEnd() const { return itr == end; }
+
+	const Token* operator->() const
+	{
+		if (itr == end)
+			throw SyntaxError("Overflow in token stream.");
+		return itr;
+	}
+	const Token& operator*() const { return *operator->(); }
+
+	void operator++(int)
+	{
+		if (itr != end)
+			++itr;
+	}
+
+	const Token* peekNext() const
+	{
+		if (itr == end || itr + 1 == end)
+			return nullptr;
+		return itr + 1;
+	}
+private:
+	const Token* itr;
+	const Token* end;
+};
+
+#endif
@@ -0,0 +1,197 @@
+#include "TokenStream.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "Exceptions.h"
+
+TokenStream::TokenStream() : eof{ true }, data{ nullptr }, length{ 0 }
+{
+}
+
+TokenStream::TokenStream(std::string_view text) : eof{ true },
+	data{ text.data() }, length{ text.size() }
+{
+}
+
+TokenStream::~TokenStream()
+{
+	if (ownsFd)
+#ifdef _WIN32
+		_close(fd);
+#else
+		close(fd);
+#endif
+}
+
+/**
+ * open
+ *
+ * Apre il file in lettura, il testo viene letto solo quando il
+ * parser richiede i Token.
+ */
+bool TokenStream::open(const char* fileName)
+{
+	if (std::strcmp(fileName, "-") == 0)
+	{
+#ifdef _WIN32
+		_setmode(_fileno(stdin), _O_BINARY);
+		fd = _fileno(stdin);
+#else
+		fd = STDIN_FILENO;
+#endif
+	}
+	else
+	{
+#ifdef _WIN32
+		fd = _open(fileName, _O_RDONLY | _O_BINARY);
+#else
+		fd = ::open(fileName, O_RDONLY);
+#endif
+		if (fd < 0)
+			return false;
+		ownsFd = true;
+	}
+
+	buffer.resize(chunkSize);
+	data = buffer.data();
+	length = 0;
+	eof = false;
+	return true;
+}
+
+bool TokenStream::atEnd()
+{
+	return !fill(1);
+}
+
+const Token* TokenStream::operator->()
+{
+	if (!fill(1))
+		throw SyntaxError("Overflow in token stream.");
+	return &window[0];
+}
+
+void TokenStream::operator++(int)
+{
+	if (!fill(1))
+		return;
+	window[0] = window[1];
+	windowSize--;
+}
+
+const Token* TokenStream::peekNext()
+{
+	if (!fill(2))
+		return nullptr;
+	return &window[1];
+}
+
+/**
+ * fill
+ *
+ * Porta nella finestra almeno tokens Token (al massimo 2),
+ * restituisce false se il testo finisce prima.
+ */
+bool TokenStream::fill(std::size_t tokens)
+{
+	while (windowSize < tokens && !finished)
+	{
+		if (scanNext(window[windowSize]))
+			windowSize++;
+		else
+			finished = true;
+	}
+	return windowSize >= tokens;
+}
+
+/**
+ * scanNext
+ *
+ * Riconosce il Token successivo con Tokenizer::scanToken,
+ * leggendo altri blocchi finché il Token non è completo.
+ * Restituisce false alla fine del testo.
+ */
+bool TokenStream::scanNext(Token& token)
+{
+	while (true)
+	{
+		switch (Tokenizer::scanToken(std::string_view(data, length), eof, position, token))
+		{
+		case Tokenizer::TOKEN:
+			tokenCount++;
+			return true;
+		case Tokenizer::END:
+			return false;
+		case Tokenizer::MORE:
+			readMore();
+			break;
+		}
+	}
+}
+
+/**
+ * readMore
+ *
+ * Legge un altro blocco di testo. Prima sposta all'inizio del
+ * buffer i byte ancora in uso (il Token da completare e le
+ * parole dei Token nella finestra), e raddoppia il buffer se
+ * sono già tutto il buffer. Le parole dei Token nella finestra
+ * vengono aggiornate alla nuova posizione.
+ */
+void TokenStream::readMore()
+{
+	// posizione nel testo della parola di ogni Token della
+	// finestra, oppure length se la parola non è nel buffer
+	std::size_t keep = position.index;
+	std::size_t wordIndex[2];
+	for (std::size_t i = 0; i < windowSize; i++)
+	{
+		const char* word = window[i].word.data();
+		wordIndex[i] = length;
+		if (word >= data && word < data + length)
+		{
+			wordIndex[i] = (std::size_t)(word - data);
+			keep = std::min(keep, wordIndex[i]);
+		}
+	}
+
+	std::memmove(buffer.data(), buffer.data() + keep, length - keep);
+	if (length - keep == buffer.size())
+		buffer.resize(buffer.size() * 2);
+	data = buffer.data();
+
+	for (std::size_t i = 0; i < windowSize; i++)
+		if (wordIndex[i] < length)
+			window[i].word = std::string_view(data + wordIndex[i] - keep, window[i].word.size());
+	length -= keep;
+	position.index -= keep;
+	position.offset += keep;
+
+	while (true)
+	{
+#ifdef _WIN32
+		int bytesRead = _read(fd, buffer.data() + length, (unsigned)(buffer.size() - length));
+#else
+		ssize_t bytesRead = read(fd, buffer.data() + length, buffer.size() - length);
+		if (bytesRead < 0 && errno == EINTR)
+			continue;
+#endif
+		// un errore di lettura conclude il testo, come in SourceFile
+		if (bytesRead <= 0)
+			eof = true;
+		else
+			length += (std::size_t)bytesRead;
+		return;
+	}
+}
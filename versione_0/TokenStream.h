@@ -0,0 +1,83 @@
+#ifndef TOKEN_STREAM_H
+#define TOKEN_STREAM_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "Token.h"
+#include "Tokenizer.h"
+
+/**
+ * TokenStream genera i Token uno alla volta, solo quando il
+ * parser li richiede, invece di costruire il vettore di tutti
+ * i Token del programma.
+ *
+ * Il testo viene letto a blocchi da un file descriptor (file,
+ * pipe o standard input): in memoria restano solo il blocco
+ * corrente e i due Token della finestra (il Token corrente e
+ * quello successivo, per peekNext), quindi la memoria usata non
+ * dipende dalla lunghezza del programma.
+ *
+ * I Token sono validi solo finché sono nella finestra: la word
+ * di un Token punta al buffer, che viene riutilizzato per i
+ * blocchi successivi. I Builder copiano i nomi delle variabili,
+ * quindi l'albero sintattico non dipende dal buffer.
+ *
+ * L'interfaccia è la stessa di VectorCursor, per usarlo come
+ * cursore di BasicParser (vedi StreamParser).
+ */
+class TokenStream
+{
+public:
+	// Stream vuoto, il testo viene letto dopo open
+	TokenStream();
+	// Testo già in memoria, che deve restare valido
+	TokenStream(std::string_view text);
+	TokenStream(const TokenStream& other) = delete;
+	TokenStream& operator=(const TokenStream& other) = delete;
+	~TokenStream();
+
+	// Apre il file da leggere a blocchi (- per lo standard
+	// input), restituisce false se non è leggibile
+	bool open(const char* fileName);
+
+	bool atEnd();
+
+	const Token* operator->();
+	const Token& operator*() { return *operator->(); }
+
+	void operator++(int);
+
+	const Token* peekNext();
+
+	// Numero di Token generati finora
+	std::size_t getTokenCount() const { return tokenCount; }
+	// Dimensione del buffer di lettura
+	std::size_t getBufferSize() const { return buffer.size(); }
+private:
+	// Dimensione iniziale del buffer; un Token più lungo fa
+	// raddoppiare il buffer
+	static const std::size_t chunkSize = 64 * 1024;
+
+	bool fill(std::size_t tokens);
+	bool scanNext(Token& token);
+	void readMore();
+
+	int fd = -1;
+	bool ownsFd = false;
+	bool eof;
+	bool finished = false;
+
+	// Testo disponibile: il buffer, oppure il testo esterno
+	std::vector<char> buffer;
+	const char* data;
+	std::size_t length;
+	Tokenizer::ScanPosition position{};
+
+	Token window[2] = { { Token::ERR, "" }, { Token::ERR, "" } };
+	std::size_t windowSize = 0;
+	std::size_t tokenCount = 0;
+};
+
+#endif
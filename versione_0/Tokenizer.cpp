@@ -1,160 +1,424 @@
 #include <vector>
 #include <sstream>
 #include <iostream>
+#include <charconv>
+#include <system_error>
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <thread>
+#include <iterator>
+#include <utility>
 
 #include "Exceptions.h"
 #include "Tokenizer.h"
 #include "Token.h"
+#include "StructuralScanner.h"
+#include "CharClass.h"
 
-std::vector<Token> Tokenizer::operator()(std::string inputText)
+std::vector<Token> Tokenizer::operator()(std::string_view inputText)
 {
 	//std::cout << "TOK: File received: " << std::endl << inputText << std::endl;
 	std::vector<Token> inputTokens;
-	tokenizeInputText(inputText, inputTokens);
+	// numero di parti per l'analisi parallela
+	unsigned parts = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+	parts = (unsigned)std::min<std::size_t>(parts, inputText.size() / minPartSize);
+
+	if (scanner.getLevel() == StructuralScanner::NONE)
+		tokenizeInputText(inputText, inputTokens);
+	else if (parts > 1)
+		tokenizeParallel(inputText, parts, inputTokens);
+	else
+		tokenizeStructural(inputText, 0, inputTokens);
 	//for (Token t : inputTokens)
 	// 	std::cout << Token::tagToStr(t.tag) << " ";
 	//std::cout << std::endl;
 	return inputTokens;
 }
 
-int Tokenizer::isKeyword(std::string word)
+/**
+ * parseNumber
+ *
+ * Converte il testo di un NUM (un '-' opzionale seguito da
+ * cifre) nel suo valore con std::from_chars, senza allocazioni.
+ * Un '-' senza cifre vale 0; restituisce false se il valore
+ * non è rappresentabile come int.
+ */
+bool Tokenizer::parseNumber(std::string_view number, int& value)
+{
+	value = 0;
+	std::from_chars_result result = std::from_chars(number.data(), number.data() + number.size(), value);
+	return result.ec != std::errc::result_out_of_range;
+}
+
+void Tokenizer::throwNumberOutOfRange(std::string_view number, int line)
+{
+	std::stringstream errorMessage;
+	errorMessage << "Number " << number << " out of range";
+	errorMessage << " in input at line " << line;
+	throw LexicalError(errorMessage.str());
+}
+
+void Tokenizer::tokenizeInputText(std::string_view inputText, std::vector<Token>& inputTokens)
+{
+	ScanPosition position{};
+	Token token{ Token::ERR, "" };
+
+	// tutto il testo è già disponibile, quindi scanToken non
+	// può chiedere altro testo (MORE)
+	while (scanToken(inputText, true, position, token) == TOKEN)
+		inputTokens.push_back(token);
+}
+
+namespace
 {
-	// Parole chiave (definite in keywords)
-	//std::cout << "TOK: checking for keyword \"" << word << "\"" << std::endl;
-	for (int index = 0; index < keywords.size(); index++)
+	/**
+	 * DFA DEL TOKENIZER
+	 *
+	 * Stati: START (spazi bianchi tra i Token), IDENT (dentro un
+	 * identificatore) e NUMBER (dentro un NUM, dopo il '-' o la
+	 * prima cifra). LP e RP vengono riconosciuti subito da START.
+	 *
+	 * Per ogni stato e classe di carattere la tabella indica
+	 * l'azione, che stabilisce anche lo stato successivo.
+	 */
+	enum State : std::uint8_t { START, IDENT, NUMBER, STATES };
+
+	enum Action : std::uint8_t
 	{
-		if (word == keywords[index])
-		{
-			//std::cout << "TOK: keyword found!" << std::endl;
-			return index;
-		}
-	}
-	//std::cout << "TOK: not a keyword" << std::endl;
-	return -1;
+		SKIP,				// spazio bianco, resta in START
+		NEW_LINE,			// accapo, conta una linea
+		EMIT_LP,			// parentesi aperta
+		EMIT_RP,			// parentesi chiusa
+		BEGIN_IDENT,		// prima lettera, passa in IDENT
+		BEGIN_NUMBER,		// '-' o prima cifra, passa in NUMBER
+		EXTEND,				// il Token continua
+		EMIT_IDENT,			// fine dell'identificatore (carattere escluso)
+		EMIT_NUMBER,		// fine del numero (carattere escluso)
+		STRAY_CHARACTER,	// errore: carattere non riconosciuto
+		MISSING_SEPARATOR	// errore: cifra dopo un identificatore
+	};
+
+	constexpr Action transitions[STATES][CharClass::CLASSES] = {
+		// OTHER, SPACE, NEWLINE, LP, RP, ALPHA, DIGIT, MINUS
+		{ STRAY_CHARACTER, SKIP, NEW_LINE, EMIT_LP, EMIT_RP, BEGIN_IDENT, BEGIN_NUMBER, BEGIN_NUMBER },
+		{ EMIT_IDENT, EMIT_IDENT, EMIT_IDENT, EMIT_IDENT, EMIT_IDENT, EXTEND, MISSING_SEPARATOR, EMIT_IDENT },
+		{ EMIT_NUMBER, EMIT_NUMBER, EMIT_NUMBER, EMIT_NUMBER, EMIT_NUMBER, EMIT_NUMBER, EXTEND, EMIT_NUMBER }
+	};
 }
 
-void Tokenizer::tokenizeInputText(std::string inputText, std::vector<Token>& inputTokens)
+/**
+ * scanToken
+ *
+ * Riconosce il primo token di text a partire da position,
+ * saltando gli spazi bianchi. Restituisce:
+ * - TOKEN se il token è stato riconosciuto (in token), e
+ *   position è stata portata subito dopo
+ * - END se text è finito, solo spazi bianchi dopo position
+ * - MORE se text finisce prima che il token (o gli spazi) sia
+ *   concluso e lastChunk è falso: il token potrebbe continuare
+ *   nel testo successivo. position resta all'inizio del token.
+ *
+ * Ogni carattere viene letto una sola volta: la sua classe
+ * (CharClass) e lo stato corrente scelgono l'azione nella
+ * tabella transitions. Un identificatore o un numero finisce
+ * al primo carattere di un'altra classe, oppure alla fine del
+ * testo.
+ *
+ * Le posizioni nei messaggi di errore sono relative all'inizio
+ * del sorgente (position.offset è la posizione di text[0]).
+ */
+Tokenizer::ScanResult Tokenizer::scanToken(std::string_view inputText, bool lastChunk,
+	ScanPosition& position, Token& token)
 {
-	int index = 0;
-	int line = 1;
+	const char* text = inputText.data();
+	std::size_t size = inputText.size();
+	std::size_t index = position.index;
+	std::size_t start = index;
+	State state = START;
 
-	// lettura del file carattere per carattere
-	while (index < inputText.size())
+	for (; index < size; index++)
 	{
-		//std::cout << "TOK: new loop, index is: " << index << ", character is " << inputText.at(index) << std::endl;
-		// Salto gli spazi bianchi
-		if (std::isspace(inputText[index]))
+		switch (transitions[state][CharClass::of(text[index])])
 		{
-			// Conta una nuova linea per ogni accapo
-			if (inputText[index] == '\n')
-			{
-				//std::cout << "TOK: End of line " << line << std::endl;
-				line++;
-			}
-				
-			//std::cout << "TOK: found white space" << std::endl;
-			index++;
-			continue;
+		case SKIP:
+			break;
+		case NEW_LINE:
+			position.line++;
+			break;
+		case EMIT_LP:
+			position.index = index + 1;
+			token = Token{ Token::LP, "(" };
+			return TOKEN;
+		case EMIT_RP:
+			position.index = index + 1;
+			token = Token{ Token::RP, ")" };
+			return TOKEN;
+		case BEGIN_IDENT:
+			start = index;
+			state = IDENT;
+			break;
+		case BEGIN_NUMBER:
+			start = index;
+			state = NUMBER;
+			break;
+		case EXTEND:
+			break;
+		case EMIT_IDENT:
+		{
+			// Distinzione tra parole chiave e variabili, con la
+			// tabella hash perfetta di KeywordTable
+			std::string_view identifier(text + start, index - start);
+			position.index = index;
+			token = Token{ Token::wordToTag(identifier), identifier };
+			return TOKEN;
 		}
-
-		// Parentesi aperta
-		if (inputText[index] == '(')
+		case EMIT_NUMBER:
 		{
-			//std::cout << "TOK: found open bracket" << std::endl;
-			index++;
-			inputTokens.push_back(Token{ Token::LP, "(" });
-			continue;
+			std::string_view number(text + start, index - start);
+			int value;
+			if (!parseNumber(number, value))
+				throwNumberOutOfRange(number, position.line);
+			position.index = index;
+			token = Token{ Token::NUM, number, value };
+			return TOKEN;
 		}
-
-		// Parentesi chiusa
-		if (inputText[index] == ')')
+		case MISSING_SEPARATOR:
 		{
-			//std::cout << "TOK: found closed bracket" << std::endl;
-			index++;
-			inputTokens.push_back(Token{ Token::RP, ")" });
-			continue;
+			// gli identificatori di ogni tipo non possono essere
+			// seguiti da un numero
+			std::stringstream errorMessage{};
+			errorMessage << "unexpected ";
+			errorMessage << text[index];
+			errorMessage << " at " << position.offset + index;
+			errorMessage << " after " << std::string_view(text + start, index - start);
+			errorMessage << ", missing separator.";
+			throw LexicalError(errorMessage.str());
 		}
-
-		// Identificatori: Variabili e parole chiave
-		if (std::isalpha(inputText[index]))
+		case STRAY_CHARACTER:
 		{
-			//std::cout << "TOK: found the start of a word" << std::endl;
-			// Individuo l'intera stringa (finch ci sono lettere)
-			std::stringstream temp;
-			while (std::isalpha(inputText[index]))
-			{
-				//std::cout << "TOK: still inside the word (" << inputText[index] << " at " << index << ")" << std::endl;
-				temp << inputText[index];
-				index++;
-				//std::cout << "TOK: temp is: " << temp.str() << std::endl;
-			}
-			std::string identifier = temp.str();
-			//std::cout << "TOK: word ended: " << identifier << "(" << inputText[index] << "was found)" << std::endl;
-
-			// Controllo preliminare: gli identificatori di ogni tipo
-			// non possono essere seguiti da un numero
-			if (std::isdigit(inputText[index]))
-			{
-				std::stringstream errorMessage{};
-				errorMessage << "unexpected ";
-				errorMessage << inputText[index];
-				errorMessage << " at " << index;
-				errorMessage << " after " << identifier;
-				errorMessage << ", missing separator.";
-				throw LexicalError(errorMessage.str());
-			}
-
-			// Distinzione tra parole chiave e variabili
-			int keywordIndex = isKeyword(identifier);
-			if (keywordIndex > -1)
-			{
-				// Parole chiave
-				std::string keyword = keywords[keywordIndex];
-				inputTokens.push_back(Token{ Token::strToTag(keyword), keyword });
-			}
-			else
-			{
-				// Variabili
-				//std::cout << "TOK: " << identifier << " is a variable name" << std::endl;
-				inputTokens.push_back(Token{ Token::VAR, identifier });
-			}
-			continue;
+			std::stringstream errorMessage;
+			errorMessage << "Stray character " << text[index];
+			errorMessage << " in input at line " << position.line;
+			throw LexicalError(errorMessage.str());
+		}
 		}
+	}
 
-		// Costanti numeriche
-		if (std::isdigit(inputText[index]) || inputText[index] == '-')
+	// Fine del testo: l'ultimo Token può continuare nel testo
+	// successivo, a meno che questo sia l'ultimo
+	if (state == START)
+	{
+		position.index = index;
+		return lastChunk ? END : MORE;
+	}
+	position.index = start;
+	if (!lastChunk)
+		return MORE;
+
+	std::string_view word(text + start, index - start);
+	if (state == IDENT)
+		token = Token{ Token::wordToTag(word), word };
+	else
+	{
+		int value;
+		if (!parseNumber(word, value))
+			throwNumberOutOfRange(word, position.line);
+		token = Token{ Token::NUM, word, value };
+	}
+	position.index = index;
+	return TOKEN;
+}
+
+namespace
+{
+	// Numero di linea della posizione index, calcolato solo per
+	// i messaggi di errore
+	int lineOf(std::string_view inputText, std::size_t index)
+	{
+		return (int)std::count(inputText.begin(), inputText.begin() + index, '\n') + 1;
+	}
+}
+
+/**
+ * scanStructural
+ *
+ * Riconosce gli stessi Token di scanToken, con gli stessi
+ * errori, ma usa le maschere di StructuralScanner: gli spazi,
+ * le parole e le cifre vengono saltati cercando il primo bit
+ * fuori dalla classe, invece di controllare un byte alla volta.
+ *
+ * index deve indicare l'inizio di un Token (non uno spazio
+ * bianco, né la fine del testo); viene portato dopo gli spazi
+ * bianchi che seguono il Token. inputText inizia sempre
+ * dall'inizio del sorgente, in modo che posizioni e numeri di
+ * linea negli errori siano quelli del sorgente.
+ */
+void Tokenizer::scanStructural(std::string_view inputText, MaskReader& masks,
+	std::size_t& index, Token& token)
+{
+	std::size_t size = inputText.size();
+
+	// Parentesi
+	if (masks.has(&StructuralScanner::Masks::paren, index))
+	{
+		if (inputText[index] == '(')
+			token = Token{ Token::LP, "(" };
+		else
+			token = Token{ Token::RP, ")" };
+		index++;
+	}
+
+	// Identificatori: Variabili e parole chiave
+	else if (masks.has(&StructuralScanner::Masks::alpha, index))
+	{
+		std::size_t start = index;
+		index = masks.skip(&StructuralScanner::Masks::alpha, index);
+		std::string_view identifier = inputText.substr(start, index - start);
+
+		// gli identificatori non possono essere seguiti da un numero
+		if (index < size && masks.has(&StructuralScanner::Masks::digit, index))
 		{
-			//std::cout << "TOK: found the start of a number" << std::endl;
-			// Individuo l'intero numero:
-
-			// Eventualmente il segno -
-			std::stringstream temp;
-			if (inputText[index] == '-')
-			{
-				temp << '-';
-				index++;
-			}
-			
-			// E tutte le cifre successive
-			while (std::isdigit(inputText[index]))
-			{
-				//std::cout << "TOK: still inside the number (" << inputText[index] << " at " << index << ")" << std::endl;
-				temp << inputText[index];
-				index++;
-			}
-			std::string number = temp.str();
-			//std::cout << "TOK: number ended (" << number << ")" << std::endl;
-
-			inputTokens.push_back(Token{ Token::NUM, number });
-			continue;
+			std::stringstream errorMessage{};
+			errorMessage << "unexpected ";
+			errorMessage << inputText[index];
+			errorMessage << " at " << index;
+			errorMessage << " after " << identifier;
+			errorMessage << ", missing separator.";
+			throw LexicalError(errorMessage.str());
 		}
+		token = Token{ Token::wordToTag(identifier), identifier };
+	}
 
-		// Se non  nulla di tutto ci, c' un errore
+	// Costanti numeriche, con il segno - opzionale
+	else if (masks.has(&StructuralScanner::Masks::digit, index) || inputText[index] == '-')
+	{
+		std::size_t start = index;
+		if (inputText[index] == '-')
+			index++;
+		index = masks.skip(&StructuralScanner::Masks::digit, index);
+		std::string_view number = inputText.substr(start, index - start);
+		int value;
+		if (!parseNumber(number, value))
+			throwNumberOutOfRange(number, lineOf(inputText, start));
+		token = Token{ Token::NUM, number, value };
+	}
+
+	// Se non è nulla di tutto ciò, c'è un errore; la linea
+	// viene contata solo in questo caso
+	else
+	{
 		std::stringstream errorMessage;
 		errorMessage << "Stray character " << inputText[index];
-		errorMessage << " in input at line " << line;
+		errorMessage << " in input at line " << lineOf(inputText, index);
 		throw LexicalError(errorMessage.str());
 	}
+
+	index = masks.skip(&StructuralScanner::Masks::space, index);
+}
+
+/**
+ * tokenizeStructural
+ *
+ * Riconosce i Token con scanStructural, a partire dalla
+ * posizione begin.
+ */
+void Tokenizer::tokenizeStructural(std::string_view inputText, std::size_t begin,
+	std::vector<Token>& inputTokens)
+{
+	MaskReader masks{ scanner, inputText };
+	std::size_t size = inputText.size();
+	Token token{ Token::ERR, "" };
+
+	std::size_t index = masks.skip(&StructuralScanner::Masks::space, begin);
+	while (index < size)
+	{
+		scanStructural(inputText, masks, index, token);
+		inputTokens.push_back(token);
+	}
 }
 
+/**
+ * tokenizeParallel
+ *
+ * Divide il testo in parti di dimensione simile, ognuna delle
+ * quali termina su uno spazio bianco (quindi nessun Token è
+ * diviso tra due parti), e le analizza in parallelo con
+ * tokenizeStructural: la prima sul thread corrente, le altre su
+ * un thread ciascuna. I Token delle parti vengono poi copiati
+ * in ordine in inputTokens.
+ *
+ * Se più parti contengono errori viene lanciato quello della
+ * prima, che è anche il primo errore del testo: lo stesso che
+ * segnalerebbe l'analisi su un solo thread.
+ */
+void Tokenizer::tokenizeParallel(std::string_view inputText, unsigned parts,
+	std::vector<Token>& inputTokens)
+{
+	// confini delle parti
+	std::vector<std::size_t> bounds{ 0 };
+	for (unsigned i = 1; i < parts; i++)
+	{
+		std::size_t bound = std::max(bounds.back(), inputText.size() / parts * i);
+		while (bound < inputText.size() && CharClass::of(inputText[bound]) != CharClass::SPACE &&
+			CharClass::of(inputText[bound]) != CharClass::NEWLINE)
+			bound++;
+		if (bound > bounds.back() && bound < inputText.size())
+			bounds.push_back(bound);
+	}
+	bounds.push_back(inputText.size());
+	std::size_t count = bounds.size() - 1;
+
+	std::vector<std::vector<Token>> partTokens(count);
+	std::vector<std::exception_ptr> errors(count);
+	auto tokenizePart = [&](std::size_t part)
+	{
+		try
+		{
+			tokenizeStructural(inputText.substr(0, bounds[part + 1]), bounds[part], partTokens[part]);
+		}
+		catch (...)
+		{
+			errors[part] = std::current_exception();
+		}
+	};
 
+	// se la creazione di un thread fallisce, quelli già avviati
+	// vanno attesi prima di uscire: usano le variabili locali
+	std::vector<std::thread> workers;
+	workers.reserve(count - 1);
+	try
+	{
+		for (std::size_t part = 1; part < count; part++)
+			workers.emplace_back(tokenizePart, part);
+	}
+	catch (...)
+	{
+		for (std::thread& worker : workers)
+			worker.join();
+		throw;
+	}
+	tokenizePart(0);
+	for (std::thread& worker : workers)
+		worker.join();
+
+	for (std::exception_ptr error : errors)
+		if (error)
+			std::rethrow_exception(error);
+
+	// la prima parte diventa il risultato, le altre vengono
+	// aggiunte in coda
+	std::size_t total = 0;
+	for (const std::vector<Token>& tokens : partTokens)
+		total += tokens.size();
+	inputTokens = std::move(partTokens[0]);
+	inputTokens.reserve(total);
+	for (std::size_t part = 1; part < count; part++)
+	{
+		std::vector<Token>& tokens = partTokens[part];
+		inputTokens.insert(inputTokens.end(), std::make_move_iterator(tokens.begin()),
+			std::make_move_iterator(tokens.end()));
+		// la memoria della parte viene liberata subito
+		std::vector<Token>().swap(tokens);
+	}
+}
@@ -2,31 +2,81 @@
 #define TOKENIZER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Token.h"
+#include "StructuralScanner.h"
 
 
 /**
  * Tokenizer si occupa di produrre un vettore di Token a
  * partire da un file di testo sottoforma di stringa unica.
+ *
+ * I Token puntano al testo ricevuto, che deve quindi restare
+ * in memoria finché i Token vengono usati.
+ *
+ * Il testo viene letto in due stadi: StructuralScanner
+ * classifica 64 byte alla volta in maschere di bit, poi i
+ * Token vengono riconosciuti scorrendo le maschere. Con il
+ * livello NONE il testo viene invece letto un byte alla volta
+ * da scanToken, come in TokenStream.
+ *
+ * Con lo scanner strutturale un testo grande viene diviso in
+ * parti, separate da spazi bianchi, analizzate in parallelo da
+ * più thread: i Token e gli errori sono gli stessi dell'analisi
+ * su un solo thread.
  */
 class Tokenizer
 {
 public:
-	// utilizzo costruttori e distruttore di default
-	std::vector<Token> operator()(std::string inputText);
+	// Esito di scanToken
+	enum ScanResult { TOKEN, END, MORE };
+
+	// Posizione di scanToken nel testo: indice nel testo
+	// corrente, posizione del testo corrente nel sorgente e
+	// numero di linea
+	struct ScanPosition
+	{
+		std::size_t index = 0;
+		std::size_t offset = 0;
+		int line = 1;
+	};
+
+	// Scanner strutturale migliore supportato dalla CPU
+	Tokenizer() = default;
+	// Scanner strutturale del livello richiesto (NONE per
+	// leggere un byte alla volta) e numero massimo di thread
+	// (0 per usare tutti i core)
+	Tokenizer(StructuralScanner::Level level, unsigned threads = 1) : scanner{ level }, threads{ threads } {}
+
+	std::vector<Token> operator()(std::string_view inputText);
+
+	StructuralScanner::Level getLevel() const { return scanner.getLevel(); }
+
+	// Riconosce un solo token, usato anche da TokenStream
+	static ScanResult scanToken(std::string_view inputText, bool lastChunk,
+		ScanPosition& position, Token& token);
+	// Riconosce il Token in posizione index con le maschere
+	// dello scanner strutturale, usato anche da SourceCursor
+	static void scanStructural(std::string_view inputText, MaskReader& masks,
+		std::size_t& index, Token& token);
 private:
-	void tokenizeInputText(std::string inputText,
+	void tokenizeInputText(std::string_view inputText,
+		std::vector<Token>& inputTokens);
+	void tokenizeStructural(std::string_view inputText, std::size_t begin,
+		std::vector<Token>& inputTokens);
+	void tokenizeParallel(std::string_view inputText, unsigned parts,
 		std::vector<Token>& inputTokens);
 
-	int isKeyword(std::string word);
+	// Dimensione minima di ogni parte nell'analisi parallela
+	static const std::size_t minPartSize = 1024 * 1024;
 
-	std::vector<std::string> keywords = {
-		"BLOCK", "IF", "WHILE", "INPUT", "SET", "PRINT",
-		"ADD", "SUB", "MUL", "DIV", "NUM", "VAR", "GT",
-		"LT", "EQ", "AND", "OR", "NOT", "TRUE", "FALSE"
-	};
+	StructuralScanner scanner;
+	unsigned threads = 1;
+
+	static bool parseNumber(std::string_view number, int& value);
+	static void throwNumberOutOfRange(std::string_view number, int line);
 };
 
 #endif
\ No newline at end of file
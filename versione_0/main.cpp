@@ -1,14 +1,39 @@
 #include <iostream>
-#include <fstream>
-#include <sstream>
+#include <string>
+#include <chrono>
+#include <initializer_list>
+#include <cstdlib>
+#include <random>
 
+#include "SourceFile.h"
 #include "Tokenizer.h"
+#include "TokenStream.h"
+#include "SourceCursor.h"
+#include "StructuralScanner.h"
+#include "AllocationCounter.h"
 #include "Exceptions.h"
+#include "CharClass.h"
 #include "Block.h"
 #include "NodeManager.h"
 #include "Parser.h"
+#include "ParallelParser.h"
+#include "IncrementalParser.h"
+#include "LazyLoader.h"
+#include "Recognizer.h"
+#include "ProgramCache.h"
+#include "CompactAst.h"
+#include "CompactAstAdapter.h"
+#include "SymbolTable.h"
+#include "SymbolResolver.h"
 #include "ExecutionVisitor.h"
 #include "PrintVisitor.h"
+#include "BytecodeCompiler.h"
+#include "StackVM.h"
+#include "RegisterCompiler.h"
+#include "ClosureCompiler.h"
+#include "JitCompiler.h"
+#include "StencilCompiler.h"
+#include "RegisterVM.h"
 
 /*
  * 
@@ -46,47 +71,357 @@
  * PASS_Sum							OK
  */
 
+// se vero, la durata di ogni fase viene stampata su stderr
+static bool timing = false;
+// se vero, la memoria occupata dall'albero sintattico viene
+// stampata su stderr
+static bool memoryStats = false;
+
+/**
+ * reportTime
+ *
+ * Stampa su stderr il tempo trascorso dall'inizio della fase,
+ * solo se è stata specificata l'opzione --time.
+ */
+static void reportTime(const char* phase, std::chrono::steady_clock::time_point start)
+{
+	if (!timing)
+		return;
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	std::cerr << "(TIME " << phase << ": " << elapsed.count() << " ms )" << std::endl;
+}
+
+/**
+ * printUsage
+ *
+ * Stampa su stderr le opzioni accettate, dopo un errore nei
+ * parametri da terminale.
+ */
+static void printUsage(const char* program)
+{
+	std::cerr << "Usage: " << program << " [--engine visitor|stack|register|closure|jit|stencil] [--ast tree|compact] [--time] [--memory] [--stream|--fused] [--scanner auto|avx2|sse2|scalar|none] [--threads N] [--parse-threads N] [--edits N] [--lazy] [--check] [--cache] [--cache-dir DIR] FILENAME" << std::endl;
+}
+
+/**
+ * finishStream
+ *
+ * Con --stream il parser si ferma alla fine del programma o
+ * al primo errore di sintassi: il resto del testo viene
+ * comunque analizzato, in modo da segnalare gli errori
+ * lessicali come nella tokenizzazione completa (vedi
+ * finishFused).
+ */
+static void finishStream(TokenStream& tokenStream)
+{
+	while (!tokenStream.atEnd())
+		tokenStream++;
+	if (memoryStats)
+		std::cerr << "(MEMORY tokenizer: " << tokenStream.getTokenCount() << " tokens, "
+			<< tokenStream.getBufferSize() << " bytes buffer )" << std::endl;
+}
+
+/**
+ * finishFused
+ *
+ * Con --fused il resto del testo viene analizzato sia dopo il
+ * parsing sia dopo un errore di sintassi: un errore lessicale
+ * nel resto del testo viene lanciato al posto dell'errore di
+ * sintassi, come con la tokenizzazione completa, che trova gli
+ * errori lessicali prima del parsing.
+ */
+static void finishFused(SourceCursor& cursor)
+{
+	while (!cursor.atEnd())
+		cursor++;
+	if (memoryStats)
+		std::cerr << "(MEMORY tokenizer: " << cursor.getTokenCount() << " tokens, "
+			<< 2 * sizeof(Token) << " bytes )" << std::endl;
+}
+
+/**
+ * applyEdits
+ *
+ * Con --edits N il programma viene modificato N volte, ogni
+ * volta cambiando una cifra scelta a caso (mai in 0, per non
+ * introdurre divisioni per zero), e analizzato di nuovo da
+ * IncrementalParser. Stampa su stderr il tempo medio di una
+ * modifica e i byte analizzati di nuovo. Serve solo a misurare
+ * il parsing incrementale: il programma modificato non viene
+ * eseguito.
+ */
+static void applyEdits(IncrementalParser& parse, std::string_view source, unsigned edits)
+{
+	std::string text{ source };
+	std::vector<std::size_t> digits;
+	for (std::size_t i = 0; i < text.size(); i++)
+		if (CharClass::of(text[i]) == CharClass::DIGIT)
+			digits.push_back(i);
+	if (digits.empty())
+		return;
+
+	std::mt19937 random{ 42 };
+	std::chrono::duration<double, std::micro> elapsed{};
+	std::size_t reparsedBytes = 0;
+	for (unsigned i = 0; i < edits; i++)
+	{
+		std::size_t position = digits[random() % digits.size()];
+		text[position] = text[position] == '9' ? '1' : (char)(text[position] + 1);
+		auto start = std::chrono::steady_clock::now();
+		parse.update(text, position, position + 1, position + 1);
+		elapsed += std::chrono::steady_clock::now() - start;
+		reparsedBytes += parse.getReparsedBytes();
+	}
+	std::cerr << "(TIME incremental: " << elapsed.count() / edits << " us per edit, "
+		<< reparsedBytes / edits << " bytes reparsed per edit )" << std::endl;
+}
+
 int main(int argc, char* argv[])
 {
 	/*
 	 * LETTURA DEL FILE A PARTIRE DA PARAMETRI DA TERMINALE
+	 *
+	 * Opzioni:
+	 * --engine ENGINE	motore di esecuzione (visitor, stack, register,
+	 *					closure, jit, stencil)
+	 * --ast AST		rappresentazione dell'albero sintattico
+	 *					generata dal parser (tree, compact). Con
+	 *					compact i nodi ordinari vengono generati da
+	 *					CompactAstAdapter un Block alla volta,
+	 *					quando vengono eseguiti o compilati
+	 * --time			stampa su stderr la durata di ogni fase
+	 * --memory			stampa su stderr la memoria occupata dai Token
+	 *					e da ogni tipo di nodo dell'albero sintattico
+	 * --stream			i Token vengono generati durante il parsing,
+	 *					leggendo il file a blocchi (TokenStream)
+	 * --scanner LEVEL	classificazione del testo nel Tokenizer (auto,
+	 *					avx2, sse2, scalar, none per leggere un byte
+	 *					alla volta); auto sceglie il migliore
+	 *					supportato dalla CPU
+	 * --threads N		numero massimo di thread del Tokenizer per i
+	 *					file grandi (0, il default, per usare tutti
+	 *					i core)
+	 * --parse-threads N	numero massimo di thread del parser, che
+	 *					analizza in parallelo gli Statement del
+	 *					Block principale (1, il default, per il
+	 *					parsing su un solo thread; 0 per usare
+	 *					tutti i core). Solo con --ast tree e senza
+	 *					--stream e --fused
+	 * --edits N		dopo il parsing il programma viene modificato
+	 *					N volte e analizzato di nuovo in modo
+	 *					incrementale (IncrementalParser), con il
+	 *					tempo medio di ogni modifica su stderr.
+	 *					Il programma non viene eseguito.
+	 *					Solo con --ast tree e senza --stream,
+	 *					--fused e --parse-threads
+	 * --lazy			i corpi di IfStmt e WhileStmt vengono analizzati
+	 *					solo quando vengono eseguiti (LazyLoader): gli
+	 *					errori di sintassi nei corpi mai eseguiti non
+	 *					vengono segnalati. Solo con --engine visitor,
+	 *					--ast tree e senza --stream, --fused,
+	 *					--parse-threads, --edits e --check
+	 * --check			controlla solo la sintassi di tutto il programma
+	 *					con Recognizer, senza generare l'albero
+	 *					sintattico e senza eseguirlo. Si può usare
+	 *					con --stream e --fused
+	 * --cache			l'albero sintattico viene salvato in un file
+	 *					binario accanto al sorgente (FILENAME.cache)
+	 *					e letto da lì nelle esecuzioni successive,
+	 *					finché il sorgente non cambia (ProgramCache)
+	 * --cache-dir DIR	come --cache, ma il file viene salvato nella
+	 *					directory DIR. Solo con --ast tree e senza
+	 *					--stream, --fused, --parse-threads, --edits,
+	 *					--lazy e --check; non con lo standard input
+	 *
+	 * Con FILENAME uguale a - il programma viene letto dallo
+	 * standard input.
 	 */
-	 // controllo numero parametri
-	if (argc < 2)
+	std::string engine = "visitor";
+	std::string ast = "tree";
+	bool streaming = false;
+	bool fused = false;
+	std::string scanner = "auto";
+	unsigned threads = 0;
+	unsigned parseThreads = 1;
+	unsigned edits = 0;
+	bool lazy = false;
+	bool checkOnly = false;
+	bool caching = false;
+	std::string cacheDirectory;
+	const char* fileName = nullptr;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "--engine" && i + 1 < argc)
+			engine = argv[++i];
+		else if (argument == "--ast" && i + 1 < argc)
+			ast = argv[++i];
+		else if (argument == "--time")
+			timing = true;
+		else if (argument == "--memory")
+			memoryStats = true;
+		else if (argument == "--stream")
+			streaming = true;
+		else if (argument == "--fused")
+			fused = true;
+		else if (argument == "--scanner" && i + 1 < argc)
+			scanner = argv[++i];
+		else if (argument == "--threads" && i + 1 < argc)
+			threads = (unsigned)std::strtoul(argv[++i], nullptr, 10);
+		else if (argument == "--parse-threads" && i + 1 < argc)
+			parseThreads = (unsigned)std::strtoul(argv[++i], nullptr, 10);
+		else if (argument == "--edits" && i + 1 < argc)
+			edits = (unsigned)std::strtoul(argv[++i], nullptr, 10);
+		else if (argument == "--lazy")
+			lazy = true;
+		else if (argument == "--check")
+			checkOnly = true;
+		else if (argument == "--cache")
+			caching = true;
+		else if (argument == "--cache-dir" && i + 1 < argc)
+		{
+			caching = true;
+			cacheDirectory = argv[++i];
+		}
+		else
+			fileName = argv[i];
+	}
+
+	// controllo parametri
+	if (fileName == nullptr)
 	{
 		std::cerr << "Error: FILENAME not specified" << std::endl;
-		std::cerr << "Usage: " << argv[0] << " FILENAME" << std::endl;
+		printUsage(argv[0]);
 		return EXIT_FAILURE;
 	}
-
-	// controllo apertura file
-	std::ifstream inputFile;
-	try
+	if (engine != "visitor" && engine != "stack" && engine != "register" && engine != "closure" && engine != "jit"
+		&& engine != "stencil")
+	{
+		std::cerr << "Error: unknown engine " << engine << std::endl;
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (streaming && fused)
 	{
-		inputFile.open(argv[1]);
+		std::cerr << "Error: --stream and --fused cannot be used together" << std::endl;
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
 	}
-	catch (std::exception& e)
+	if (parseThreads != 1 && (ast != "tree" || streaming || fused))
 	{
-		std::cerr << "Error: could not open file " << argv[1] << std::endl;
-		std::cerr << e.what() << std::endl;
+		std::cerr << "Error: --parse-threads requires --ast tree, without --stream or --fused" << std::endl;
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (edits != 0 && (ast != "tree" || streaming || fused || parseThreads != 1))
+	{
+		std::cerr << "Error: --edits requires --ast tree, without --stream, --fused or --parse-threads" << std::endl;
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (lazy && (engine != "visitor" || ast != "tree" || streaming || fused || parseThreads != 1 || edits != 0 || checkOnly))
+	{
+		std::cerr << "Error: --lazy requires --engine visitor and --ast tree, without --stream, --fused, --parse-threads, --edits or --check" << std::endl;
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (caching && (ast != "tree" || streaming || fused || parseThreads != 1 || edits != 0 || lazy || checkOnly
+		|| std::string(fileName) == "-"))
+	{
+		std::cerr << "Error: --cache requires --ast tree and a file, without --stream, --fused, --parse-threads, --edits, --lazy or --check" << std::endl;
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (ast != "tree" && ast != "compact")
+	{
+		std::cerr << "Error: unknown AST representation " << ast << std::endl;
+		printUsage(argv[0]);
 		return EXIT_FAILURE;
 	}
 
-	// lettura dell'intero file in una stringa
-	std::stringstream temp{};
-	temp << inputFile.rdbuf();
-	inputFile.close();
+	StructuralScanner::Level scannerLevel = StructuralScanner::detectLevel();
+	if (scanner != "auto")
+	{
+		bool found = false;
+		for (StructuralScanner::Level level : { StructuralScanner::NONE, StructuralScanner::SCALAR,
+			StructuralScanner::SSE2, StructuralScanner::AVX2 })
+			if (scanner == StructuralScanner::levelToStr(level))
+			{
+				scannerLevel = level;
+				found = true;
+			}
+		if (!found)
+		{
+			std::cerr << "Error: unknown scanner " << scanner << std::endl;
+			printUsage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		if (!StructuralScanner::isSupported(scannerLevel))
+		{
+			std::cerr << "Error: scanner " << scanner << " not supported by this CPU" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	// apertura del file: il testo viene mappato in memoria (o
+	// letto, per pipe e standard input) e deve restare in memoria
+	// finché si usano i Token. Con --stream il file viene invece
+	// letto a blocchi durante il parsing.
+	SourceFile sourceFile{};
+	TokenStream tokenStream{};
+	bool opened = streaming ? tokenStream.open(fileName) : sourceFile.open(fileName);
+	if (!opened)
+	{
+		std::cerr << "Error: could not open file " << fileName << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::string_view source = sourceFile.getText();
 
 	//std::cout << "File read: " << std::endl << temp.str() << std::endl;
 
+	/*
+	 * CACHE
+	 *
+	 * Con --cache un file di cache aggiornato sostituisce la
+	 * tokenizzazione e il parsing
+	 */
+	NodeManager nm{};
+	ProgramCache cache{ &nm };
+	std::string cachePath;
+	Block* cached = nullptr;
+	if (caching)
+	{
+		auto cacheStart = std::chrono::steady_clock::now();
+		cachePath = ProgramCache::pathFor(fileName, cacheDirectory);
+		cached = cache.load(cachePath, source);
+		reportTime(cached != nullptr ? "cache" : "cache miss", cacheStart);
+	}
+
 	/*
 	 * TOKENIZZAZIONE
+	 *
+	 * Con --stream e --fused non c'è una fase separata: i Token
+	 * vengono generati dal parser, e gli errori lessicali vengono
+	 * segnalati durante il parsing.
 	 */
-	Tokenizer tokenize;
+	Tokenizer tokenize{ scannerLevel, threads };
 	std::vector<Token> inputTokens;
+	auto phaseStart = std::chrono::steady_clock::now();
 	try
 	{
-		inputTokens = tokenize(temp.str());
+		if (!streaming && !fused && cached == nullptr)
+		{
+			std::size_t allocationsBefore = AllocationCounter::count();
+			inputTokens = tokenize(source);
+			reportTime("tokenizer", phaseStart);
+			if (memoryStats)
+			{
+				std::cerr << "(MEMORY tokenizer: " << inputTokens.size() << " tokens, "
+					<< inputTokens.size() * sizeof(Token) << " bytes";
+				if (AllocationCounter::enabled())
+					std::cerr << ", " << AllocationCounter::count() - allocationsBefore << " allocations";
+				std::cerr << " )" << std::endl;
+			}
+		}
 		/*
 		std::cout << "Tokens: ";
 		for (Token token : inputTokens)
@@ -113,15 +448,182 @@ int main(int argc, char* argv[])
 	/*
 	 * PARSING
 	 */
-	Block* program;
-	NodeManager nm{};
-	Parser parse{ &nm };
+	Block* program = nullptr;
+	CompactAst compact{};
+	CompactAst::NodeRef compactRoot;
+	IncrementalParser incremental{ &nm };
+	// con --lazy i Block pigri risolvono le loro variabili
+	// quando vengono analizzati
+	SymbolTable symbols{};
+	LazyLoader lazyLoader{ &nm, &symbols };
+	CompactAstAdapter adapt{ &compact, &nm, &symbols };
 	try
 	{
 		//std::cout << std::endl << "Begin parsing..." << std::endl;
-		program = parse(inputTokens);
-		if (program == nullptr)
-			return EXIT_FAILURE;
+		phaseStart = std::chrono::steady_clock::now();
+		if (checkOnly)
+		{
+			// riconoscimento della sintassi senza nodi, con gli
+			// stessi errori del parser
+			bool found;
+			if (streaming)
+			{
+				StreamRecognizer recognize{};
+				try
+				{
+					found = recognize(tokenStream);
+				}
+				catch (const SyntaxError&)
+				{
+					finishStream(tokenStream);
+					throw;
+				}
+				finishStream(tokenStream);
+			}
+			else if (fused)
+			{
+				SourceCursor cursor{ source, scannerLevel };
+				FusedRecognizer recognize{};
+				try
+				{
+					found = recognize(cursor);
+				}
+				catch (const SyntaxError&)
+				{
+					finishFused(cursor);
+					throw;
+				}
+				finishFused(cursor);
+			}
+			else
+			{
+				VectorCursor cursor{ inputTokens };
+				Recognizer recognize{};
+				found = recognize(cursor);
+			}
+			reportTime("check", phaseStart);
+			return found ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		if (ast == "compact")
+		{
+			// parsing nell'albero compatto; il programma è
+			// il Block pigro generato da CompactAstAdapter
+			if (streaming)
+			{
+				CompactStreamParser parse{ &compact };
+				try
+				{
+					compactRoot = parse(tokenStream);
+				}
+				catch (const SyntaxError&)
+				{
+					finishStream(tokenStream);
+					throw;
+				}
+				finishStream(tokenStream);
+			}
+			else if (fused)
+			{
+				SourceCursor cursor{ source, scannerLevel };
+				CompactFusedParser parse{ &compact };
+				try
+				{
+					compactRoot = parse(cursor);
+				}
+				catch (const SyntaxError&)
+				{
+					finishFused(cursor);
+					throw;
+				}
+				finishFused(cursor);
+			}
+			else
+			{
+				VectorCursor cursor{ inputTokens };
+				CompactParser parse{ &compact };
+				compactRoot = parse(cursor);
+			}
+			reportTime("parser", phaseStart);
+			if (compactRoot.kind == CompactAst::NO_NODE)
+				return EXIT_FAILURE;
+			if (memoryStats)
+				compact.printStatistics(std::cerr);
+			program = adapt(compactRoot);
+		}
+		else
+		{
+			if (cached != nullptr)
+				program = cached;
+			else if (streaming)
+			{
+				StreamParser parse{ &nm };
+				try
+				{
+					program = parse(tokenStream);
+				}
+				catch (const SyntaxError&)
+				{
+					finishStream(tokenStream);
+					throw;
+				}
+				finishStream(tokenStream);
+			}
+			else if (fused)
+			{
+				SourceCursor cursor{ source, scannerLevel };
+				FusedParser parse{ &nm };
+				try
+				{
+					program = parse(cursor);
+				}
+				catch (const SyntaxError&)
+				{
+					finishFused(cursor);
+					throw;
+				}
+				finishFused(cursor);
+			}
+			else if (edits != 0)
+				program = incremental.parse(source);
+			else if (parseThreads != 1)
+			{
+				ParallelParser parse{ &nm, parseThreads };
+				program = parse(inputTokens);
+			}
+			else
+			{
+				VectorCursor cursor{ inputTokens };
+				Parser parse{ &nm };
+				if (lazy)
+					parse.setLazyBodies(&lazyLoader);
+				program = parse(cursor);
+			}
+			if (cached == nullptr)
+				reportTime("parser", phaseStart);
+			if (program == nullptr)
+				return EXIT_FAILURE;
+			if (caching && cached == nullptr)
+			{
+				// un errore di scrittura non impedisce l'esecuzione
+				phaseStart = std::chrono::steady_clock::now();
+				cache.save(cachePath, program, source);
+				reportTime("cache write", phaseStart);
+			}
+			if (memoryStats)
+				nm.printStatistics(std::cerr);
+			if (edits != 0)
+			{
+				applyEdits(incremental, source, edits);
+				return EXIT_SUCCESS;
+			}
+		}
+	}
+	catch (LexicalError e)
+	{
+		// solo con --stream e --fused
+		std::cerr << "(ERROR in tokenizer: ";
+		std::cerr << e.what() << " )" << std::endl;
+		return EXIT_FAILURE;
 	}
 	catch (SyntaxError e)
 	{
@@ -136,6 +638,20 @@ int main(int argc, char* argv[])
 		return EXIT_FAILURE;
 	}
 
+	/*
+	 * RISOLUZIONE DELLE VARIABILI
+	 *
+	 * Ogni Variable riceve il suo slot nella SymbolTable; le
+	 * Variable generate da CompactAstAdapter hanno già il loro
+	 */
+	if (ast == "tree")
+	{
+		SymbolResolver resolve{ &symbols };
+		phaseStart = std::chrono::steady_clock::now();
+		resolve(program);
+		reportTime("resolver", phaseStart);
+	}
+
 	/*
 	std::cout << "Parsing OK" << std::endl;
 
@@ -166,11 +682,81 @@ int main(int argc, char* argv[])
 	 * ESECUZIONE
 	 */
 	//std::cout << "Begin execution..." << std::endl;
-	ExecutionVisitor ev{};
+	ExecutionVisitor ev{ &symbols };
 
 	try
 	{
-		program->accept(&ev);
+		phaseStart = std::chrono::steady_clock::now();
+		if (engine == "stack")
+		{
+			// compilazione in bytecode ed esecuzione su StackVM
+			BytecodeCompiler compile{ &symbols };
+			BytecodeProgram bytecode = compile(program);
+			reportTime("compiler", phaseStart);
+
+			phaseStart = std::chrono::steady_clock::now();
+			StackVM run{};
+			run(bytecode);
+		}
+		else if (engine == "register")
+		{
+			// compilazione ed esecuzione su RegisterVM
+			RegisterCompiler compile{ &symbols };
+			RegisterProgram registerProgram = compile(program);
+			reportTime("compiler", phaseStart);
+
+			phaseStart = std::chrono::steady_clock::now();
+			RegisterVM run{};
+			run(registerProgram);
+		}
+		else if (engine == "closure")
+		{
+			// compilazione in closure ed esecuzione diretta
+			ClosureProgram closures{};
+			ClosureCompiler compile{ &symbols, &closures };
+			compile(program);
+			reportTime("compiler", phaseStart);
+
+			phaseStart = std::chrono::steady_clock::now();
+			closures.run();
+		}
+		else if (engine == "jit" || engine == "stencil")
+		{
+			// compilazione in codice macchina x86-64 (con
+			// JitCompiler o copiando gli stencil), oppure
+			// esecuzione con ExecutionVisitor se il processore non
+			// è supportato
+			JitProgram jitProgram{};
+			bool compiled;
+			if (engine == "jit")
+				compiled = JitCompiler{ &symbols, &jitProgram }(program);
+			else
+				compiled = StencilCompiler{ &symbols, &jitProgram }(program);
+			reportTime("compiler", phaseStart);
+			if (timing && !compiled)
+				std::cerr << "(TIME jit: unavailable, running visitor )" << std::endl;
+
+			phaseStart = std::chrono::steady_clock::now();
+			if (compiled)
+				jitProgram.run();
+			else
+				program->accept(&ev);
+		}
+		else if (ast == "compact")
+		{
+			// ExecutionVisitor visita l'albero compatto
+			// attraverso CompactAstAdapter
+			adapt.setVisitor(&ev);
+			compact.accept(compactRoot, &adapt);
+		}
+		else
+			program->accept(&ev);
+		reportTime("execution", phaseStart);
+		if (lazy && memoryStats)
+			std::cerr << "(MEMORY lazy: " << lazyLoader.getLoadedBlocks() << " blocks parsed, "
+				<< lazyLoader.getLoadedTokens() << " tokens )" << std::endl;
+		if (ast == "compact" && memoryStats)
+			std::cerr << "(MEMORY adapter: " << adapt.getLoadedBlocks() << " blocks converted )" << std::endl;
 		//std::cout << "Execution terminated!" << std::endl;
 		return EXIT_SUCCESS;
 	}
@@ -186,6 +772,14 @@ int main(int argc, char* argv[])
 		std::cerr << e.what() << " )" << std::endl;
 		return EXIT_FAILURE;
 	}
+	catch (SyntaxError e)
+	{
+		// solo con --lazy, da un Block analizzato durante
+		// l'esecuzione
+		std::cerr << "(ERROR in parser: ";
+		std::cerr << e.what() << " )" << std::endl;
+		return EXIT_FAILURE;
+	}
 	catch (std::exception e)
 	{
 		std::cerr << "(ERROR: ";